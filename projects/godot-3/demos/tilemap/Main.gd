@@ -30,25 +30,35 @@ func _physics_process(delta):
 func create_tilemap_collision(tilemap: TileMap, colliding_tiles: Array) -> void:
 	var width = int(tilemap.cell_size.x)
 	var height = int(tilemap.cell_size.y)
-	var extents = SGFixed.vector2(SGFixed.from_int(width / 2), SGFixed.from_int(height / 2))
-	var shape_transform = SGFixed.transform2d(0, extents)
+	var used_rect = tilemap.get_used_rect()
 
+	# A single grid shape covers every tile, so the physics engine only has one
+	# object to deal with, no matter how big the tilemap is.
+	var shape = SGPhysics2DServer.shape_create(SGPhysics2DServer.SHAPE_GRID)
+	SGPhysics2DServer.grid_set_cell_size(shape, SGFixed.vector2(SGFixed.from_int(width), SGFixed.from_int(height)))
+	SGPhysics2DServer.grid_set_size(shape, int(used_rect.size.x), int(used_rect.size.y))
+	resources.push_back(shape)
+
+	var cells := PoolByteArray()
+	for i in range(int(used_rect.size.x) * int(used_rect.size.y)):
+		cells.append(SGPhysics2DServer.GRID_CELL_EMPTY)
 	for tile_id in colliding_tiles:
 		for tile_pos in tilemap.get_used_cells_by_id(tile_id):
-			var shape = SGPhysics2DServer.shape_create(SGPhysics2DServer.SHAPE_RECTANGLE)
-			SGPhysics2DServer.rectangle_set_extents(shape, extents)
-			SGPhysics2DServer.shape_set_transform(shape, shape_transform)
-			resources.push_back(shape)
-
-			var object = SGPhysics2DServer.collision_object_create(SGPhysics2DServer.OBJECT_BODY, SGPhysics2DServer.BODY_STATIC)
-			SGPhysics2DServer.collision_object_add_shape(object, shape)
-			SGPhysics2DServer.collision_object_set_transform(object, SGFixed.transform2d(0,
-				SGFixed.vector2(SGFixed.from_int(int(tile_pos.x) * width), SGFixed.from_int(int(tile_pos.y) * height))))
-			# In order for collisions to be deterministic, the physics engine needs
-			# to be able to sort the objects. Normally, it sorts by scene tree order,
-			# but when there is no node, we need to set a unique data string to use
-			# for sorting. This can also be used to identify the object in some way.
-			SGPhysics2DServer.collision_object_set_data(object, "tilemap-%sx%s" % [int(tile_pos.x), int(tile_pos.y)])
-			resources.push_back(object)
-
-			SGPhysics2DServer.world_add_collision_object(SGPhysics2DServer.get_default_world(), object)
+			var x = int(tile_pos.x - used_rect.position.x)
+			var y = int(tile_pos.y - used_rect.position.y)
+			cells[y * int(used_rect.size.x) + x] = SGPhysics2DServer.GRID_CELL_SOLID
+	SGPhysics2DServer.grid_set_cells(shape, cells)
+
+	var object = SGPhysics2DServer.collision_object_create(SGPhysics2DServer.OBJECT_BODY, SGPhysics2DServer.BODY_STATIC)
+	SGPhysics2DServer.collision_object_add_shape(object, shape)
+
+	# In order for collisions to be deterministic, the physics engine needs
+	# to be able to sort the objects. Normally, it sorts by scene tree order,
+	# but when there is no node, we need to set a unique data string to use
+	# for sorting. This can also be used to identify the object in some way.
+	SGPhysics2DServer.collision_object_set_data(object, "tilemap")
+	resources.push_back(object)
+
+	SGPhysics2DServer.world_add_collision_object(SGPhysics2DServer.get_default_world(), object)
+	SGPhysics2DServer.collision_object_set_transform(object, SGFixed.transform2d(0,
+		SGFixed.vector2(SGFixed.from_int(int(used_rect.position.x) * width), SGFixed.from_int(int(used_rect.position.y) * height))))
@@ -0,0 +1,7 @@
+extends Node2D
+
+onready var detector_area1 = $DetectorArea1
+onready var detector_area2 = $DetectorArea2
+
+onready var colliding_area = $CollidingArea
+onready var colliding_area_shape = $CollidingArea/Shape
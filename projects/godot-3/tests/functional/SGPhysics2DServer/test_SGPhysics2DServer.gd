@@ -0,0 +1,170 @@
+extends "res://addons/gut/test.gd"
+
+const DIRECTIONS = [
+	Vector2(1, 0), Vector2(1, 1), Vector2(0, 1), Vector2(-1, 1),
+	Vector2(-1, 0), Vector2(-1, -1), Vector2(0, -1), Vector2(1, -1),
+]
+
+# Objects are freed before their shapes, and shapes before their worlds.
+var created_objects := []
+var created_shapes := []
+var created_worlds := []
+
+func after_each() -> void:
+	for rids in [created_objects, created_shapes, created_worlds]:
+		for rid in rids:
+			SGPhysics2DServer.free_rid(rid)
+		rids.clear()
+
+func _create_world_rid(broadphase_type: int) -> RID:
+	var world = SGPhysics2DServer.world_create(broadphase_type)
+	created_worlds.push_back(world)
+	return world
+
+# Each object needs its own shape, since a shape can only belong to one
+# object at a time.
+func _add_object(world: RID, name: String, body_type: int, shape: RID, x: int, y: int) -> RID:
+	var object = SGPhysics2DServer.collision_object_create(SGPhysics2DServer.OBJECT_BODY, body_type)
+	SGPhysics2DServer.collision_object_add_shape(object, shape)
+	# Without a node, the data is what the objects are sorted by.
+	SGPhysics2DServer.collision_object_set_data(object, name)
+	SGPhysics2DServer.collision_object_set_transform(object, SGFixed.transform2d(0, SGFixed.vector2(SGFixed.from_int(x), SGFixed.from_int(y))))
+	SGPhysics2DServer.world_add_collision_object(world, object)
+	created_objects.push_back(object)
+	return object
+
+func _create_rectangle(extents: int) -> RID:
+	var shape = SGPhysics2DServer.shape_create(SGPhysics2DServer.SHAPE_RECTANGLE)
+	SGPhysics2DServer.rectangle_set_extents(shape, SGFixed.vector2(SGFixed.from_int(extents), SGFixed.from_int(extents)))
+	created_shapes.push_back(shape)
+	return shape
+
+func _create_circle(radius: int) -> RID:
+	var shape = SGPhysics2DServer.shape_create(SGPhysics2DServer.SHAPE_CIRCLE)
+	SGPhysics2DServer.circle_set_radius(shape, SGFixed.from_int(radius))
+	created_shapes.push_back(shape)
+	return shape
+
+# A character surrounded by a ring of other characters, with a static floor
+# below them, so that everything but the floor lives in the world's own
+# broadphase.
+func _create_world(broadphase_type: int) -> Dictionary:
+	var world = _create_world_rid(broadphase_type)
+
+	var objects := []
+	for i in range(DIRECTIONS.size()):
+		var shape = _create_rectangle(8) if i % 2 == 0 else _create_circle(8)
+		objects.push_back(_add_object(world, "obstacle%s" % i, SGPhysics2DServer.BODY_KINEMATIC, shape, int(DIRECTIONS[i].x) * 30, int(DIRECTIONS[i].y) * 30))
+
+	var floor_shape = SGPhysics2DServer.shape_create(SGPhysics2DServer.SHAPE_RECTANGLE)
+	SGPhysics2DServer.rectangle_set_extents(floor_shape, SGFixed.vector2(SGFixed.from_int(100), SGFixed.from_int(5)))
+	created_shapes.push_back(floor_shape)
+	objects.push_back(_add_object(world, "floor", SGPhysics2DServer.BODY_STATIC, floor_shape, 0, 60))
+
+	var mover = _add_object(world, "mover", SGPhysics2DServer.BODY_KINEMATIC, _create_rectangle(5), 0, 0)
+
+	return {
+		world = world,
+		objects = objects,
+		mover = mover,
+	}
+
+# Moves the character from the middle of the ring in every direction, and
+# casts rays the same way, returning what was hit and where.
+func _collect_results(scene: Dictionary) -> Array:
+	var results := []
+
+	for direction in DIRECTIONS:
+		SGPhysics2DServer.collision_object_set_transform(scene.mover, SGFixed.transform2d(0, SGFixed.vector2(0, 0)))
+		var motion = SGFixed.vector2(SGFixed.from_int(int(direction.x) * 40), SGFixed.from_int(int(direction.y) * 40))
+		var collision = SGPhysics2DServer.body_move_and_collide(scene.mover, motion)
+		if collision:
+			var origin = SGPhysics2DServer.collision_object_get_transform(scene.mover).origin
+			results.push_back([
+				scene.objects.find(collision.get_collider_rid()),
+				collision.normal.x, collision.normal.y,
+				collision.remainder.x, collision.remainder.y,
+				origin.x, origin.y,
+			])
+		else:
+			results.push_back(null)
+
+	# Keep the character out of the way of the rays.
+	SGPhysics2DServer.collision_object_set_transform(scene.mover, SGFixed.transform2d(0, SGFixed.vector2(0, SGFixed.from_int(-200))))
+	var starts := [SGFixed.vector2(0, 0), SGFixed.vector2(SGFixed.from_int(-50), 0)]
+	for start in starts:
+		for direction in DIRECTIONS:
+			var cast_to = SGFixed.vector2(SGFixed.from_int(int(direction.x) * 100), SGFixed.from_int(int(direction.y) * 100))
+			var ray = SGPhysics2DServer.world_cast_ray(scene.world, start, cast_to, 0xFFFFFFFF, [], false, true)
+			if ray:
+				results.push_back([
+					scene.objects.find(ray.get_collider_rid()),
+					ray.point.x, ray.point.y,
+					ray.normal.x, ray.normal.y,
+				])
+			else:
+				results.push_back(null)
+
+	return results
+
+func test_aabb_tree_matches_spatial_hash() -> void:
+	var spatial_hash = _create_world(SGPhysics2DServer.BROADPHASE_SPATIAL_HASH)
+	var aabb_tree = _create_world(SGPhysics2DServer.BROADPHASE_AABB_TREE)
+	assert_eq(SGPhysics2DServer.world_get_broadphase_type(spatial_hash.world), SGPhysics2DServer.BROADPHASE_SPATIAL_HASH)
+	assert_eq(SGPhysics2DServer.world_get_broadphase_type(aabb_tree.world), SGPhysics2DServer.BROADPHASE_AABB_TREE)
+
+	var expected = _collect_results(spatial_hash)
+	var results = _collect_results(aabb_tree)
+	assert_eq(results.size(), expected.size())
+	for i in range(expected.size()):
+		assert_eq(results[i], expected[i], "Result %s" % i)
+
+	# Every move runs into the ring.
+	for i in range(DIRECTIONS.size()):
+		assert_not_null(expected[i])
+		assert_eq(expected[i][0], i)
+
+	# Moving right stops against the left side of the first obstacle.
+	assert_eq(expected[0][1], -65536)
+	assert_eq(expected[0][2], 0)
+	assert_eq(expected[0][5], 1114080)
+	assert_eq(expected[0][6], 0)
+
+func test_cast_ray_long_diagonal() -> void:
+	for broadphase_type in [SGPhysics2DServer.BROADPHASE_SPATIAL_HASH, SGPhysics2DServer.BROADPHASE_AABB_TREE]:
+		var world = _create_world_rid(broadphase_type)
+		var near = _add_object(world, "near", SGPhysics2DServer.BODY_KINEMATIC, _create_rectangle(10), -150, -140)
+		_add_object(world, "far", SGPhysics2DServer.BODY_KINEMATIC, _create_rectangle(10), -50, -50)
+		_add_object(world, "beside", SGPhysics2DServer.BODY_KINEMATIC, _create_rectangle(10), -600, -400)
+
+		# Crosses several cells at negative coordinates, and has to stop at
+		# the nearest body rather than the one further along.
+		var start = SGFixed.vector2(SGFixed.from_int(-1000), SGFixed.from_int(-1000))
+		var cast_to = SGFixed.vector2(SGFixed.from_int(900), SGFixed.from_int(900))
+		var ray = SGPhysics2DServer.world_cast_ray(world, start, cast_to, 0xFFFFFFFF)
+		assert_not_null(ray)
+		assert_eq(ray.get_collider_rid(), near)
+		assert_eq(ray.point.x, -9830500)
+		assert_eq(ray.point.y, -9830500)
+		assert_eq(ray.normal.x, 0)
+		assert_eq(ray.normal.y, -65536)
+
+func test_cast_ray_tie_break() -> void:
+	for broadphase_type in [SGPhysics2DServer.BROADPHASE_SPATIAL_HASH, SGPhysics2DServer.BROADPHASE_AABB_TREE]:
+		for names in [["tie_a", "tie_b"], ["tie_b", "tie_a"]]:
+			var world = _create_world_rid(broadphase_type)
+			var objects := {}
+			for object_name in names:
+				objects[object_name] = _add_object(world, object_name, SGPhysics2DServer.BODY_KINEMATIC, _create_rectangle(10), -200, 50)
+
+			# Both bodies are hit at exactly the same distance, so the one
+			# that sorts first wins, whichever was added first.
+			var start = SGFixed.vector2(SGFixed.from_int(-400), SGFixed.from_int(50))
+			var cast_to = SGFixed.vector2(SGFixed.from_int(400), 0)
+			var ray = SGPhysics2DServer.world_cast_ray(world, start, cast_to, 0xFFFFFFFF)
+			assert_not_null(ray)
+			assert_eq(ray.get_collider_rid(), objects["tie_a"])
+			assert_eq(ray.point.x, -13762800)
+			assert_eq(ray.point.y, 3276800)
+			assert_eq(ray.normal.x, -65536)
+			assert_eq(ray.normal.y, 0)
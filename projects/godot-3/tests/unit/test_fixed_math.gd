@@ -23,6 +23,10 @@ func test_multiplication():
 
 	assert_eq(c, 409600)
 
+	# Products that don't fit in 64-bits before shifting back down.
+	assert_eq(SGFixed.mul(SGFixed.from_int(1 << 20), SGFixed.from_int(1 << 20)), SGFixed.from_int(1 << 40))
+	assert_eq(SGFixed.mul(SGFixed.from_int(-(1 << 20)), SGFixed.from_int(1 << 20)), SGFixed.from_int(-(1 << 40)))
+
 func test_division():
 	var a: int = SGFixed.from_int(15)
 	var b: int = SGFixed.from_int(2)
@@ -30,6 +34,10 @@ func test_division():
 
 	assert_eq(c, 491520)
 
+	# Dividends that don't fit in 64-bits after shifting up.
+	assert_eq(SGFixed.div(SGFixed.from_int(1 << 40), SGFixed.from_int(2)), SGFixed.from_int(1 << 39))
+	assert_eq(SGFixed.div(SGFixed.from_int(-(1 << 40)), SGFixed.from_int(2)), SGFixed.from_int(-(1 << 39)))
+
 func test_exp():
 	var exp_0 = SGFixed.exp(0)
 	assert_eq(exp_0, SGFixed.ONE)
@@ -79,6 +87,36 @@ func test_power():
 	assert_eq(g, 262144) #neg int exponent (even), negative int base - -2^2 = 4
 	assert_eq(h, -524288) #neg int exponent (odd), negative int base - -2^3 = -8
 
+func test_sqrt():
+	assert_eq(SGFixed.sqrt(0), 0)
+	assert_eq(SGFixed.sqrt(SGFixed.ONE), SGFixed.ONE)
+	assert_eq(SGFixed.sqrt(SGFixed.from_int(4)), SGFixed.TWO)
+	assert_eq(SGFixed.sqrt(SGFixed.TWO), 92681)
+	assert_eq(SGFixed.sqrt(1), 256)
+	assert_eq(SGFixed.sqrt(-SGFixed.from_int(4)), -SGFixed.TWO)
+
+	# Compare against the simple (but slow) bit-by-bit method, on values of
+	# all sizes.
+	var state := 1
+	for i in range(2000):
+		state = state * 6364136223846793005 + 1442695040888963407
+		var value: int = ((state >> 16) & ((1 << 46) - 1)) >> (i % 46)
+		assert_eq(SGFixed.sqrt(value), _reference_sqrt(value << 16), "sqrt of %s" % value)
+
+func _reference_sqrt(num: int) -> int:
+	var res := 0
+	var bit := 1 << 62
+	while bit > num:
+		bit >>= 2
+	while bit != 0:
+		if num >= res + bit:
+			num -= res + bit
+			res = (res >> 1) + bit
+		else:
+			res >>= 1
+		bit >>= 2
+	return res
+
 func test_move_toward():
 	var a: int = SGFixed.from_int(1)
 	var b: int = SGFixed.from_int(2)
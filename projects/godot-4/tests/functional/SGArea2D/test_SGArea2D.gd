@@ -28,6 +28,28 @@ func test_get_overlapping_bodies() -> void:
 		remove_child(scene)
 		scene.queue_free()
 
+func test_get_overlapping_bodies_after_changing_layers() -> void:
+	var GetOverlappingBodies = load("res://tests/functional/SGArea2D/GetOverlappingBodies.tscn")
+	var scene = GetOverlappingBodies.instantiate()
+	add_child(scene)
+	var static_body7 = scene.get_node("StaticBody7")
+
+	# StaticBody7 is only on the second layer.
+	scene.area.collision_layer = 3
+	scene.area.collision_mask = 3
+	var result = scene.do_get_overlapping_bodies()
+	assert_eq(result.size(), 3)
+	assert_true(static_body7 in result)
+
+	scene.area.collision_layer = 1
+	scene.area.collision_mask = 1
+	result = scene.do_get_overlapping_bodies()
+	assert_eq(result.size(), 2)
+	assert_false(static_body7 in result)
+
+	remove_child(scene)
+	scene.queue_free()
+
 func test_get_overlapping_areas() -> void:
 	var GetOverlappingAreas = load("res://tests/functional/SGArea2D/GetOverlappingAreas.tscn")
 
@@ -42,6 +64,49 @@ func test_get_overlapping_areas() -> void:
 	remove_child(scene)
 	scene.queue_free()
 
+func _get_overlap_events_for(area) -> Array:
+	var events := []
+	for event in SGPhysics2DServer.world_pop_overlap_events(SGPhysics2DServer.get_default_world()):
+		if event.area == area:
+			events.append(event)
+	return events
+
+func test_overlap_events() -> void:
+	var GetOverlappingAreas = load("res://tests/functional/SGArea2D/GetOverlappingAreas.tscn")
+
+	var scene = GetOverlappingAreas.instantiate()
+	add_child(scene)
+
+	# Clear out any events from other tests.
+	SGPhysics2DServer.world_pop_overlap_events(SGPhysics2DServer.get_default_world())
+
+	var result = scene.do_get_overlapping_areas()
+	assert_eq(result.size(), 1)
+
+	var events = _get_overlap_events_for(scene.area1)
+	assert_eq(events.size(), 1)
+	assert_eq(events[0].type, SGAreaOverlapEvent2D.OVERLAP_BEGIN)
+	assert_eq(events[0].collider, scene.area2)
+
+	# Nothing has changed, so there shouldn't be any new events.
+	events = _get_overlap_events_for(scene.area1)
+	assert_eq(events.size(), 0)
+
+	# Move the overlapping area away.
+	scene.area2.fixed_position_x = 65536 * 1000
+	scene.area2.sync_to_physics_engine()
+
+	events = _get_overlap_events_for(scene.area1)
+	assert_eq(events.size(), 1)
+	assert_eq(events[0].type, SGAreaOverlapEvent2D.OVERLAP_END)
+	assert_eq(events[0].collider, scene.area2)
+
+	result = scene.do_get_overlapping_areas()
+	assert_eq(result.size(), 0)
+
+	remove_child(scene)
+	scene.queue_free()
+
 func test_get_overlapping_area_shape_collisions() -> void:
 	var GetOverlappingShapeCollisions = load("res://tests/functional/SGArea2D/GetOverlappingShapeCollisions.tscn")
 
@@ -126,3 +191,62 @@ func test_get_overlapping_body_polygon_collisions() -> void:
 	remove_child(scene)
 	scene.queue_free()
 
+
+func test_get_overlapping_area_concave_polygon_collisions() -> void:
+	var GetOverlappingConcavePolygon = load("res://tests/functional/SGArea2D/GetOverlappingConcavePolygon.tscn")
+
+	var scene = GetOverlappingConcavePolygon.instantiate()
+	add_child(scene)
+
+	var result: Array
+
+	# Inside the notch of the polygon, which its convex hull would cover.
+	result = scene.detector_area1.get_overlapping_area_collisions()
+	assert_eq(result.size(), 0)
+
+	result = scene.detector_area2.get_overlapping_area_collisions()
+	assert_eq(result.size(), 1)
+	assert_eq(result[0].collider, scene.colliding_area)
+	assert_eq(result[0].shape, scene.colliding_area_shape)
+
+	remove_child(scene)
+	scene.queue_free()
+
+func test_get_overlapping_areas_with_tuned_cell_size() -> void:
+	var GetOverlappingAreas = load("res://tests/functional/SGArea2D/GetOverlappingAreas.tscn")
+
+	var scene = GetOverlappingAreas.instantiate()
+	add_child(scene)
+
+	var world = SGPhysics2DServer.get_default_world()
+	var original_cell_size = SGPhysics2DServer.world_get_broadphase_cell_size(world)
+
+	# Cells far too small for the areas in the scene.
+	SGPhysics2DServer.world_set_broadphase_cell_size(world, 8)
+	SGPhysics2DServer.world_reset_broadphase_statistics(world)
+	var result = scene.do_get_overlapping_areas()
+	assert_eq(result.size(), 1)
+
+	var statistics = SGPhysics2DServer.world_get_broadphase_statistics(world)
+	assert_eq(statistics['cell_size'], 8)
+	assert_gt(statistics['query_count'], 0)
+	assert_gt(statistics['cells_per_element'], 1.0)
+
+	var snapshot = SGPhysics2DServer.world_save_snapshot(world)
+	var state_hash = SGPhysics2DServer.world_get_state_hash(world)
+
+	var cell_size = SGPhysics2DServer.world_tune_broadphase_cell_size(world)
+	assert_gt(cell_size, 8)
+	assert_eq(SGPhysics2DServer.world_get_broadphase_cell_size(world), cell_size)
+	result = scene.do_get_overlapping_areas()
+	assert_eq(result.size(), 1)
+
+	# The cell size is part of the state, so rolling back undoes the tuning.
+	assert_ne(SGPhysics2DServer.world_get_state_hash(world), state_hash)
+	assert_true(SGPhysics2DServer.world_load_snapshot(world, snapshot))
+	assert_eq(SGPhysics2DServer.world_get_broadphase_cell_size(world), 8)
+	assert_eq(SGPhysics2DServer.world_get_state_hash(world), state_hash)
+
+	SGPhysics2DServer.world_set_broadphase_cell_size(world, original_cell_size)
+	remove_child(scene)
+	scene.queue_free()
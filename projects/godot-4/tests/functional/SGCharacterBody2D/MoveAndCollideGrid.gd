@@ -0,0 +1,8 @@
+extends Node2D
+
+@onready var kinematic_body: SGCharacterBody2D = $KinematicBody
+
+func move_from(x: int, y: int, motion: SGFixedVector2) -> SGKinematicCollision2D:
+	kinematic_body.fixed_position = SGFixed.vector2(x, y)
+	kinematic_body.sync_to_physics_engine()
+	return kinematic_body.move_and_collide(motion)
@@ -40,6 +40,28 @@ func test_move_and_collide_deepest_penetration() -> void:
 		remove_child(scene)
 		scene.queue_free()
 
+func test_move_and_collide_time_of_impact_precision() -> void:
+	var MoveAndCollide1 = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide1.tscn")
+	var scene = MoveAndCollide1.instantiate()
+	add_child(scene)
+
+	# A gap of 1.3 pixels, which a 32 pixel move closes at a
+	# time that isn't a multiple of 1/256.
+	scene.kinematic_body.fixed_position = SGFixed.vector2(1310720, 2051277)
+	scene.kinematic_body.sync_to_physics_engine()
+	var collision = scene.kinematic_body.move_and_collide(SGFixed.vector2(0, -2097152))
+	assert_not_null(collision)
+	assert_eq(collision.collider, scene.static_body2)
+	assert_eq(collision.normal.x, 0)
+	assert_eq(collision.normal.y, 65536)
+	assert_eq(scene.kinematic_body.fixed_position.x, 1310720)
+	assert_eq(scene.kinematic_body.fixed_position.y, 1966093)
+	assert_eq(collision.remainder.x, 0)
+	assert_eq(collision.remainder.y, -2011968)
+
+	remove_child(scene)
+	scene.queue_free()
+
 func test_move_and_collide_lowest_scene_tree() -> void:
 	var MoveAndCollide2 = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide2.tscn")
 
@@ -130,3 +152,147 @@ func test_move_and_collide_concave() -> void:
 
 	remove_child(scene)
 	scene.queue_free()
+
+func test_move_and_slide_bodies() -> void:
+	var MoveAndCollide3 = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide3.tscn")
+
+	# Move the bodies one at a time to get the expected positions.
+	var scene = MoveAndCollide3.instantiate()
+	add_child(scene)
+	for _i in range(20):
+		scene._physics_process(1/60)
+	var expected := []
+	for body in [scene.kinematic_right, scene.kinematic_right2, scene.kinematic_left, scene.kinematic_left2]:
+		expected.append(body.fixed_position.x)
+		expected.append(body.fixed_position.y)
+	remove_child(scene)
+	scene.free()
+
+	# Then do the same moves in a single call per frame.
+	scene = MoveAndCollide3.instantiate()
+	add_child(scene)
+	var bodies := [scene.kinematic_right.get_rid(), scene.kinematic_right2.get_rid(), scene.kinematic_left.get_rid(), scene.kinematic_left2.get_rid()]
+	var velocities := PackedInt64Array([SGFixed.ONE * 30, 0, SGFixed.ONE * 30, 0, SGFixed.NEG_ONE * 30, 0, SGFixed.NEG_ONE * 30, 0])
+	var result: Dictionary
+	for _i in range(20):
+		result = SGPhysics2DServer.world_move_and_slide_bodies(SGPhysics2DServer.get_default_world(), bodies, velocities)
+	assert_eq(Array(result["positions"]), expected)
+
+	remove_child(scene)
+	scene.queue_free()
+
+func test_move_and_collide_gjk() -> void:
+	var world: RID = SGPhysics2DServer.get_default_world()
+	SGPhysics2DServer.world_set_narrowphase_type(world, SGPhysics2DServer.NARROWPHASE_GJK)
+	assert_eq(SGPhysics2DServer.world_get_narrowphase_type(world), SGPhysics2DServer.NARROWPHASE_GJK)
+
+	var scene = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide1.tscn").instantiate()
+	add_child(scene)
+
+	var collision: SGKinematicCollision2D = scene.do_move_and_collide()
+	assert_not_null(collision)
+	assert_eq(collision.collider, scene.static_body2)
+	assert_eq(collision.normal.x, 0)
+	assert_eq(collision.normal.y, 65536)
+
+	remove_child(scene)
+	scene.queue_free()
+
+	SGPhysics2DServer.world_set_narrowphase_type(world, SGPhysics2DServer.NARROWPHASE_DEFAULT)
+	assert_eq(SGPhysics2DServer.world_get_narrowphase_type(world), SGPhysics2DServer.NARROWPHASE_SAT)
+
+func test_world_snapshot() -> void:
+	var scene = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide3.tscn").instantiate()
+	add_child(scene)
+
+	var world: RID = SGPhysics2DServer.get_default_world()
+	var rid: RID = scene.kinematic_right.get_rid()
+	var start: SGFixedTransform2D = SGPhysics2DServer.collision_object_get_transform(rid)
+	var snapshot = SGPhysics2DServer.world_save_snapshot(world)
+	var state_hash: int = SGPhysics2DServer.world_get_state_hash(world)
+
+	for _i in range(5):
+		scene._physics_process(1/60)
+	assert_ne(SGPhysics2DServer.collision_object_get_transform(rid).origin.x, start.origin.x)
+	assert_ne(SGPhysics2DServer.world_get_state_hash(world), state_hash)
+
+	assert_true(SGPhysics2DServer.world_load_snapshot(world, snapshot))
+	assert_eq(SGPhysics2DServer.collision_object_get_transform(rid).origin.x, start.origin.x)
+	assert_eq(SGPhysics2DServer.collision_object_get_transform(rid).origin.y, start.origin.y)
+	assert_eq(SGPhysics2DServer.world_save_snapshot(world), snapshot)
+	assert_eq(SGPhysics2DServer.world_get_state_hash(world), state_hash)
+
+	remove_child(scene)
+	scene.queue_free()
+
+func test_world_cast_rays() -> void:
+	var scene = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide3.tscn").instantiate()
+	add_child(scene)
+
+	# Enough rays to be split across several threads.
+	var world: RID = SGPhysics2DServer.get_default_world()
+	var starts := PackedInt64Array()
+	var cast_tos := PackedInt64Array()
+	for i in range(200):
+		starts.append(SGFixed.from_int(-1000 + i * 100))
+		starts.append(SGFixed.from_int(-1000))
+		cast_tos.append(SGFixed.from_int(i % 7))
+		cast_tos.append(SGFixed.from_int(20000))
+	var result: Dictionary = SGPhysics2DServer.world_cast_rays(world, starts, cast_tos, PackedInt32Array([0xFFFFFFFF]))
+
+	var hits := 0
+	for i in range(200):
+		var collision = SGPhysics2DServer.world_cast_ray(world, SGFixed.vector2(starts[i * 2], starts[i * 2 + 1]), SGFixed.vector2(cast_tos[i * 2], cast_tos[i * 2 + 1]), 0xFFFFFFFF)
+		if collision:
+			hits += 1
+			assert_eq(result["colliders"][i], collision.collider_rid)
+			assert_eq(result["points"][i * 2], collision.point.x)
+			assert_eq(result["points"][i * 2 + 1], collision.point.y)
+			assert_eq(result["normals"][i * 2], collision.normal.x)
+			assert_eq(result["normals"][i * 2 + 1], collision.normal.y)
+		else:
+			assert_eq(result["colliders"][i], RID())
+	assert_gt(hits, 0)
+
+	remove_child(scene)
+	scene.queue_free()
+
+func test_move_and_collide_grid() -> void:
+	var scene = load("res://tests/functional/SGCharacterBody2D/MoveAndCollideGrid.tscn").instantiate()
+	add_child(scene)
+
+	var collision: SGKinematicCollision2D
+
+	# Falling onto the solid row at the bottom of the grid.
+	collision = scene.move_from(1048576, -1310720, SGFixed.vector2(0, 3932160))
+	assert_not_null(collision)
+	assert_eq(collision.normal.x, 0)
+	assert_eq(collision.normal.y, -65536)
+	assert_eq(scene.kinematic_body.fixed_position.x, 1048576)
+	assert_eq(scene.kinematic_body.fixed_position.y, 1572820)
+
+	# Falling onto the one-way cell above it.
+	collision = scene.move_from(5242880, -1310720, SGFixed.vector2(0, 3932160))
+	assert_not_null(collision)
+	assert_eq(collision.normal.x, 0)
+	assert_eq(collision.normal.y, -65536)
+	assert_eq(scene.kinematic_body.fixed_position.y, -524300)
+
+	# Jumping up through the one-way cell.
+	collision = scene.move_from(5242880, 1572864, SGFixed.vector2(0, -3932160))
+	assert_null(collision)
+	assert_eq(scene.kinematic_body.fixed_position.y, -2359296)
+
+	remove_child(scene)
+	scene.queue_free()
+
+func test_body_types() -> void:
+	var MoveAndCollide1 = load("res://tests/functional/SGCharacterBody2D/MoveAndCollide1.tscn")
+	var scene = MoveAndCollide1.instantiate()
+	add_child(scene)
+
+	assert_eq(SGPhysics2DServer.body_get_type(scene.static_body1.get_rid()), SGPhysics2DServer.BODY_STATIC)
+	assert_eq(SGPhysics2DServer.body_get_type(scene.kinematic_body.get_rid()), SGPhysics2DServer.BODY_CHARACTER)
+
+	remove_child(scene)
+	scene.queue_free()
@@ -0,0 +1,198 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "../internal/sg_bodies_2d_internal.h"
+#include "../internal/sg_shapes_2d_internal.h"
+
+uint64_t sg_benchmark_allocation_count = 0;
+
+void *operator new(std::size_t p_size) {
+	sg_benchmark_allocation_count++;
+	void *ptr = std::malloc(p_size == 0 ? 1 : p_size);
+	if (ptr == nullptr) {
+		abort();
+	}
+	return ptr;
+}
+
+void *operator new[](std::size_t p_size) {
+	return operator new(p_size);
+}
+
+void operator delete(void *p_ptr) noexcept {
+	std::free(p_ptr);
+}
+
+void operator delete[](void *p_ptr) noexcept {
+	std::free(p_ptr);
+}
+
+void operator delete(void *p_ptr, std::size_t) noexcept {
+	std::free(p_ptr);
+}
+
+void operator delete[](void *p_ptr, std::size_t) noexcept {
+	std::free(p_ptr);
+}
+
+SGBenchmark::SGBenchmark(const Options &p_options) {
+	options = p_options;
+	rng_state = 0x9E3779B97F4A7C15ULL;
+	sink = 0;
+}
+
+SGShape2DInternal *SGBenchmark::create_shape(int p_shape_type, int p_min_size, int p_max_size) {
+	switch (p_shape_type) {
+		case SGShape2DInternal::SHAPE_RECTANGLE:
+			return new SGRectangle2DInternal(random_fixed(p_min_size, p_max_size), random_fixed(p_min_size, p_max_size));
+
+		case SGShape2DInternal::SHAPE_CIRCLE:
+			return new SGCircle2DInternal(random_fixed(p_min_size, p_max_size));
+
+		case SGShape2DInternal::SHAPE_POLYGON:
+			return create_polygon(6, p_min_size, p_max_size);
+
+		default:
+			return new SGCapsule2DInternal(random_fixed(p_min_size, p_max_size), random_fixed(p_min_size * 2, p_max_size * 2));
+	}
+}
+
+SGShape2DInternal *SGBenchmark::create_polygon(int p_vertex_count, int p_min_size, int p_max_size) {
+	fixed rx = random_fixed(p_min_size, p_max_size);
+	fixed ry = random_fixed(p_min_size, p_max_size);
+	std::vector<SGFixedVector2Internal> points;
+	for (int i = 0; i < p_vertex_count; i++) {
+		fixed angle = fixed(fixed::TAU.value * i / p_vertex_count);
+		points.push_back(SGFixedVector2Internal(rx * angle.cos(), ry * angle.sin()));
+	}
+	SGPolygon2DInternal *polygon = new SGPolygon2DInternal();
+	polygon->set_points(points);
+	return polygon;
+}
+
+void SGBenchmark::free_object(SGCollisionObject2DInternal *p_object) {
+	std::vector<SGShape2DInternal *> shapes = p_object->get_shapes();
+	delete p_object;
+	for (SGShape2DInternal *shape : shapes) {
+		delete shape;
+	}
+}
+
+int SGBenchmark::get_world_extent() const {
+	int extent = 64;
+	while (extent * extent < options.size * 64 * 64) {
+		extent += 64;
+	}
+	return extent;
+}
+
+SGFixedVector2Internal SGBenchmark::random_position() {
+	int extent = get_world_extent();
+	return SGFixedVector2Internal(random_fixed(0, extent), random_fixed(0, extent));
+}
+
+void SGBenchmark::print_header() {
+	if (options.csv) {
+		printf("name,ops,ns_per_op,allocs_per_op\n");
+	}
+	else {
+		printf("%-48s %10s %12s %14s\n", "benchmark", "ops", "ns/op", "allocs/op");
+	}
+}
+
+void SGBenchmark::_report(const std::string &p_name, uint64_t p_ops, double p_best_ns, uint64_t p_allocations) {
+	double ns_per_op = p_ops > 0 ? p_best_ns / (double)p_ops : 0.0;
+	double allocations_per_op = p_ops > 0 ? (double)p_allocations / (double)(p_ops * options.iterations) : 0.0;
+	if (options.csv) {
+		printf("%s,%llu,%.2f,%.3f\n", p_name.c_str(), (unsigned long long)p_ops, ns_per_op, allocations_per_op);
+	}
+	else {
+		printf("%-48s %10llu %12.2f %14.3f\n", p_name.c_str(), (unsigned long long)p_ops, ns_per_op, allocations_per_op);
+	}
+	fflush(stdout);
+}
+
+static void print_usage(const char *p_program) {
+	printf("Usage: %s [--size N] [--iterations N] [--filter TEXT] [--csv] [--accuracy]\n", p_program);
+	printf("\n");
+	printf("  --size N        Number of objects in the synthetic worlds (default: 1000)\n");
+	printf("  --iterations N  Times each batch is repeated; the fastest is reported (default: 10)\n");
+	printf("  --filter TEXT   Only run benchmarks whose names contain TEXT\n");
+	printf("  --csv           Print the results as CSV\n");
+	printf("  --accuracy      Measure the error of the fixed-point math, instead of its speed\n");
+}
+
+int main(int argc, char **argv) {
+	SGBenchmark::Options options;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+			options.size = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+			options.iterations = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			options.filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--csv") == 0) {
+			options.csv = true;
+		}
+		else if (strcmp(argv[i], "--accuracy") == 0) {
+			options.accuracy = true;
+		}
+		else {
+			print_usage(argv[0]);
+			return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+	}
+
+	if (options.size < 1 || options.iterations < 1) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	SGBenchmark bench(options);
+
+	if (options.accuracy) {
+		sg_benchmark_math_accuracy(bench);
+		return 0;
+	}
+
+	bench.print_header();
+
+	sg_benchmark_math(bench);
+	sg_benchmark_broadphase(bench);
+	sg_benchmark_collision(bench);
+	sg_benchmark_world(bench);
+
+	return 0;
+}
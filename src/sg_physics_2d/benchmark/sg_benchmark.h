@@ -0,0 +1,138 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SG_BENCHMARK_H
+#define SG_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "../internal/sg_fixed_number_internal.h"
+#include "../internal/sg_fixed_vector2_internal.h"
+
+class SGShape2DInternal;
+class SGCollisionObject2DInternal;
+
+// Counts every allocation made through the global operator new.
+extern uint64_t sg_benchmark_allocation_count;
+
+class SGBenchmark {
+public:
+
+	struct Options {
+		// The number of objects in the synthetic worlds.
+		int size = 1000;
+		// How many times each batch of operations is repeated.
+		int iterations = 10;
+		// Only benchmarks whose names contain this are run.
+		std::string filter;
+		bool csv = false;
+		// Measure the error of the fixed-point math, rather than the speed.
+		bool accuracy = false;
+	};
+
+private:
+
+	Options options;
+	uint64_t rng_state;
+	volatile int64_t sink;
+
+	void _report(const std::string &p_name, uint64_t p_ops, double p_best_ns, uint64_t p_allocations);
+
+public:
+
+	_FORCE_INLINE_ const Options &get_options() const { return options; }
+	_FORCE_INLINE_ int get_size() const { return options.size; }
+
+	// Deterministic xorshift, so that every run builds the same worlds.
+	_FORCE_INLINE_ uint64_t random() {
+		rng_state ^= rng_state << 13;
+		rng_state ^= rng_state >> 7;
+		rng_state ^= rng_state << 17;
+		return rng_state;
+	}
+	_FORCE_INLINE_ int64_t random_range(int64_t p_min, int64_t p_max) {
+		return p_min + (int64_t)(random() % (uint64_t)(p_max - p_min));
+	}
+	_FORCE_INLINE_ fixed random_fixed(int64_t p_min, int64_t p_max) {
+		return fixed(random_range(p_min << 16, p_max << 16));
+	}
+
+	// Creates a shape of the given SGShape2DInternal::ShapeType, with a
+	// random size between p_min_size and p_max_size pixels.
+	SGShape2DInternal *create_shape(int p_shape_type, int p_min_size, int p_max_size);
+	// A convex polygon with p_vertex_count vertices around an ellipse.
+	SGShape2DInternal *create_polygon(int p_vertex_count, int p_min_size, int p_max_size);
+
+	// Deletes the object and its shapes. It must not be in a world.
+	void free_object(SGCollisionObject2DInternal *p_object);
+
+	// The synthetic worlds keep the same density of objects, whatever their
+	// size, so this is the width and height of the area to fill.
+	int get_world_extent() const;
+	SGFixedVector2Internal random_position();
+
+	// Runs p_batch (which does p_ops operations and returns anything
+	// derived from their results) once to warm up, and then once per
+	// iteration, and reports the time per operation of the fastest batch, and
+	// the allocations per operation over the measured batches.
+	template <class T>
+	void measure(const std::string &p_name, uint64_t p_ops, T p_batch) {
+		if (!options.filter.empty() && p_name.find(options.filter) == std::string::npos) {
+			return;
+		}
+
+		// Lets caches and scratch buffers grow to size, so the allocations
+		// they make once aren't counted against every operation.
+		sink = sink + p_batch();
+
+		double best_ns = -1.0;
+		uint64_t allocations_before = sg_benchmark_allocation_count;
+		for (int i = 0; i < options.iterations; i++) {
+			auto start = std::chrono::steady_clock::now();
+			sink = sink + p_batch();
+			auto end = std::chrono::steady_clock::now();
+			double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			if (best_ns < 0.0 || ns < best_ns) {
+				best_ns = ns;
+			}
+		}
+		uint64_t allocations = sg_benchmark_allocation_count - allocations_before;
+
+		_report(p_name, p_ops, best_ns, allocations);
+	}
+
+	void print_header();
+
+	SGBenchmark(const Options &p_options);
+};
+
+void sg_benchmark_math(SGBenchmark &p_bench);
+void sg_benchmark_math_accuracy(SGBenchmark &p_bench);
+void sg_benchmark_broadphase(SGBenchmark &p_bench);
+void sg_benchmark_collision(SGBenchmark &p_bench);
+void sg_benchmark_world(SGBenchmark &p_bench);
+
+#endif
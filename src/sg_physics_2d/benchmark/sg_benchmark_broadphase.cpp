@@ -0,0 +1,146 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_benchmark.h"
+
+#include <vector>
+
+#include "../internal/sg_broadphase_2d_internal.h"
+#include "../internal/sg_bodies_2d_internal.h"
+#include "../internal/sg_shapes_2d_internal.h"
+
+class SGBenchmarkCountResultHandler : public SGResultHandlerInternal {
+public:
+
+	int64_t count = 0;
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_shape) {
+		count++;
+	}
+
+};
+
+// Never reports a hit, so rays are followed all the way to their end.
+class SGBenchmarkCountRayResultHandler : public SGRayResultHandlerInternal {
+public:
+
+	int64_t count = 0;
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_shape) {
+		count++;
+	}
+
+	bool get_closest_hit(SGFixedVector2Internal &r_point) const {
+		return false;
+	}
+
+};
+
+static void sg_benchmark_broadphase_type(SGBenchmark &p_bench, SGBroadphase2DInternal::BroadphaseType p_type, const std::string &p_prefix) {
+	const int size = p_bench.get_size();
+
+	std::vector<SGBody2DInternal *> bodies;
+	for (int i = 0; i < size; i++) {
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_KINEMATIC);
+		body->add_shape(p_bench.create_shape(SGShape2DInternal::SHAPE_RECTANGLE, 4, 32));
+		body->set_transform(SGFixedTransform2DInternal(fixed::ZERO, p_bench.random_position()));
+		bodies.push_back(body);
+	}
+
+	p_bench.measure(p_prefix + "insert_delete", size, [&]() {
+		SGBroadphase2DInternal *broadphase = SGBroadphase2DInternal::create(p_type, 64);
+		std::vector<int32_t> elements;
+		elements.reserve(size);
+		for (SGBody2DInternal *body : bodies) {
+			elements.push_back(broadphase->create_element(body));
+		}
+		for (int32_t element : elements) {
+			broadphase->delete_element(element);
+		}
+		delete broadphase;
+		return (int64_t)elements.size();
+	});
+
+	SGBroadphase2DInternal *broadphase = SGBroadphase2DInternal::create(p_type, 64);
+	std::vector<int32_t> elements;
+	for (SGBody2DInternal *body : bodies) {
+		elements.push_back(broadphase->create_element(body));
+	}
+
+	// Small moves, like characters walking around.
+	std::vector<SGFixedVector2Internal> offsets;
+	for (int i = 0; i < size; i++) {
+		offsets.push_back(SGFixedVector2Internal(p_bench.random_fixed(-4, 4), p_bench.random_fixed(-4, 4)));
+	}
+	bool forward = true;
+	p_bench.measure(p_prefix + "update", size, [&]() {
+		for (int i = 0; i < size; i++) {
+			SGFixedTransform2DInternal t = bodies[i]->get_transform();
+			t.set_origin(forward ? t.get_origin() + offsets[i] : t.get_origin() - offsets[i]);
+			bodies[i]->set_transform(t);
+			broadphase->update_element(elements[i]);
+		}
+		forward = !forward;
+		return (int64_t)size;
+	});
+
+	std::vector<SGFixedRect2Internal> queries;
+	for (int i = 0; i < 1024; i++) {
+		queries.push_back(SGFixedRect2Internal(p_bench.random_position(), SGFixedVector2Internal(p_bench.random_fixed(8, 128), p_bench.random_fixed(8, 128))));
+	}
+	p_bench.measure(p_prefix + "query", queries.size(), [&]() {
+		SGBenchmarkCountResultHandler handler;
+		for (const SGFixedRect2Internal &query : queries) {
+			broadphase->find_nearby(query, &handler);
+		}
+		return handler.count;
+	});
+
+	std::vector<SGFixedVector2Internal> ray_starts;
+	std::vector<SGFixedVector2Internal> ray_casts;
+	for (int i = 0; i < 256; i++) {
+		ray_starts.push_back(p_bench.random_position());
+		ray_casts.push_back(SGFixedVector2Internal(p_bench.random_fixed(-2048, 2048), p_bench.random_fixed(-2048, 2048)));
+	}
+	p_bench.measure(p_prefix + "ray", ray_starts.size(), [&]() {
+		SGBenchmarkCountRayResultHandler handler;
+		for (std::size_t i = 0; i < ray_starts.size(); i++) {
+			broadphase->find_along_ray(ray_starts[i], ray_casts[i], &handler);
+		}
+		return handler.count;
+	});
+
+	for (int32_t element : elements) {
+		broadphase->delete_element(element);
+	}
+	delete broadphase;
+	for (SGBody2DInternal *body : bodies) {
+		p_bench.free_object(body);
+	}
+}
+
+void sg_benchmark_broadphase(SGBenchmark &p_bench) {
+	sg_benchmark_broadphase_type(p_bench, SGBroadphase2DInternal::BROADPHASE_SPATIAL_HASH, "broadphase/spatial_hash/");
+	sg_benchmark_broadphase_type(p_bench, SGBroadphase2DInternal::BROADPHASE_AABB_TREE, "broadphase/aabb_tree/");
+}
@@ -0,0 +1,176 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_benchmark.h"
+
+#include <vector>
+
+#include "../internal/sg_world_2d_internal.h"
+#include "../internal/sg_bodies_2d_internal.h"
+#include "../internal/sg_shapes_2d_internal.h"
+
+static const char *shape_names[] = {
+	"rectangle",
+	"circle",
+	"polygon",
+	"capsule",
+};
+
+static void sg_benchmark_collision_pair(SGBenchmark &p_bench, SGWorld2DInternal &p_world, const std::string &p_name, int p_type1, int p_type2, int p_polygon_vertex_count) {
+	const int count = 512;
+
+	// Place the pairs so that roughly half of them are overlapping, and the
+	// others are close enough to need the full narrowphase.
+	std::vector<SGBody2DInternal *> bodies;
+	for (int i = 0; i < count * 2; i++) {
+		int type = i % 2 == 0 ? p_type1 : p_type2;
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_KINEMATIC);
+		if (type == SGShape2DInternal::SHAPE_POLYGON) {
+			body->add_shape(p_bench.create_polygon(p_polygon_vertex_count, 8, 24));
+		}
+		else {
+			body->add_shape(p_bench.create_shape(type, 8, 24));
+		}
+		SGFixedVector2Internal position = i % 2 == 0 ? SGFixedVector2Internal() : SGFixedVector2Internal(p_bench.random_fixed(-48, 48), p_bench.random_fixed(-48, 48));
+		body->set_transform(SGFixedTransform2DInternal(fixed(p_bench.random_range(0, 411774)), position));
+		bodies.push_back(body);
+	}
+
+	for (int narrowphase = SGWorld2DInternal::NARROWPHASE_SAT; narrowphase <= SGWorld2DInternal::NARROWPHASE_GJK; narrowphase++) {
+		p_world.set_narrowphase_type((SGWorld2DInternal::NarrowphaseType)narrowphase);
+		std::string prefix = narrowphase == SGWorld2DInternal::NARROWPHASE_SAT ? "collision/sat/" : "collision/gjk/";
+		p_bench.measure(prefix + p_name, count, [&]() {
+			int64_t result = 0;
+			SGWorld2DInternal::ShapeOverlapInfo info;
+			for (int i = 0; i < count; i++) {
+				if (p_world.overlaps(bodies[i * 2]->get_shapes()[0], bodies[i * 2 + 1]->get_shapes()[0], fixed::ZERO, &info)) {
+					result += info.separation.x.value + 1;
+				}
+			}
+			return result;
+		});
+	}
+
+	for (SGBody2DInternal *body : bodies) {
+		p_bench.free_object(body);
+	}
+}
+
+// Characters made of several hitboxes against each other, where most of the
+// shape pairs are nowhere near each other.
+static void sg_benchmark_collision_hitboxes(SGBenchmark &p_bench, SGWorld2DInternal &p_world) {
+	const int count = 256;
+	const int shape_count = 5;
+
+	std::vector<SGBody2DInternal *> bodies;
+	for (int i = 0; i < count * 2; i++) {
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_KINEMATIC);
+		for (int j = 0; j < shape_count; j++) {
+			SGShape2DInternal *shape = p_bench.create_shape(SGShape2DInternal::SHAPE_RECTANGLE, 4, 12);
+			shape->set_transform(SGFixedTransform2DInternal(fixed::ZERO, SGFixedVector2Internal(p_bench.random_fixed(-24, 24), p_bench.random_fixed(-48, 48))));
+			body->add_shape(shape);
+		}
+		SGFixedVector2Internal position = i % 2 == 0 ? SGFixedVector2Internal() : SGFixedVector2Internal(p_bench.random_fixed(-48, 48), p_bench.random_fixed(-48, 48));
+		body->set_transform(SGFixedTransform2DInternal(fixed::ZERO, position));
+		bodies.push_back(body);
+	}
+
+	p_bench.measure("collision/hitboxes_5x5", count, [&]() {
+		int64_t result = 0;
+		SGWorld2DInternal::BodyOverlapInfo info;
+		for (int i = 0; i < count; i++) {
+			if (p_world.overlaps(bodies[i * 2], bodies[i * 2 + 1], fixed::ZERO, &info)) {
+				result += info.separation.x.value + 1;
+			}
+		}
+		return result;
+	});
+
+	for (SGBody2DInternal *body : bodies) {
+		p_bench.free_object(body);
+	}
+}
+
+// Characters against a big tilemap, where only the few cells around each
+// character should be looked at.
+static void sg_benchmark_collision_grid(SGBenchmark &p_bench, SGWorld2DInternal &p_world) {
+	const int count = 512;
+	const int grid_size = 256;
+
+	SGGrid2DInternal *grid = new SGGrid2DInternal(SGFixedVector2Internal(fixed(16 << 16), fixed(16 << 16)));
+	grid->set_size(grid_size, grid_size);
+	for (int y = 0; y < grid_size; y++) {
+		for (int x = 0; x < grid_size; x++) {
+			if (p_bench.random_range(0, 10) < 3) {
+				grid->set_cell(x, y, SGGrid2DInternal::CELL_SOLID);
+			}
+		}
+	}
+	SGBody2DInternal *grid_body = new SGBody2DInternal(SGBody2DInternal::BODY_STATIC);
+	grid_body->add_shape(grid);
+
+	std::vector<SGBody2DInternal *> bodies;
+	for (int i = 0; i < count; i++) {
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_KINEMATIC);
+		body->add_shape(p_bench.create_shape(i % 2 == 0 ? SGShape2DInternal::SHAPE_RECTANGLE : SGShape2DInternal::SHAPE_CAPSULE, 8, 24));
+		body->set_transform(SGFixedTransform2DInternal(fixed::ZERO, SGFixedVector2Internal(p_bench.random_fixed(0, grid_size * 16), p_bench.random_fixed(0, grid_size * 16))));
+		bodies.push_back(body);
+	}
+
+	p_bench.measure("collision/grid256", count, [&]() {
+		int64_t result = 0;
+		SGWorld2DInternal::BodyOverlapInfo info;
+		for (int i = 0; i < count; i++) {
+			if (p_world.overlaps(bodies[i], grid_body, fixed::ZERO, &info)) {
+				result += info.separation.x.value + 1;
+			}
+		}
+		return result;
+	});
+
+	for (SGBody2DInternal *body : bodies) {
+		p_bench.free_object(body);
+	}
+	p_bench.free_object(grid_body);
+}
+
+void sg_benchmark_collision(SGBenchmark &p_bench) {
+	// Only used for its narrowphase.
+	SGWorld2DInternal world(64);
+
+	for (int type1 = SGShape2DInternal::SHAPE_RECTANGLE; type1 <= SGShape2DInternal::SHAPE_CAPSULE; type1++) {
+		for (int type2 = type1; type2 <= SGShape2DInternal::SHAPE_CAPSULE; type2++) {
+			std::string name = std::string(shape_names[type1]) + "_" + shape_names[type2];
+			sg_benchmark_collision_pair(p_bench, world, name, type1, type2, 6);
+		}
+	}
+
+	// Polygons with lots of vertices, like terrain, are where SAT and GJK
+	// differ the most.
+	sg_benchmark_collision_pair(p_bench, world, "polygon24_polygon24", SGShape2DInternal::SHAPE_POLYGON, SGShape2DInternal::SHAPE_POLYGON, 24);
+	sg_benchmark_collision_pair(p_bench, world, "capsule_polygon24", SGShape2DInternal::SHAPE_CAPSULE, SGShape2DInternal::SHAPE_POLYGON, 24);
+
+	sg_benchmark_collision_hitboxes(p_bench, world);
+	sg_benchmark_collision_grid(p_bench, world);
+}
@@ -0,0 +1,78 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SG_BENCHMARK_ERROR_MACROS_H
+#define SG_BENCHMARK_ERROR_MACROS_H
+
+// The small subset of Godot's error macros used by internal/, so that the
+// benchmark can be built without linking against Godot or godot-cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#define _FORCE_INLINE_ inline
+
+#define SWAP(m_x, m_y) std::swap((m_x), (m_y))
+
+#define _SG_BENCHMARK_ERROR(m_msg) \
+	fprintf(stderr, "ERROR: %s (%s:%d)\n", m_msg, __FILE__, __LINE__)
+
+#define ERR_FAIL_COND(m_cond) \
+	if (m_cond) { \
+		_SG_BENCHMARK_ERROR("Condition \"" #m_cond "\" is true."); \
+		return; \
+	} else \
+		((void)0)
+
+#define ERR_FAIL_COND_V(m_cond, m_retval) \
+	if (m_cond) { \
+		_SG_BENCHMARK_ERROR("Condition \"" #m_cond "\" is true."); \
+		return m_retval; \
+	} else \
+		((void)0)
+
+#define ERR_FAIL_COND_V_MSG(m_cond, m_retval, m_msg) \
+	if (m_cond) { \
+		_SG_BENCHMARK_ERROR(m_msg); \
+		return m_retval; \
+	} else \
+		((void)0)
+
+#define ERR_FAIL_INDEX(m_index, m_size) \
+	if ((m_index) < 0 || (m_index) >= (m_size)) { \
+		_SG_BENCHMARK_ERROR("Index \"" #m_index "\" is out of bounds."); \
+		return; \
+	} else \
+		((void)0)
+
+#define ERR_FAIL_INDEX_V(m_index, m_size, m_retval) \
+	if ((m_index) < 0 || (m_index) >= (m_size)) { \
+		_SG_BENCHMARK_ERROR("Index \"" #m_index "\" is out of bounds."); \
+		return m_retval; \
+	} else \
+		((void)0)
+
+#endif
@@ -0,0 +1,220 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../internal/sg_fixed_vector2_internal.h"
+#include "../internal/sg_fixed_transform_2d_internal.h"
+
+void sg_benchmark_math(SGBenchmark &p_bench) {
+	const int count = 4096;
+
+	std::vector<fixed> values;
+	std::vector<fixed> others;
+	std::vector<fixed> angles;
+	std::vector<fixed> ratios;
+	std::vector<SGFixedVector2Internal> vectors;
+	for (int i = 0; i < count; i++) {
+		values.push_back(p_bench.random_fixed(1, 30000));
+		others.push_back(p_bench.random_fixed(1, 1000));
+		angles.push_back(fixed(p_bench.random_range(-411774, 411774)));
+		ratios.push_back(fixed(p_bench.random_range(-65536, 65536)));
+		vectors.push_back(SGFixedVector2Internal(p_bench.random_fixed(-1000, 1000), p_bench.random_fixed(-1000, 1000)));
+	}
+
+	p_bench.measure("math/mul", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += (values[i] * others[i]).value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/div", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += (values[i] / others[i]).value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/sqrt", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += values[i].sqrt().value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/sin", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += angles[i].sin().value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/cos", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += angles[i].cos().value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/sincos", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			fixed s, c;
+			angles[i].sincos(s, c);
+			result += s.value + c.value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/asin", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += ratios[i].asin().value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/atan2", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += vectors[i].y.atan2(vectors[i].x).value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/vector_length", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += vectors[i].length().value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/vector_normalized", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += vectors[i].normalized().x.value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/vector_rotated", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			result += vectors[i].rotated(angles[i]).x.value;
+		}
+		return result;
+	});
+
+	p_bench.measure("math/transform_xform", count, [&]() {
+		int64_t result = 0;
+		for (int i = 0; i < count; i++) {
+			SGFixedTransform2DInternal t(angles[i], vectors[i]);
+			result += t.xform(vectors[count - i - 1]).y.value;
+		}
+		return result;
+	});
+}
+
+// Tracks the error of a function against the double precision result, in
+// units of the last place (ie. 1 / 65536).
+struct SGBenchmarkError {
+	const char *name;
+	double max = 0.0;
+	double total = 0.0;
+	uint64_t count = 0;
+
+	void add(fixed p_result, double p_expected) {
+		double error = std::fabs((double)p_result.value - p_expected * 65536.0);
+		max = error > max ? error : max;
+		total += error;
+		count++;
+	}
+
+	void report(bool p_csv) const {
+		double mean = count > 0 ? total / (double)count : 0.0;
+		if (p_csv) {
+			printf("%s,%llu,%.2f,%.3f\n", name, (unsigned long long)count, max, mean);
+		}
+		else {
+			printf("%-48s %10llu %12.2f %14.3f\n", name, (unsigned long long)count, max, mean);
+		}
+	}
+
+	SGBenchmarkError(const char *p_name) : name(p_name) {}
+};
+
+void sg_benchmark_math_accuracy(SGBenchmark &p_bench) {
+	const bool csv = p_bench.get_options().csv;
+	const int count = 1 << 20;
+
+	SGBenchmarkError sin_error("math/sin");
+	SGBenchmarkError cos_error("math/cos");
+	SGBenchmarkError atan2_error("math/atan2");
+	SGBenchmarkError asin_error("math/asin");
+	SGBenchmarkError acos_error("math/acos");
+
+	for (int i = 0; i < count; i++) {
+		fixed angle = fixed(p_bench.random_range(-411774, 411774));
+		double radians = (double)angle.value / 65536.0;
+		sin_error.add(angle.sin(), std::sin(radians));
+		cos_error.add(angle.cos(), std::cos(radians));
+
+		SGFixedVector2Internal v(p_bench.random_fixed(-1000, 1000), p_bench.random_fixed(-1000, 1000));
+		atan2_error.add(v.y.atan2(v.x), std::atan2((double)v.y.value, (double)v.x.value));
+
+		fixed ratio = fixed(p_bench.random_range(-65536, 65537));
+		double r = (double)ratio.value / 65536.0;
+		asin_error.add(ratio.asin(), std::asin(r));
+		acos_error.add(ratio.acos(), std::acos(r));
+	}
+
+#ifdef SG_FIXED_TRIG_TABLES
+	const char *mode = "lookup tables";
+#else
+	const char *mode = "polynomials";
+#endif
+	if (csv) {
+		printf("name,samples,max_error,mean_error\n");
+	}
+	else {
+		printf("Trigonometry using %s, errors in units of 1/65536:\n", mode);
+		printf("%-48s %10s %12s %14s\n", "function", "samples", "max error", "mean error");
+	}
+	sin_error.report(csv);
+	cos_error.report(csv);
+	atan2_error.report(csv);
+	asin_error.report(csv);
+	acos_error.report(csv);
+}
@@ -0,0 +1,140 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_benchmark.h"
+
+#include <vector>
+
+#include "../internal/sg_world_2d_internal.h"
+#include "../internal/sg_bodies_2d_internal.h"
+#include "../internal/sg_shapes_2d_internal.h"
+
+static void sg_benchmark_world_type(SGBenchmark &p_bench, SGBroadphase2DInternal::BroadphaseType p_type, const std::string &p_prefix) {
+	const int size = p_bench.get_size();
+	const int moving_count = 64;
+
+	SGWorld2DInternal world(64, nullptr, p_type);
+
+	// A level made of static bodies with a mix of every shape type.
+	std::vector<SGBody2DInternal *> bodies;
+	for (int i = 0; i < size; i++) {
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_STATIC);
+		body->add_shape(p_bench.create_shape(i % 4, 8, 32));
+		body->set_transform(SGFixedTransform2DInternal(fixed(p_bench.random_range(0, 411774)), p_bench.random_position()));
+		world.add_body(body);
+		bodies.push_back(body);
+	}
+
+	// Characters moving around in it.
+	std::vector<SGBody2DInternal *> moving;
+	std::vector<SGFixedTransform2DInternal> transforms;
+	std::vector<SGFixedVector2Internal> velocities;
+	for (int i = 0; i < moving_count; i++) {
+		SGBody2DInternal *body = new SGBody2DInternal(SGBody2DInternal::BODY_KINEMATIC);
+		body->add_shape(p_bench.create_shape(i % 2 == 0 ? SGShape2DInternal::SHAPE_RECTANGLE : SGShape2DInternal::SHAPE_CAPSULE, 8, 16));
+		body->set_transform(SGFixedTransform2DInternal(fixed::ZERO, p_bench.random_position()));
+		world.add_body(body);
+		world.unstuck_body(body, 16);
+		moving.push_back(body);
+		transforms.push_back(body->get_transform());
+		velocities.push_back(SGFixedVector2Internal(p_bench.random_fixed(-32, 32), p_bench.random_fixed(-32, 32)));
+	}
+
+	auto reset = [&]() {
+		for (int i = 0; i < moving_count; i++) {
+			moving[i]->set_transform(transforms[i]);
+		}
+	};
+
+	p_bench.measure(p_prefix + "move_and_collide", moving_count, [&]() {
+		reset();
+		int64_t result = 0;
+		SGWorld2DInternal::BodyCollisionInfo info;
+		for (int i = 0; i < moving_count; i++) {
+			if (world.move_and_collide(moving[i], velocities[i], &info)) {
+				result += info.remainder.x.value + 1;
+			}
+		}
+		return result;
+	});
+
+	SGFixedVector2Internal up(fixed::ZERO, fixed::NEG_ONE);
+	p_bench.measure(p_prefix + "move_and_slide", moving_count, [&]() {
+		reset();
+		int64_t result = 0;
+		SGWorld2DInternal::BodySlideInfo info;
+		for (int i = 0; i < moving_count; i++) {
+			world.move_and_slide(moving[i], velocities[i], up, 4, fixed(51471), &info);
+			result += info.velocity.x.value;
+		}
+		return result;
+	});
+	reset();
+
+	std::vector<SGFixedVector2Internal> ray_starts;
+	std::vector<SGFixedVector2Internal> ray_casts;
+	for (int i = 0; i < 1024; i++) {
+		ray_starts.push_back(p_bench.random_position());
+		ray_casts.push_back(SGFixedVector2Internal(p_bench.random_fixed(-256, 256), p_bench.random_fixed(-256, 256)));
+	}
+	p_bench.measure(p_prefix + "cast_ray", ray_starts.size(), [&]() {
+		int64_t result = 0;
+		SGWorld2DInternal::RayCastInfo info;
+		for (std::size_t i = 0; i < ray_starts.size(); i++) {
+			if (world.cast_ray(ray_starts[i], ray_casts[i], 0xFFFFFFFF, nullptr, false, true, &info)) {
+				result += info.collision_point.x.value;
+			}
+		}
+		return result;
+	});
+
+	// Long rays, which cross lots of cells but usually hit something early on.
+	for (std::size_t i = 0; i < ray_casts.size(); i++) {
+		ray_casts[i] = SGFixedVector2Internal(p_bench.random_fixed(-2048, 2048), p_bench.random_fixed(-2048, 2048));
+	}
+	p_bench.measure(p_prefix + "cast_ray_long", ray_starts.size(), [&]() {
+		int64_t result = 0;
+		SGWorld2DInternal::RayCastInfo info;
+		for (std::size_t i = 0; i < ray_starts.size(); i++) {
+			if (world.cast_ray(ray_starts[i], ray_casts[i], 0xFFFFFFFF, nullptr, false, true, &info)) {
+				result += info.collision_point.x.value;
+			}
+		}
+		return result;
+	});
+
+	for (SGBody2DInternal *body : moving) {
+		world.remove_body(body);
+		p_bench.free_object(body);
+	}
+	for (SGBody2DInternal *body : bodies) {
+		world.remove_body(body);
+		p_bench.free_object(body);
+	}
+}
+
+void sg_benchmark_world(SGBenchmark &p_bench) {
+	sg_benchmark_world_type(p_bench, SGBroadphase2DInternal::BROADPHASE_SPATIAL_HASH, "world/spatial_hash/");
+	sg_benchmark_world_type(p_bench, SGBroadphase2DInternal::BROADPHASE_AABB_TREE, "world/aabb_tree/");
+}
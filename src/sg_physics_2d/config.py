@@ -16,9 +16,11 @@ def get_doc_classes():
     return [
         'SGArea2D',
         'SGAreaCollision2D',
+        'SGAreaOverlapEvent2D',
         'SGAStar2D',
         'SGCapsuleShape2D',
         'SGCircleShape2D',
+        'SGCollisionGrid2D',
         'SGCollisionObject2D',
         'SGCollisionPolygon2D',
         'SGCollisionShape2D',
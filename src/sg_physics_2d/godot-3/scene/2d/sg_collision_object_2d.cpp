@@ -27,6 +27,7 @@
 
 #include "sg_collision_shape_2d.h"
 #include "sg_collision_polygon_2d.h"
+#include "sg_collision_grid_2d.h"
 #include "../../servers/sg_physics_2d_server.h"
 
 #include "../../../internal/sg_bodies_2d_internal.h"
@@ -80,6 +81,10 @@ String SGCollisionObject2D::get_configuration_warning() const {
 			has_shape_child = true;
 			break;
 		}
+		if (Object::cast_to<SGCollisionGrid2D>(get_child(i))) {
+			has_shape_child = true;
+			break;
+		}
 	}
 	if (!has_shape_child) {
 		if (warning != String()) {
@@ -115,6 +120,12 @@ void SGCollisionObject2D::sync_to_physics_engine() const {
 			if (polygon) {
 				polygon->sync_to_physics_engine();
 			}
+			else {
+				SGCollisionGrid2D *grid = Object::cast_to<SGCollisionGrid2D>(get_child(i));
+				if (grid) {
+					grid->sync_to_physics_engine();
+				}
+			}
 		}
 	}
 
@@ -33,6 +33,7 @@ class SGCollisionObject2D : public SGFixedNode2D {
 
 	friend class SGCollisionShape2D;
 	friend class SGCollisionPolygon2D;
+	friend class SGCollisionGrid2D;
 
 	uint32_t collision_layer;
 	uint32_t collision_mask;
@@ -37,7 +37,7 @@ protected:
 	RID collision_object_rid;
 	RID rid;
 	bool disabled;
-	bool concave;
+	bool invalid;
 
 protected:
 	static void _bind_methods();
@@ -47,9 +47,9 @@ protected:
 	void update_aabb() const;
 	void update_fixed_polygon();
 
-	void check_concave();
+	void check_invalid();
 
-	static bool is_convex(const Array &p_vertices);
+	static bool is_valid_polygon(const Array &p_vertices);
 
 	Array _get_fixed_polygon_pairs() const;
 	void _set_fixed_polygon_pairs(const Array &p_pairs);
@@ -23,7 +23,12 @@
 
 #include "sg_physics_2d_server.h"
 
+#include <cstring>
+
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "scene/main/node.h"
 
 #include "../scene/2d/sg_collision_object_2d.h"
@@ -84,6 +89,106 @@ struct SGInternalData {
 	}
 };
 
+// Rays are handed out to threads in chunks of this many, so that the
+// overhead of dispatching them stays small next to the work.
+#define SG_RAY_CAST_BATCH_CHUNK_SIZE 64
+
+struct SGRayCastBatch {
+	SGWorld2DInternal *world;
+	std::vector<SGFixedVector2Internal> starts;
+	std::vector<SGFixedVector2Internal> cast_tos;
+	std::vector<uint32_t> collision_masks;
+	std::unordered_set<SGCollisionObject2DInternal *> exceptions;
+	bool collide_with_areas;
+	bool collide_with_bodies;
+	// Each ray only writes to its own entry, so the results don't depend on
+	// how the chunks were scheduled.
+	std::vector<SGWorld2DInternal::RayCastInfo> results;
+
+	void cast_chunk(int p_chunk) {
+		int end = MIN((p_chunk + 1) * SG_RAY_CAST_BATCH_CHUNK_SIZE, (int)results.size());
+		for (int i = p_chunk * SG_RAY_CAST_BATCH_CHUNK_SIZE; i < end; i++) {
+			world->cast_ray(starts[i], cast_tos[i], collision_masks[i], &exceptions, collide_with_areas, collide_with_bodies, &results[i]);
+		}
+	}
+};
+
+// Worker threads that live as long as the server, so that casting a batch
+// of rays doesn't have to start and join threads every time. The calling
+// thread does its share of the work too.
+struct SGRayCastThreadPool {
+	Thread *threads = nullptr;
+	int thread_count = 0;
+	bool exiting = false;
+
+	// Posted once per worker needed for a batch, and once by each of them
+	// when they've finished their share.
+	Semaphore work_semaphore;
+	Semaphore done_semaphore;
+
+	SGRayCastBatch *batch = nullptr;
+	int batch_thread_count = 0;
+	int batch_chunk_count = 0;
+	std::atomic<int> next_share { 0 };
+
+	// Each thread takes every batch_thread_count'th chunk, starting at
+	// p_first_chunk.
+	void cast_share(int p_first_chunk) {
+		for (int chunk = p_first_chunk; chunk < batch_chunk_count; chunk += batch_thread_count) {
+			batch->cast_chunk(chunk);
+		}
+	}
+
+	static void run(void *p_userdata) {
+		SGRayCastThreadPool *self = (SGRayCastThreadPool *)p_userdata;
+		while (true) {
+			self->work_semaphore.wait();
+			if (self->exiting) {
+				break;
+			}
+			self->cast_share(self->next_share.fetch_add(1));
+			self->done_semaphore.post();
+		}
+	}
+
+	void cast(SGRayCastBatch *p_batch, int p_chunk_count) {
+		batch = p_batch;
+		batch_chunk_count = p_chunk_count;
+		batch_thread_count = MIN(thread_count + 1, p_chunk_count);
+		// Share 0 is taken by this thread.
+		next_share.store(1);
+
+		for (int i = 1; i < batch_thread_count; i++) {
+			work_semaphore.post();
+		}
+		cast_share(0);
+		for (int i = 1; i < batch_thread_count; i++) {
+			done_semaphore.wait();
+		}
+
+		batch = nullptr;
+	}
+
+	SGRayCastThreadPool(int p_thread_count) {
+		thread_count = p_thread_count;
+		threads = memnew_arr(Thread, thread_count);
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].start(&SGRayCastThreadPool::run, this);
+		}
+	}
+
+	~SGRayCastThreadPool() {
+		exiting = true;
+		for (int i = 0; i < thread_count; i++) {
+			work_semaphore.post();
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		memdelete_arr(threads);
+	}
+};
+
 SGPhysics2DServer *SGPhysics2DServer::singleton = nullptr;
 
 static bool sg_compare_collision_objects(const SGCollisionObject2DInternal* p_a, const SGCollisionObject2DInternal *p_b) {
@@ -150,6 +255,57 @@ SGAreaCollision2D::SGAreaCollision2D() {
 	shape = nullptr;
 }
 
+void SGAreaOverlapEvent2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_type"), &SGAreaOverlapEvent2D::get_type);
+	ClassDB::bind_method(D_METHOD("get_area"), &SGAreaOverlapEvent2D::get_area);
+	ClassDB::bind_method(D_METHOD("get_area_rid"), &SGAreaOverlapEvent2D::get_area_rid);
+	ClassDB::bind_method(D_METHOD("get_collider"), &SGAreaOverlapEvent2D::get_collider);
+	ClassDB::bind_method(D_METHOD("get_collider_rid"), &SGAreaOverlapEvent2D::get_collider_rid);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "type", PROPERTY_HINT_ENUM, "Begin,End"), "", "get_type");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "area"), "", "get_area");
+	ADD_PROPERTY(PropertyInfo(Variant::_RID, "area_rid"), "", "get_area_rid");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "collider"), "", "get_collider");
+	ADD_PROPERTY(PropertyInfo(Variant::_RID, "collider_rid"), "", "get_collider_rid");
+
+	BIND_ENUM_CONSTANT(OVERLAP_BEGIN);
+	BIND_ENUM_CONSTANT(OVERLAP_END);
+}
+
+SGAreaOverlapEvent2D::EventType SGAreaOverlapEvent2D::get_type() const {
+	return type;
+}
+
+SGCollisionObject2D *SGAreaOverlapEvent2D::get_area() const {
+	return area;
+}
+
+RID SGAreaOverlapEvent2D::get_area_rid() const {
+	return area_rid;
+}
+
+SGCollisionObject2D *SGAreaOverlapEvent2D::get_collider() const {
+	return collider;
+}
+
+RID SGAreaOverlapEvent2D::get_collider_rid() const {
+	return collider_rid;
+}
+
+SGAreaOverlapEvent2D::SGAreaOverlapEvent2D(EventType p_type, SGCollisionObject2D *p_area, RID p_area_rid, SGCollisionObject2D *p_collider, RID p_collider_rid) {
+	type = p_type;
+	area = p_area;
+	area_rid = p_area_rid;
+	collider = p_collider;
+	collider_rid = p_collider_rid;
+}
+
+SGAreaOverlapEvent2D::SGAreaOverlapEvent2D() {
+	type = OVERLAP_BEGIN;
+	area = nullptr;
+	collider = nullptr;
+}
+
 void SGKinematicCollision2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_collider"), &SGKinematicCollision2D::get_collider);
 	ClassDB::bind_method(D_METHOD("get_collider_rid"), &SGKinematicCollision2D::get_collider_rid);
@@ -229,11 +385,13 @@ SGRayCastCollision2D::SGRayCastCollision2D() {
 }
 
 SGPhysics2DServer::ShapeData::~ShapeData() {
-	memdelete(internal);
+	// Internal shapes and objects come from their own pools, so they're
+	// allocated with new rather than memnew().
+	delete internal;
 }
 
 SGPhysics2DServer::ObjectData::~ObjectData() {
-	memdelete(internal);
+	delete internal;
 }
 
 SGPhysics2DServer::WorldData::~WorldData() {
@@ -257,6 +415,16 @@ void SGPhysics2DServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("polygon_set_points", "shape", "points"), &SGPhysics2DServer::polygon_set_points);
 	ClassDB::bind_method(D_METHOD("polygon_get_points", "shape"), &SGPhysics2DServer::polygon_get_points);
 
+	ClassDB::bind_method(D_METHOD("grid_set_cell_size", "shape", "cell_size"), &SGPhysics2DServer::grid_set_cell_size);
+	ClassDB::bind_method(D_METHOD("grid_get_cell_size", "shape"), &SGPhysics2DServer::grid_get_cell_size);
+	ClassDB::bind_method(D_METHOD("grid_set_size", "shape", "width", "height"), &SGPhysics2DServer::grid_set_size);
+	ClassDB::bind_method(D_METHOD("grid_get_width", "shape"), &SGPhysics2DServer::grid_get_width);
+	ClassDB::bind_method(D_METHOD("grid_get_height", "shape"), &SGPhysics2DServer::grid_get_height);
+	ClassDB::bind_method(D_METHOD("grid_set_cell", "shape", "x", "y", "type"), &SGPhysics2DServer::grid_set_cell);
+	ClassDB::bind_method(D_METHOD("grid_get_cell", "shape", "x", "y"), &SGPhysics2DServer::grid_get_cell);
+	ClassDB::bind_method(D_METHOD("grid_set_cells", "shape", "cells"), &SGPhysics2DServer::grid_set_cells);
+	ClassDB::bind_method(D_METHOD("grid_get_cells", "shape"), &SGPhysics2DServer::grid_get_cells);
+
 	ClassDB::bind_method(D_METHOD("collision_object_create", "object_type", "body_type"), &SGPhysics2DServer::collision_object_create, DEFVAL(BODY_UNKNOWN));
 	ClassDB::bind_method(D_METHOD("collision_object_get_type", "object"), &SGPhysics2DServer::collision_object_get_type);
 	ClassDB::bind_method(D_METHOD("collision_object_set_data", "object", "data"), &SGPhysics2DServer::collision_object_set_data);
@@ -285,12 +453,29 @@ void SGPhysics2DServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_unstuck", "body", "max_attempts"), &SGPhysics2DServer::body_unstuck);
 	ClassDB::bind_method(D_METHOD("body_move_and_collide", "body", "linear_velocity"), &SGPhysics2DServer::body_move_and_collide);
 
-	ClassDB::bind_method(D_METHOD("world_create"), &SGPhysics2DServer::world_create);
+	ClassDB::bind_method(D_METHOD("world_create", "broadphase_type"), &SGPhysics2DServer::world_create, DEFVAL(BROADPHASE_DEFAULT));
+	ClassDB::bind_method(D_METHOD("world_get_broadphase_type", "world"), &SGPhysics2DServer::world_get_broadphase_type);
+	ClassDB::bind_method(D_METHOD("world_set_broadphase_margin", "world", "margin"), &SGPhysics2DServer::world_set_broadphase_margin);
+	ClassDB::bind_method(D_METHOD("world_get_broadphase_margin", "world"), &SGPhysics2DServer::world_get_broadphase_margin);
+	ClassDB::bind_method(D_METHOD("world_set_broadphase_cell_size", "world", "cell_size"), &SGPhysics2DServer::world_set_broadphase_cell_size);
+	ClassDB::bind_method(D_METHOD("world_get_broadphase_cell_size", "world"), &SGPhysics2DServer::world_get_broadphase_cell_size);
+	ClassDB::bind_method(D_METHOD("world_tune_broadphase_cell_size", "world"), &SGPhysics2DServer::world_tune_broadphase_cell_size);
+	ClassDB::bind_method(D_METHOD("world_get_broadphase_statistics", "world"), &SGPhysics2DServer::world_get_broadphase_statistics);
+	ClassDB::bind_method(D_METHOD("world_reset_broadphase_statistics", "world"), &SGPhysics2DServer::world_reset_broadphase_statistics);
+	ClassDB::bind_method(D_METHOD("world_set_narrowphase_type", "world", "narrowphase_type"), &SGPhysics2DServer::world_set_narrowphase_type);
+	ClassDB::bind_method(D_METHOD("world_get_narrowphase_type", "world"), &SGPhysics2DServer::world_get_narrowphase_type);
+	ClassDB::bind_method(D_METHOD("world_pop_overlap_events", "world"), &SGPhysics2DServer::world_pop_overlap_events);
+	ClassDB::bind_method(D_METHOD("world_save_snapshot", "world"), &SGPhysics2DServer::world_save_snapshot);
+	ClassDB::bind_method(D_METHOD("world_load_snapshot", "world", "snapshot"), &SGPhysics2DServer::world_load_snapshot);
+	ClassDB::bind_method(D_METHOD("world_get_state_hash", "world"), &SGPhysics2DServer::world_get_state_hash);
+	ClassDB::bind_method(D_METHOD("world_prepare_for_concurrent_queries", "world"), &SGPhysics2DServer::world_prepare_for_concurrent_queries);
+	ClassDB::bind_method(D_METHOD("world_move_and_slide_bodies", "world", "bodies", "velocities", "up_direction", "max_slides", "floor_max_angle"), &SGPhysics2DServer::world_move_and_slide_bodies, DEFVAL(Variant()), DEFVAL(4), DEFVAL(51471));
 	ClassDB::bind_method(D_METHOD("get_default_world"), &SGPhysics2DServer::get_default_world);
 	ClassDB::bind_method(D_METHOD("world_add_collision_object", "world", "object"), &SGPhysics2DServer::world_add_collision_object);
 	ClassDB::bind_method(D_METHOD("world_remove_collision_object", "world", "object"), &SGPhysics2DServer::world_remove_collision_object);
 
 	ClassDB::bind_method(D_METHOD("world_cast_ray", "world", "start", "cast_to", "collision_mask", "exceptions", "collide_with_areas", "collide_with_bodies"), &SGPhysics2DServer::world_cast_ray, DEFVAL(Array()), DEFVAL(false), DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("world_cast_rays", "world", "starts", "cast_tos", "collision_masks", "exceptions", "collide_with_areas", "collide_with_bodies"), &SGPhysics2DServer::world_cast_rays, DEFVAL(Array()), DEFVAL(false), DEFVAL(true));
 
 	ClassDB::bind_method(D_METHOD("free_rid", "rid"), &SGPhysics2DServer::free_rid);
 
@@ -299,6 +484,11 @@ void SGPhysics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(SHAPE_CIRCLE);
 	BIND_ENUM_CONSTANT(SHAPE_POLYGON);
 	BIND_ENUM_CONSTANT(SHAPE_CAPSULE);
+	BIND_ENUM_CONSTANT(SHAPE_GRID);
+
+	BIND_ENUM_CONSTANT(GRID_CELL_EMPTY);
+	BIND_ENUM_CONSTANT(GRID_CELL_SOLID);
+	BIND_ENUM_CONSTANT(GRID_CELL_ONE_WAY);
 
 	BIND_ENUM_CONSTANT(OBJECT_UNKNOWN);
 	BIND_ENUM_CONSTANT(OBJECT_AREA);
@@ -308,6 +498,19 @@ void SGPhysics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(BODY_UNKNOWN);
 	BIND_ENUM_CONSTANT(BODY_STATIC);
 	BIND_ENUM_CONSTANT(BODY_KINEMATIC);
+
+	BIND_ENUM_CONSTANT(BROADPHASE_DEFAULT);
+	BIND_ENUM_CONSTANT(BROADPHASE_SPATIAL_HASH);
+	BIND_ENUM_CONSTANT(BROADPHASE_AABB_TREE);
+
+	BIND_ENUM_CONSTANT(NARROWPHASE_DEFAULT);
+	BIND_ENUM_CONSTANT(NARROWPHASE_SAT);
+	BIND_ENUM_CONSTANT(NARROWPHASE_GJK);
+
+	BIND_ENUM_CONSTANT(SLIDE_COLLIDED);
+	BIND_ENUM_CONSTANT(SLIDE_ON_FLOOR);
+	BIND_ENUM_CONSTANT(SLIDE_ON_CEILING);
+	BIND_ENUM_CONSTANT(SLIDE_ON_WALL);
 }
 
 SGPhysics2DServer *SGPhysics2DServer::get_singleton() {
@@ -319,18 +522,22 @@ RID SGPhysics2DServer::shape_create(SGPhysics2DServer::ShapeType p_shape_type) {
 	ShapeData *shape = nullptr;
 	switch (p_shape_type) {
 		case SHAPE_RECTANGLE: {
-			shape = memnew(ShapeData(memnew(SGRectangle2DInternal(SGFixedVector2Internal(fixed(655360), fixed(655360))))));
+			shape = memnew(ShapeData(new SGRectangle2DInternal(SGFixedVector2Internal(fixed(655360), fixed(655360)))));
 		} break;
 		case SHAPE_CIRCLE: {
-			shape = memnew(ShapeData(memnew(SGCircle2DInternal(fixed(655360)))));
+			shape = memnew(ShapeData(new SGCircle2DInternal(fixed(655360))));
 		}
 		break;
 		case SHAPE_CAPSULE: {
-			shape = memnew(ShapeData(memnew(SGCapsule2DInternal(fixed(655360), fixed(655360)))));
+			shape = memnew(ShapeData(new SGCapsule2DInternal(fixed(655360), fixed(655360))));
 		}
 		break;
 		case SHAPE_POLYGON: {
-			shape = memnew(ShapeData(memnew(SGPolygon2DInternal)));
+			shape = memnew(ShapeData(new SGPolygon2DInternal()));
+		}
+		break;
+		case SHAPE_GRID: {
+			shape = memnew(ShapeData(new SGGrid2DInternal(SGFixedVector2Internal(fixed(1048576), fixed(1048576)))));
 		}
 		break;
 		default:
@@ -453,7 +660,7 @@ Array SGPhysics2DServer::polygon_get_points(RID p_shape) const {
 	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_POLYGON, Array());
 
 	Array ret;
-	std::vector<SGFixedVector2Internal> points = ((SGPolygon2DInternal *)data->get_internal())->get_points();
+	const std::vector<SGFixedVector2Internal> &points = ((SGPolygon2DInternal *)data->get_internal())->get_points();
 	ret.resize(points.size());
 	for (std::size_t i = 0; i < points.size(); i++) {
 		ret.set(i, SGFixedVector2::from_internal(points[i]));
@@ -461,16 +668,110 @@ Array SGPhysics2DServer::polygon_get_points(RID p_shape) const {
 	return ret;
 }
 
+void SGPhysics2DServer::grid_set_cell_size(RID p_shape, const Ref<SGFixedVector2> &p_cell_size) {
+	ERR_FAIL_COND(p_cell_size.is_null());
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND(!data);
+	ERR_FAIL_COND(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	ERR_FAIL_COND_MSG(p_cell_size->get_x() <= 0 || p_cell_size->get_y() <= 0, "Cell size must be positive");
+	grid->set_cell_size(p_cell_size->get_internal());
+}
+
+Ref<SGFixedVector2> SGPhysics2DServer::grid_get_cell_size(RID p_shape) const {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!data, Ref<SGFixedVector2>());
+	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID, Ref<SGFixedVector2>());
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	return SGFixedVector2::from_internal(grid->get_cell_size());
+}
+
+void SGPhysics2DServer::grid_set_size(RID p_shape, int p_width, int p_height) {
+	ERR_FAIL_COND(p_width < 0 || p_height < 0);
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND(!data);
+	ERR_FAIL_COND(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	grid->set_size(p_width, p_height);
+}
+
+int SGPhysics2DServer::grid_get_width(RID p_shape) const {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!data, 0);
+	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID, 0);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	return grid->get_width();
+}
+
+int SGPhysics2DServer::grid_get_height(RID p_shape) const {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!data, 0);
+	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID, 0);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	return grid->get_height();
+}
+
+void SGPhysics2DServer::grid_set_cell(RID p_shape, int p_x, int p_y, SGPhysics2DServer::GridCellType p_type) {
+	ERR_FAIL_INDEX(p_type, GRID_CELL_ONE_WAY + 1);
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND(!data);
+	ERR_FAIL_COND(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	grid->set_cell(p_x, p_y, (SGGrid2DInternal::CellType)p_type);
+}
+
+SGPhysics2DServer::GridCellType SGPhysics2DServer::grid_get_cell(RID p_shape, int p_x, int p_y) const {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!data, GRID_CELL_EMPTY);
+	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID, GRID_CELL_EMPTY);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	return (GridCellType)grid->get_cell(p_x, p_y);
+}
+
+void SGPhysics2DServer::grid_set_cells(RID p_shape, const PoolByteArray &p_cells) {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND(!data);
+	ERR_FAIL_COND(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID);
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	int width = grid->get_width();
+	int height = grid->get_height();
+	ERR_FAIL_COND_MSG(p_cells.size() != width * height, "Expected one byte per cell");
+
+	PoolByteArray::Read r = p_cells.read();
+	grid->set_cells(r.ptr());
+}
+
+PoolByteArray SGPhysics2DServer::grid_get_cells(RID p_shape) const {
+	ShapeData *data = shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!data, PoolByteArray());
+	ERR_FAIL_COND_V(data->get_internal()->get_shape_type() != SGShape2DInternal::SHAPE_GRID, PoolByteArray());
+	SGGrid2DInternal *grid = (SGGrid2DInternal *)data->get_internal();
+	int width = grid->get_width();
+	int height = grid->get_height();
+
+	PoolByteArray ret;
+	ret.resize(width * height);
+	{
+		PoolByteArray::Write w = ret.write();
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				w[y * width + x] = grid->get_cell(x, y);
+			}
+		}
+	}
+	return ret;
+}
+
 RID SGPhysics2DServer::collision_object_create(SGPhysics2DServer::CollisionObjectType p_object_type, SGPhysics2DServer::BodyType p_body_type) {
 	ERR_FAIL_COND_V(p_object_type == OBJECT_BOTH, RID());
 	ERR_FAIL_COND_V(p_object_type == OBJECT_BODY && p_body_type == BODY_UNKNOWN, RID());
 	ObjectData *data = nullptr;
 	switch (p_object_type) {
 		case OBJECT_AREA: {
-			data = memnew(ObjectData(memnew(SGArea2DInternal())));
+			data = memnew(ObjectData(new SGArea2DInternal()));
 		} break;
 		case OBJECT_BODY: {
-			data = memnew(ObjectData(memnew(SGBody2DInternal((SGBody2DInternal::BodyType)p_body_type))));
+			data = memnew(ObjectData(new SGBody2DInternal((SGBody2DInternal::BodyType)p_body_type)));
 		} break;
 		default:
 			ERR_FAIL_V_MSG(RID(), "Unknown collision object type");
@@ -598,7 +899,7 @@ public:
 	}
 };
 
-Array SGPhysics2DServer::area_get_overlapping_areas(RID p_area) const {
+Array SGPhysics2DServer::area_get_overlapping_areas(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, Array());
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, Array());
@@ -607,11 +908,11 @@ Array SGPhysics2DServer::area_get_overlapping_areas(RID p_area) const {
 	ERR_FAIL_COND_V(!internal->get_world(), Array());
 
 	SGSortedArrayResultHandler result_handler;
-	internal->get_world()->get_overlapping_areas(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_areas(internal, &result_handler);
 	return result_handler.get_array();
 }
 
-Array SGPhysics2DServer::area_get_overlapping_bodies(RID p_area) const {
+Array SGPhysics2DServer::area_get_overlapping_bodies(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, Array());
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, Array());
@@ -620,7 +921,7 @@ Array SGPhysics2DServer::area_get_overlapping_bodies(RID p_area) const {
 	ERR_FAIL_COND_V(!internal->get_world(), Array());
 
 	SGSortedArrayResultHandler result_handler;
-	internal->get_world()->get_overlapping_bodies(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_bodies(internal, &result_handler);
 	return result_handler.get_array();
 }
 
@@ -656,7 +957,7 @@ public:
 	}
 };
 
-Array SGPhysics2DServer::area_get_overlapping_area_collisions(RID p_area) const {
+Array SGPhysics2DServer::area_get_overlapping_area_collisions(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, Array());
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, Array());
@@ -665,11 +966,11 @@ Array SGPhysics2DServer::area_get_overlapping_area_collisions(RID p_area) const
 	ERR_FAIL_COND_V(!internal->get_world(), Array());
 
 	SGSortedCollisionArrayResultHandler result_handler;
-	internal->get_world()->get_overlapping_areas(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_areas(internal, &result_handler);
 	return result_handler.get_array();
 }
 
-Array SGPhysics2DServer::area_get_overlapping_body_collisions(RID p_area) const {
+Array SGPhysics2DServer::area_get_overlapping_body_collisions(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, Array());
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, Array());
@@ -678,7 +979,7 @@ Array SGPhysics2DServer::area_get_overlapping_body_collisions(RID p_area) const
 	ERR_FAIL_COND_V(!internal->get_world(), Array());
 
 	SGSortedCollisionArrayResultHandler result_handler;
-	internal->get_world()->get_overlapping_bodies(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_bodies(internal, &result_handler);
 	return result_handler.get_array();
 }
 
@@ -697,7 +998,7 @@ public:
 	}
 };
 
-int SGPhysics2DServer::area_get_overlapping_area_count(RID p_area) const {
+int SGPhysics2DServer::area_get_overlapping_area_count(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, 0);
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, 0);
@@ -706,11 +1007,11 @@ int SGPhysics2DServer::area_get_overlapping_area_count(RID p_area) const {
 	ERR_FAIL_COND_V(!internal->get_world(), 0);
 
 	SGCountResultHandler result_handler;
-	internal->get_world()->get_overlapping_areas(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_areas(internal, &result_handler);
 	return result_handler.get_count();
 }
 
-int SGPhysics2DServer::area_get_overlapping_body_count(RID p_area) const {
+int SGPhysics2DServer::area_get_overlapping_body_count(RID p_area) {
 	ObjectData *data = object_owner.get(p_area);
 	ERR_FAIL_COND_V(!data, 0);
 	ERR_FAIL_COND_V(data->get_internal()->get_object_type() != SGCollisionObject2DInternal::OBJECT_AREA, 0);
@@ -719,7 +1020,7 @@ int SGPhysics2DServer::area_get_overlapping_body_count(RID p_area) const {
 	ERR_FAIL_COND_V(!internal->get_world(), 0);
 
 	SGCountResultHandler result_handler;
-	internal->get_world()->get_overlapping_bodies(internal, &result_handler);
+	internal->get_world()->get_cached_overlapping_bodies(internal, &result_handler);
 	return result_handler.get_count();
 }
 
@@ -765,30 +1066,277 @@ Ref<SGKinematicCollision2D> SGPhysics2DServer::body_move_and_collide(RID p_body,
 
 	SGWorld2DInternal::BodyCollisionInfo collision;
 	if (internal->get_world()->move_and_collide(internal, p_linear_velocity->get_internal(), &collision)) {
-		SGInternalData *object_data = (SGInternalData *)collision.collider->get_data();
-		SGCollisionObject2D *object = Object::cast_to<SGCollisionObject2D>(object_data->get_object());
-		Ref<SGKinematicCollision2D> result = Ref<SGKinematicCollision2D>(memnew(SGKinematicCollision2D(
-			object,
-			object_data->rid,
-			SGFixedVector2::from_internal(collision.normal),
-			SGFixedVector2::from_internal(collision.remainder)
-		)));
-		return result;
+		return kinematic_collision_from_internal(collision.collider, collision.normal, collision.remainder);
 	}
 
 	return Ref<SGKinematicCollision2D>();
 }
 
-RID SGPhysics2DServer::world_create() {
+static SGWorld2DInternal::NarrowphaseType sg_get_default_narrowphase_type() {
+	if (ProjectSettings::get_singleton()->has_setting("physics/2d/narrowphase")) {
+		int narrowphase_type = ProjectSettings::get_singleton()->get_setting("physics/2d/narrowphase");
+		if (narrowphase_type == SGPhysics2DServer::NARROWPHASE_GJK) {
+			return SGWorld2DInternal::NARROWPHASE_GJK;
+		}
+	}
+	return SGWorld2DInternal::NARROWPHASE_SAT;
+}
+
+RID SGPhysics2DServer::world_create(SGPhysics2DServer::BroadphaseType p_broadphase_type) {
 	int cell_size = 128;
 	if (ProjectSettings::get_singleton()->has_setting("physics/2d/cell_size")) {
 		cell_size = ProjectSettings::get_singleton()->get_setting("physics/2d/cell_size");
 	}
 
-	WorldData *data = memnew(WorldData(memnew(SGWorld2DInternal(cell_size, &sg_compare_collision_objects))));
+	if (p_broadphase_type == BROADPHASE_DEFAULT) {
+		p_broadphase_type = BROADPHASE_SPATIAL_HASH;
+		if (ProjectSettings::get_singleton()->has_setting("physics/2d/broadphase")) {
+			p_broadphase_type = (SGPhysics2DServer::BroadphaseType)(int)ProjectSettings::get_singleton()->get_setting("physics/2d/broadphase");
+		}
+	}
+	ERR_FAIL_COND_V(p_broadphase_type != BROADPHASE_SPATIAL_HASH && p_broadphase_type != BROADPHASE_AABB_TREE, RID());
+
+	WorldData *data = memnew(WorldData(memnew(SGWorld2DInternal(cell_size, &sg_compare_collision_objects, (SGBroadphase2DInternal::BroadphaseType)p_broadphase_type))));
+	if (ProjectSettings::get_singleton()->has_setting("physics/2d/broadphase_margin")) {
+		data->get_internal()->set_broadphase_margin(fixed((int64_t)ProjectSettings::get_singleton()->get_setting("physics/2d/broadphase_margin")));
+	}
+	data->get_internal()->set_narrowphase_type(sg_get_default_narrowphase_type());
 	return world_owner.make_rid(data);
 }
 
+SGPhysics2DServer::BroadphaseType SGPhysics2DServer::world_get_broadphase_type(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, BROADPHASE_DEFAULT);
+	return (SGPhysics2DServer::BroadphaseType)world_data->get_internal()->get_broadphase()->get_broadphase_type();
+}
+
+void SGPhysics2DServer::world_set_broadphase_margin(RID p_world, int64_t p_margin) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND(!world_data);
+	ERR_FAIL_COND(p_margin < 0);
+	world_data->get_internal()->set_broadphase_margin(fixed(p_margin));
+}
+
+int64_t SGPhysics2DServer::world_get_broadphase_margin(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, 0);
+	return world_data->get_internal()->get_broadphase_margin().value;
+}
+
+void SGPhysics2DServer::world_set_broadphase_cell_size(RID p_world, int p_cell_size) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND(!world_data);
+	ERR_FAIL_COND_MSG(p_cell_size <= 0, "Cell size must be positive");
+	world_data->get_internal()->set_broadphase_cell_size(p_cell_size);
+}
+
+int SGPhysics2DServer::world_get_broadphase_cell_size(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, 0);
+	return world_data->get_internal()->get_broadphase_cell_size();
+}
+
+int SGPhysics2DServer::world_tune_broadphase_cell_size(RID p_world) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, 0);
+	return world_data->get_internal()->tune_broadphase_cell_size();
+}
+
+Dictionary SGPhysics2DServer::world_get_broadphase_statistics(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, Dictionary());
+	SGWorld2DInternal *world = world_data->get_internal();
+
+	SGBroadphase2DInternal::Statistics statistics;
+	world->get_broadphase()->get_statistics(statistics);
+	SGBroadphase2DInternal::Statistics static_statistics;
+	world->get_static_broadphase()->get_statistics(static_statistics);
+
+	// The averages are only for looking at, so it's fine for them to be floats.
+	Dictionary ret;
+	ret["cell_size"] = world->get_broadphase_cell_size();
+	ret["element_count"] = statistics.element_count;
+	ret["cell_count"] = statistics.cell_count;
+	ret["cells_per_element"] = statistics.element_count > 0 ? (double)statistics.cell_entry_count / statistics.element_count : 0.0;
+	ret["elements_per_cell"] = statistics.cell_count > 0 ? (double)statistics.cell_entry_count / statistics.cell_count : 0.0;
+	ret["query_count"] = (int64_t)statistics.query_count;
+	ret["query_candidate_count"] = (int64_t)statistics.query_candidate_count;
+	ret["candidates_per_query"] = statistics.query_count > 0 ? (double)statistics.query_candidate_count / statistics.query_count : 0.0;
+	ret["static_element_count"] = static_statistics.element_count;
+	ret["static_query_count"] = (int64_t)static_statistics.query_count;
+	ret["static_query_candidate_count"] = (int64_t)static_statistics.query_candidate_count;
+	return ret;
+}
+
+void SGPhysics2DServer::world_reset_broadphase_statistics(RID p_world) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND(!world_data);
+	world_data->get_internal()->reset_broadphase_statistics();
+}
+
+void SGPhysics2DServer::world_set_narrowphase_type(RID p_world, NarrowphaseType p_narrowphase_type) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND(!world_data);
+	ERR_FAIL_COND(p_narrowphase_type != NARROWPHASE_DEFAULT && p_narrowphase_type != NARROWPHASE_SAT && p_narrowphase_type != NARROWPHASE_GJK);
+	if (p_narrowphase_type == NARROWPHASE_DEFAULT) {
+		world_data->get_internal()->set_narrowphase_type(sg_get_default_narrowphase_type());
+	}
+	else {
+		world_data->get_internal()->set_narrowphase_type((SGWorld2DInternal::NarrowphaseType)p_narrowphase_type);
+	}
+}
+
+SGPhysics2DServer::NarrowphaseType SGPhysics2DServer::world_get_narrowphase_type(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, NARROWPHASE_DEFAULT);
+	return (SGPhysics2DServer::NarrowphaseType)world_data->get_internal()->get_narrowphase_type();
+}
+
+Array SGPhysics2DServer::world_pop_overlap_events(RID p_world) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, Array());
+	SGWorld2DInternal *world = world_data->get_internal();
+
+	std::vector<SGWorld2DInternal::OverlapEvent> events;
+	world->take_overlap_events(events);
+
+	Array ret;
+	for (const SGWorld2DInternal::OverlapEvent &event : events) {
+		SGInternalData *area_data = (SGInternalData *)event.area->get_data();
+		SGInternalData *object_data = (SGInternalData *)event.object->get_data();
+		ret.push_back(memnew(SGAreaOverlapEvent2D(
+			event.begin ? SGAreaOverlapEvent2D::OVERLAP_BEGIN : SGAreaOverlapEvent2D::OVERLAP_END,
+			Object::cast_to<SGCollisionObject2D>(area_data->get_object()),
+			area_data->rid,
+			Object::cast_to<SGCollisionObject2D>(object_data->get_object()),
+			object_data->rid
+		)));
+	}
+
+	return ret;
+}
+
+PoolByteArray SGPhysics2DServer::world_save_snapshot(RID p_world) const {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, PoolByteArray());
+	SGWorld2DInternal *world = world_data->get_internal();
+
+	std::vector<int64_t> snapshot;
+	world->save_snapshot(snapshot);
+
+	PoolByteArray ret;
+	ret.resize(snapshot.size() * sizeof(int64_t));
+	PoolByteArray::Write w = ret.write();
+	memcpy(w.ptr(), snapshot.data(), ret.size());
+	return ret;
+}
+
+bool SGPhysics2DServer::world_load_snapshot(RID p_world, const PoolByteArray &p_snapshot) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, false);
+	SGWorld2DInternal *world = world_data->get_internal();
+	ERR_FAIL_COND_V(p_snapshot.size() % sizeof(int64_t) != 0, false);
+
+	// Copy into a properly aligned buffer.
+	std::vector<int64_t> snapshot(p_snapshot.size() / sizeof(int64_t));
+	PoolByteArray::Read r = p_snapshot.read();
+	memcpy(snapshot.data(), r.ptr(), p_snapshot.size());
+
+	bool loaded = world->load_snapshot(snapshot.data(), snapshot.size());
+	ERR_FAIL_COND_V_MSG(!loaded, false, "Snapshot doesn't match the objects in this world.");
+	return true;
+}
+
+int64_t SGPhysics2DServer::world_get_state_hash(RID p_world) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, 0);
+	SGWorld2DInternal *world = world_data->get_internal();
+	return (int64_t)world->get_state_hash();
+}
+
+void SGPhysics2DServer::world_prepare_for_concurrent_queries(RID p_world) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND(!world_data);
+	world_data->get_internal()->prepare_for_concurrent_queries();
+}
+
+Dictionary SGPhysics2DServer::world_move_and_slide_bodies(RID p_world, const Array &p_bodies, const Array &p_velocities, const Ref<SGFixedVector2> &p_up_direction, int p_max_slides, int64_t p_floor_max_angle) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, Dictionary());
+	SGWorld2DInternal *world = world_data->get_internal();
+	ERR_FAIL_COND_V(p_max_slides < 0, Dictionary());
+
+	int count = p_bodies.size();
+	ERR_FAIL_COND_V(p_velocities.size() != count * 2, Dictionary());
+
+	// Validate everything up front, so that we don't move some of the bodies
+	// and then bail part way through.
+	std::vector<SGBody2DInternal *> bodies;
+	bodies.reserve(count);
+	for (int i = 0; i < count; i++) {
+		ObjectData *object_data = object_owner.get(p_bodies[i]);
+		ERR_FAIL_COND_V(!object_data, Dictionary());
+		SGCollisionObject2DInternal *object = object_data->get_internal();
+		ERR_FAIL_COND_V(object->get_object_type() != SGCollisionObject2DInternal::OBJECT_BODY, Dictionary());
+		ERR_FAIL_COND_V(object->get_world() != world, Dictionary());
+		bodies.push_back((SGBody2DInternal *)object);
+	}
+
+	SGFixedVector2Internal up_direction;
+	if (p_up_direction.is_valid()) {
+		up_direction = p_up_direction->get_internal();
+	}
+	fixed floor_max_angle = fixed(p_floor_max_angle);
+
+	// PoolIntArray only holds 32-bit integers, so we use plain Arrays.
+	Array positions;
+	Array velocities;
+	Array floor_normals;
+	Array flags;
+	positions.resize(count * 2);
+	velocities.resize(count * 2);
+	floor_normals.resize(count * 2);
+	flags.resize(count);
+
+	// Bodies are moved one after another in the order given, so each one sees
+	// where the bodies before it ended up.
+	for (int i = 0; i < count; i++) {
+		SGBody2DInternal *body = bodies[i];
+		SGFixedVector2Internal velocity(fixed((int64_t)p_velocities[i * 2]), fixed((int64_t)p_velocities[i * 2 + 1]));
+
+		SGWorld2DInternal::BodySlideInfo info;
+		int32_t body_flags = 0;
+		if (world->move_and_slide(body, velocity, up_direction, p_max_slides, floor_max_angle, &info)) {
+			body_flags |= SLIDE_COLLIDED;
+		}
+		if (info.on_floor) {
+			body_flags |= SLIDE_ON_FLOOR;
+		}
+		if (info.on_ceiling) {
+			body_flags |= SLIDE_ON_CEILING;
+		}
+		if (info.on_wall) {
+			body_flags |= SLIDE_ON_WALL;
+		}
+
+		SGFixedVector2Internal position = body->get_transform().get_origin();
+		positions[i * 2] = position.x.value;
+		positions[i * 2 + 1] = position.y.value;
+		velocities[i * 2] = info.velocity.x.value;
+		velocities[i * 2 + 1] = info.velocity.y.value;
+		floor_normals[i * 2] = info.floor_normal.x.value;
+		floor_normals[i * 2 + 1] = info.floor_normal.y.value;
+		flags[i] = body_flags;
+	}
+
+	Dictionary ret;
+	ret["positions"] = positions;
+	ret["velocities"] = velocities;
+	ret["floor_normals"] = floor_normals;
+	ret["flags"] = flags;
+	return ret;
+}
+
 RID SGPhysics2DServer::get_default_world() {
 	return default_world;
 }
@@ -853,6 +1401,90 @@ Ref<SGRayCastCollision2D> SGPhysics2DServer::world_cast_ray(RID p_world, const R
 	return ret;
 }
 
+Dictionary SGPhysics2DServer::world_cast_rays(RID p_world, const Array &p_starts, const Array &p_cast_tos, const PoolIntArray &p_collision_masks, Array p_exceptions, bool p_collide_with_areas, bool p_collide_with_bodies) {
+	WorldData *world_data = world_owner.get(p_world);
+	ERR_FAIL_COND_V(!world_data, Dictionary());
+	SGWorld2DInternal *internal = world_data->get_internal();
+
+	int count = p_starts.size() / 2;
+	ERR_FAIL_COND_V(p_starts.size() != count * 2, Dictionary());
+	ERR_FAIL_COND_V(p_cast_tos.size() != count * 2, Dictionary());
+	ERR_FAIL_COND_V(p_collision_masks.size() != count && p_collision_masks.size() != 1, Dictionary());
+
+	SGRayCastBatch batch;
+	batch.world = internal;
+	batch.collide_with_areas = p_collide_with_areas;
+	batch.collide_with_bodies = p_collide_with_bodies;
+	batch.starts.resize(count);
+	batch.cast_tos.resize(count);
+	batch.collision_masks.resize(count);
+	batch.results.resize(count);
+
+	PoolIntArray::Read collision_masks = p_collision_masks.read();
+	for (int i = 0; i < count; i++) {
+		batch.starts[i] = SGFixedVector2Internal(fixed((int64_t)p_starts[i * 2]), fixed((int64_t)p_starts[i * 2 + 1]));
+		batch.cast_tos[i] = SGFixedVector2Internal(fixed((int64_t)p_cast_tos[i * 2]), fixed((int64_t)p_cast_tos[i * 2 + 1]));
+		batch.collision_masks[i] = (uint32_t)collision_masks[p_collision_masks.size() == 1 ? 0 : i];
+	}
+
+	for (int i = 0; i < p_exceptions.size(); i++) {
+		SGCollisionObject2D *object = Object::cast_to<SGCollisionObject2D>(p_exceptions[i]);
+		if (object) {
+			batch.exceptions.insert(collision_object_get_internal(object->get_rid()));
+		}
+	}
+
+	int chunk_count = (count + SG_RAY_CAST_BATCH_CHUNK_SIZE - 1) / SG_RAY_CAST_BATCH_CHUNK_SIZE;
+	int processor_count = OS::get_singleton()->get_processor_count();
+	if (chunk_count > 1 && processor_count > 1) {
+		bool running = false;
+		ERR_FAIL_COND_V_MSG(!ray_cast_running.compare_exchange_strong(running, true), Dictionary(), "Can't cast a batch of rays while another batch is running.");
+
+		// The workers are only started once they're first needed.
+		if (!ray_cast_thread_pool) {
+			ray_cast_thread_pool = memnew(SGRayCastThreadPool(processor_count - 1));
+		}
+
+		internal->prepare_for_concurrent_queries();
+		ray_cast_thread_pool->cast(&batch, chunk_count);
+		ray_cast_running.store(false);
+	}
+	else {
+		for (int chunk = 0; chunk < chunk_count; chunk++) {
+			batch.cast_chunk(chunk);
+		}
+	}
+
+	// PoolIntArray only holds 32-bit integers, so we use plain Arrays.
+	Array colliders;
+	Array points;
+	Array normals;
+	colliders.resize(count);
+	points.resize(count * 2);
+	normals.resize(count * 2);
+
+	for (int i = 0; i < count; i++) {
+		const SGWorld2DInternal::RayCastInfo &info = batch.results[i];
+		if (info.body) {
+			SGInternalData *object_data = (SGInternalData *)info.body->get_data();
+			colliders[i] = object_data->rid;
+		}
+		else {
+			colliders[i] = RID();
+		}
+		points[i * 2] = info.collision_point.x.value;
+		points[i * 2 + 1] = info.collision_point.y.value;
+		normals[i * 2] = info.collision_normal.x.value;
+		normals[i * 2 + 1] = info.collision_normal.y.value;
+	}
+
+	Dictionary ret;
+	ret["colliders"] = colliders;
+	ret["points"] = points;
+	ret["normals"] = normals;
+	return ret;
+}
+
 void SGPhysics2DServer::free_rid(RID p_rid) {
 	if (shape_owner.owns(p_rid)) {
 		ShapeData *shape_data = shape_owner.get(p_rid);
@@ -910,6 +1542,17 @@ SGWorld2DInternal *SGPhysics2DServer::get_default_world_internal() {
 	return world_get_internal(default_world);
 }
 
+Ref<SGKinematicCollision2D> SGPhysics2DServer::kinematic_collision_from_internal(SGCollisionObject2DInternal *p_collider, const SGFixedVector2Internal &p_normal, const SGFixedVector2Internal &p_remainder) const {
+	SGInternalData *object_data = (SGInternalData *)p_collider->get_data();
+	SGCollisionObject2D *object = Object::cast_to<SGCollisionObject2D>(object_data->get_object());
+	return Ref<SGKinematicCollision2D>(memnew(SGKinematicCollision2D(
+		object,
+		object_data->rid,
+		SGFixedVector2::from_internal(p_normal),
+		SGFixedVector2::from_internal(p_remainder)
+	)));
+}
+
 SGPhysics2DServer::SGPhysics2DServer() {
 	singleton = this;
 	default_world = world_create();
@@ -918,6 +1561,10 @@ SGPhysics2DServer::SGPhysics2DServer() {
 SGPhysics2DServer::~SGPhysics2DServer() {
 	singleton = nullptr;
 
+	if (ray_cast_thread_pool) {
+		memdelete(ray_cast_thread_pool);
+	}
+
 	WorldData *default_world_data = world_owner.get(default_world);
 	world_owner.free(default_world);
 	memdelete(default_world_data);
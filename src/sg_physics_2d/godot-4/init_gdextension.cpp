@@ -40,6 +40,7 @@
 #include "./scene/2d/sg_ray_cast_2d.h"
 #include "./scene/2d/sg_collision_shape_2d.h"
 #include "./scene/2d/sg_collision_polygon_2d.h"
+#include "./scene/2d/sg_collision_grid_2d.h"
 #include "./scene/resources/sg_shapes_2d.h"
 #include "./servers/sg_physics_2d_server.h"
 #include "../internal/sg_world_2d_internal.h"
@@ -67,6 +68,7 @@ void register_sg_physics_2d_extension_types(ModuleInitializationLevel p_level) {
 		GDREGISTER_VIRTUAL_CLASS(SGCollisionObject2D);
 		GDREGISTER_CLASS(SGArea2D);
 		GDREGISTER_CLASS(SGAreaCollision2D);
+		GDREGISTER_CLASS(SGAreaOverlapEvent2D);
 		GDREGISTER_CLASS(SGPhysicsBody2D);
 		GDREGISTER_CLASS(SGStaticBody2D);
 		GDREGISTER_CLASS(SGCharacterBody2D);
@@ -76,6 +78,7 @@ void register_sg_physics_2d_extension_types(ModuleInitializationLevel p_level) {
 
 		GDREGISTER_CLASS(SGCollisionShape2D);
 		GDREGISTER_CLASS(SGCollisionPolygon2D);
+		GDREGISTER_CLASS(SGCollisionGrid2D);
 
 		GDREGISTER_VIRTUAL_CLASS(SGShape2D);
 		GDREGISTER_CLASS(SGRectangleShape2D);
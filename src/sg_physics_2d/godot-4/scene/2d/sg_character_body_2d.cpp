@@ -150,72 +150,34 @@ Ref<SGKinematicCollision2D> SGCharacterBody2D::get_last_slide_collision() {
 bool SGCharacterBody2D::move_and_slide() {
 	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
 
-	SGFixedVector2Internal motion_internal = velocity->get_internal();
-	SGFixedVector2Internal body_velocity = motion_internal;
-	SGFixedVector2Internal up_direction_internal = up_direction->get_internal();
-
 	slide_colliders.clear();
 	floor_normal->clear();
 	on_floor = false;
 	on_ceiling = false;
 	on_wall = false;
 
-	Ref<SGFixedVector2> motion;
-	motion.instantiate();
-
-	bool collided = false;
-	int64_t remaining_slides = max_slides;
-	while (remaining_slides) {
-		motion->set_internal(motion_internal);
-		Ref<SGKinematicCollision2D> collision = physics_server->body_move_and_collide(rid, motion);
-		if (collision.is_null()) {
-			// No collision, so we're good - bail!
-			break;
-		}
-		collided = true;
-
-		SGFixedVector2Internal collision_normal = collision->get_normal()->get_internal();
-		SGFixedVector2Internal collision_remainder = collision->get_remainder()->get_internal();
-
-		if (collision_normal == SGFixedVector2Internal::ZERO) {
-			// This means we couldn't unstuck the body. Clear out the motion
-			// vector and bail.
-			body_velocity = SGFixedVector2Internal::ZERO;
-			break;
-		}
-
-		slide_colliders.push_back(collision);
-
-		if (up_direction_internal == SGFixedVector2Internal::ZERO) {
-			// All is wall!
-			on_wall = true;
-		}
-		else {
-			if (collision_normal.dot(up_direction_internal).acos() <= floor_max_angle) {
-				on_floor = true;
-				floor_normal->set_internal(collision_normal);
-			} else if (collision_normal.dot(-up_direction_internal).acos() <= floor_max_angle) {
-				on_ceiling = true;
-			} else {
-				on_wall = true;
-			}
-		}
-
-		motion_internal = collision_remainder.slide(collision_normal);
-		body_velocity = body_velocity.slide(collision_normal);
-
-		if (motion_internal == SGFixedVector2Internal::ZERO) {
-			// No remaining motion, so we're good - bail!
-			break;
-		}
-
-		remaining_slides--;
+	SGBody2DInternal *body = (SGBody2DInternal *)physics_server->collision_object_get_internal(rid);
+	ERR_FAIL_COND_V(!body->get_world(), false);
+
+	SGWorld2DInternal::BodySlideInfo info;
+	std::vector<SGWorld2DInternal::BodyCollisionInfo> collisions;
+	bool collided = body->get_world()->move_and_slide(body, velocity->get_internal(), up_direction->get_internal(), max_slides, floor_max_angle, &info, &collisions);
+
+	for (const SGWorld2DInternal::BodyCollisionInfo &collision : collisions) {
+		slide_colliders.push_back(physics_server->kinematic_collision_from_internal(collision.collider, collision.normal, collision.remainder));
+	}
+
+	on_floor = info.on_floor;
+	on_ceiling = info.on_ceiling;
+	on_wall = info.on_wall;
+	if (on_floor) {
+		floor_normal->set_internal(info.floor_normal);
 	}
 
 	// Sync only position from physics server to prevent precision loss.
-	set_global_fixed_position_internal(physics_server->collision_object_get_internal(rid)->get_transform().get_origin());
+	set_global_fixed_position_internal(body->get_transform().get_origin());
 
-	velocity->set_internal(body_velocity);
+	velocity->set_internal(info.velocity);
 
 	return collided;
 }
@@ -0,0 +1,248 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_collision_grid_2d.h"
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include "sg_collision_object_2d.h"
+
+void SGCollisionGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_disabled", "disabled"), &SGCollisionGrid2D::set_disabled);
+	ClassDB::bind_method(D_METHOD("get_disabled"), &SGCollisionGrid2D::get_disabled);
+
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &SGCollisionGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &SGCollisionGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("_get_cell_size_x"), &SGCollisionGrid2D::_get_cell_size_x);
+	ClassDB::bind_method(D_METHOD("_set_cell_size_x", "x"), &SGCollisionGrid2D::_set_cell_size_x);
+	ClassDB::bind_method(D_METHOD("_get_cell_size_y"), &SGCollisionGrid2D::_get_cell_size_y);
+	ClassDB::bind_method(D_METHOD("_set_cell_size_y", "y"), &SGCollisionGrid2D::_set_cell_size_y);
+
+	ClassDB::bind_method(D_METHOD("set_grid_width", "width"), &SGCollisionGrid2D::set_grid_width);
+	ClassDB::bind_method(D_METHOD("get_grid_width"), &SGCollisionGrid2D::get_grid_width);
+	ClassDB::bind_method(D_METHOD("set_grid_height", "height"), &SGCollisionGrid2D::set_grid_height);
+	ClassDB::bind_method(D_METHOD("get_grid_height"), &SGCollisionGrid2D::get_grid_height);
+
+	ClassDB::bind_method(D_METHOD("set_cell", "x", "y", "type"), &SGCollisionGrid2D::set_cell);
+	ClassDB::bind_method(D_METHOD("get_cell", "x", "y"), &SGCollisionGrid2D::get_cell);
+
+	ClassDB::bind_method(D_METHOD("set_cells", "cells"), &SGCollisionGrid2D::set_cells);
+	ClassDB::bind_method(D_METHOD("get_cells"), &SGCollisionGrid2D::get_cells);
+
+	ClassDB::bind_method(D_METHOD("set_debug_color", "debug_color"), &SGCollisionGrid2D::set_debug_color);
+	ClassDB::bind_method(D_METHOD("get_debug_color"), &SGCollisionGrid2D::get_debug_color);
+
+	ClassDB::bind_method(D_METHOD("get_rid"), &SGCollisionGrid2D::get_rid);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_size_x"), "_set_cell_size_x", "_get_cell_size_x");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_size_y"), "_set_cell_size_y", "_get_cell_size_y");
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "cell_size", PROPERTY_HINT_NONE, "", 0), "set_cell_size", "get_cell_size");
+	// The size has to be loaded before the cells.
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_width"), "set_grid_width", "get_grid_width");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_height"), "set_grid_height", "get_grid_height");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "cells", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_cells", "get_cells");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "disabled"), "set_disabled", "get_disabled");
+	ADD_PROPERTY(PropertyInfo(Variant::COLOR, "debug_color"), "set_debug_color", "get_debug_color");
+}
+
+void SGCollisionGrid2D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_DRAW: {
+			if (!Engine::get_singleton()->is_editor_hint() && !get_tree()->is_debugging_collisions_hint()) {
+				break;
+			}
+
+			SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+			int width = physics_server->grid_get_width(rid);
+			int height = physics_server->grid_get_height(rid);
+			// Fetch all the cells at once, rather than going through the server
+			// for every cell.
+			PackedByteArray cells = physics_server->grid_get_cells(rid);
+			ERR_FAIL_COND(cells.size() != width * height);
+			const uint8_t *r = cells.ptr();
+			Vector2 cell_size = get_cell_size()->to_float();
+
+			draw_rect(Rect2(Vector2(), cell_size * Vector2(width, height)), Color(0.9, 0.2, 0.0, 0.8), false);
+
+			// Draw runs of solid cells as a single rectangle, and one-way cells
+			// as a line along their top.
+			for (int y = 0; y < height; y++) {
+				int x = 0;
+				while (x < width) {
+					uint8_t type = r[y * width + x];
+					int end = x + 1;
+					while (end < width && r[y * width + end] == type) {
+						end++;
+					}
+					Vector2 from = cell_size * Vector2(x, y);
+					Vector2 to = cell_size * Vector2(end, y);
+					if (type == SGPhysics2DServer::GRID_CELL_SOLID) {
+						draw_rect(Rect2(from, to - from + Vector2(0, cell_size.y)), debug_color);
+					}
+					else if (type == SGPhysics2DServer::GRID_CELL_ONE_WAY) {
+						draw_line(from, to, debug_color, 2);
+					}
+					x = end;
+				}
+			}
+		} break;
+
+		case NOTIFICATION_PARENTED: {
+			SGCollisionObject2D *parent_node = Object::cast_to<SGCollisionObject2D>(get_parent());
+			if (parent_node) {
+				collision_object_rid = parent_node->get_rid();
+			}
+			if (collision_object_rid.is_valid() && !disabled) {
+				SGPhysics2DServer::get_singleton()->collision_object_add_shape(collision_object_rid, rid);
+			}
+		} break;
+
+		case NOTIFICATION_UNPARENTED: {
+			if (collision_object_rid.is_valid() && !disabled) {
+				SGPhysics2DServer::get_singleton()->collision_object_remove_shape(collision_object_rid, rid);
+			}
+			collision_object_rid = RID();
+		} break;
+	}
+}
+
+void SGCollisionGrid2D::set_disabled(bool p_disabled) {
+	if (disabled != p_disabled) {
+		disabled = p_disabled;
+		if (collision_object_rid.is_valid()) {
+			SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+			if (disabled) {
+				physics_server->collision_object_remove_shape(collision_object_rid, rid);
+			}
+			else {
+				physics_server->collision_object_add_shape(collision_object_rid, rid);
+			}
+		}
+	}
+}
+
+bool SGCollisionGrid2D::get_disabled() const {
+	return disabled;
+}
+
+void SGCollisionGrid2D::set_cell_size(const Ref<SGFixedVector2> &p_cell_size) {
+	SGPhysics2DServer::get_singleton()->grid_set_cell_size(rid, p_cell_size);
+	queue_redraw();
+}
+
+Ref<SGFixedVector2> SGCollisionGrid2D::get_cell_size() const {
+	return SGPhysics2DServer::get_singleton()->grid_get_cell_size(rid);
+}
+
+int64_t SGCollisionGrid2D::_get_cell_size_x() const {
+	return get_cell_size()->get_x();
+}
+
+void SGCollisionGrid2D::_set_cell_size_x(int64_t p_x) {
+	Ref<SGFixedVector2> cell_size = get_cell_size();
+	cell_size->set_x(p_x);
+	set_cell_size(cell_size);
+}
+
+int64_t SGCollisionGrid2D::_get_cell_size_y() const {
+	return get_cell_size()->get_y();
+}
+
+void SGCollisionGrid2D::_set_cell_size_y(int64_t p_y) {
+	Ref<SGFixedVector2> cell_size = get_cell_size();
+	cell_size->set_y(p_y);
+	set_cell_size(cell_size);
+}
+
+void SGCollisionGrid2D::set_grid_width(int p_width) {
+	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+	physics_server->grid_set_size(rid, p_width, physics_server->grid_get_height(rid));
+	queue_redraw();
+}
+
+int SGCollisionGrid2D::get_grid_width() const {
+	return SGPhysics2DServer::get_singleton()->grid_get_width(rid);
+}
+
+void SGCollisionGrid2D::set_grid_height(int p_height) {
+	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+	physics_server->grid_set_size(rid, physics_server->grid_get_width(rid), p_height);
+	queue_redraw();
+}
+
+int SGCollisionGrid2D::get_grid_height() const {
+	return SGPhysics2DServer::get_singleton()->grid_get_height(rid);
+}
+
+void SGCollisionGrid2D::set_cell(int p_x, int p_y, SGPhysics2DServer::GridCellType p_type) {
+	SGPhysics2DServer::get_singleton()->grid_set_cell(rid, p_x, p_y, p_type);
+	queue_redraw();
+}
+
+SGPhysics2DServer::GridCellType SGCollisionGrid2D::get_cell(int p_x, int p_y) const {
+	return SGPhysics2DServer::get_singleton()->grid_get_cell(rid, p_x, p_y);
+}
+
+void SGCollisionGrid2D::set_cells(const PackedByteArray &p_cells) {
+	SGPhysics2DServer::get_singleton()->grid_set_cells(rid, p_cells);
+	queue_redraw();
+}
+
+PackedByteArray SGCollisionGrid2D::get_cells() const {
+	return SGPhysics2DServer::get_singleton()->grid_get_cells(rid);
+}
+
+void SGCollisionGrid2D::set_debug_color(const Color &p_color) {
+	debug_color = p_color;
+	queue_redraw();
+}
+
+Color SGCollisionGrid2D::get_debug_color() const {
+	return debug_color;
+}
+
+void SGCollisionGrid2D::sync_to_physics_engine() const {
+	if (!disabled) {
+		SGPhysics2DServer::get_singleton()->shape_set_transform(rid, get_fixed_transform());
+	}
+}
+
+SGCollisionGrid2D::SGCollisionGrid2D() {
+	disabled = false;
+
+	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+	rid = physics_server->shape_create(SGPhysics2DServer::SHAPE_GRID);
+	physics_server->shape_set_data_ptr(rid, this);
+}
+
+SGCollisionGrid2D::~SGCollisionGrid2D() {
+	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
+	if (collision_object_rid.is_valid() && !disabled) {
+		physics_server->collision_object_remove_shape(collision_object_rid, rid);
+	}
+	physics_server->free_rid(rid);
+}
@@ -0,0 +1,77 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SG_COLLISION_GRID_2D_H
+#define SG_COLLISION_GRID_2D_H
+
+#include "sg_fixed_node_2d.h"
+
+#include "../../servers/sg_physics_2d_server.h"
+
+class SGCollisionGrid2D : public SGFixedNode2D {
+	GDCLASS(SGCollisionGrid2D, SGFixedNode2D);
+
+	RID collision_object_rid;
+	RID rid;
+	bool disabled;
+	Color debug_color = Color(0.0, 0.6, 0.7, 0.42);
+
+protected:
+	static void _bind_methods();
+	void _notification(int p_what);
+
+	int64_t _get_cell_size_x() const;
+	void _set_cell_size_x(int64_t p_x);
+	int64_t _get_cell_size_y() const;
+	void _set_cell_size_y(int64_t p_y);
+
+public:
+	void set_disabled(bool p_disabled);
+	bool get_disabled() const;
+
+	void set_cell_size(const Ref<SGFixedVector2> &p_cell_size);
+	Ref<SGFixedVector2> get_cell_size() const;
+
+	void set_grid_width(int p_width);
+	int get_grid_width() const;
+	void set_grid_height(int p_height);
+	int get_grid_height() const;
+
+	void set_cell(int p_x, int p_y, SGPhysics2DServer::GridCellType p_type);
+	SGPhysics2DServer::GridCellType get_cell(int p_x, int p_y) const;
+
+	void set_cells(const PackedByteArray &p_cells);
+	PackedByteArray get_cells() const;
+
+	void set_debug_color(const Color &p_color);
+	Color get_debug_color() const;
+
+	void sync_to_physics_engine() const;
+
+	_FORCE_INLINE_ RID get_rid() const { return rid; }
+
+	SGCollisionGrid2D();
+	~SGCollisionGrid2D();
+};
+
+#endif
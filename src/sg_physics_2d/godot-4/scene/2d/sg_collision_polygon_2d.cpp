@@ -33,6 +33,7 @@
 #include "sg_collision_object_2d.h"
 
 #include "../../servers/sg_physics_2d_server.h"
+#include "../../../internal/sg_shapes_2d_internal.h"
 
 void SGCollisionPolygon2D::_bind_methods()
 {
@@ -107,13 +108,13 @@ void SGCollisionPolygon2D::_notification(int p_what)
 			if (parent_node) {
 				collision_object_rid = parent_node->get_rid();
 			}
-			if (collision_object_rid.is_valid() && !disabled && !concave) {
+			if (collision_object_rid.is_valid() && !disabled && !invalid) {
 				SGPhysics2DServer::get_singleton()->collision_object_add_shape(collision_object_rid, rid);
 			}
 		} break;
 
 		case NOTIFICATION_UNPARENTED: {
-			if (collision_object_rid.is_valid() && !disabled && !concave) {
+			if (collision_object_rid.is_valid() && !disabled && !invalid) {
 				SGPhysics2DServer::get_singleton()->collision_object_remove_shape(collision_object_rid, rid);
 			}
 			collision_object_rid = RID();
@@ -176,24 +177,24 @@ void SGCollisionPolygon2D::update_fixed_polygon()
 		fixed_polygon[i] = p;
 	}
 
-	check_concave();
+	check_invalid();
 	update_internal_shape();
 	update_configuration_warnings();
 }
 
-void SGCollisionPolygon2D::check_concave()
+void SGCollisionPolygon2D::check_invalid()
 {
-	bool was_concave = concave;
+	bool was_invalid = invalid;
 
-	concave = !is_convex(fixed_polygon);
+	invalid = !is_valid_polygon(fixed_polygon);
 
-	// Add or remove the shape if our "convex-ness" has changed.
-	if (concave != was_concave)
+	// Add or remove the shape if our validity has changed.
+	if (invalid != was_invalid)
 	{
 		if (collision_object_rid.is_valid() && !disabled)
 		{
 			SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
-			if (concave)
+			if (invalid)
 			{
 				physics_server->collision_object_remove_shape(collision_object_rid, rid);
 			}
@@ -205,143 +206,32 @@ void SGCollisionPolygon2D::check_concave()
 	}
 }
 
-// Algorithm from https://math.stackexchange.com/a/1745427/969278
-//
-// License: CC BY-SA 3.0
-// Author: Nominal Animal
-//
-bool SGCollisionPolygon2D::is_convex(const Array &p_vertices)
+// Concave polygons are split into convex parts by the physics engine, so the
+// only polygons we can't use are those with fewer than 3 points, or whose
+// edges cross each other.
+bool SGCollisionPolygon2D::is_valid_polygon(const Array &p_vertices)
 {
 	if (p_vertices.size() < 3)
 	{
 		return false;
 	}
 
-	// This algorithm is based on this answer on StackExchange:
-	//   https://math.stackexchange.com/a/1745427
-
-	fixed w_sign = fixed::ZERO;
-
-	int x_sign = 0;
-	int x_first_sign = 0;
-	int x_flips = 0;
-
-	int y_sign = 0;
-	int y_first_sign = 0;
-	int y_flips = 0;
-
-	Ref<SGFixedVector2> prev;
-	Ref<SGFixedVector2> cur = p_vertices[p_vertices.size() - 2];
-	Ref<SGFixedVector2> next = p_vertices[p_vertices.size() - 1];
-
+	std::vector<SGFixedVector2Internal> points;
+	points.reserve(p_vertices.size());
 	for (int i = 0; i < p_vertices.size(); i++)
 	{
-		prev = cur;
-		cur = next;
-		next = p_vertices[i];
-
-		ERR_FAIL_COND_V_MSG(!cur.is_valid(), false, "Vertex in polygon is invalid");
-		ERR_FAIL_COND_V_MSG(!prev.is_valid(), false, "Vertex in polygon is invalid");
-		ERR_FAIL_COND_V_MSG(!next.is_valid(), false, "Vertex in polygon is invalid");
-
-		SGFixedVector2Internal previous_edge = cur->get_internal() - prev->get_internal();
-		SGFixedVector2Internal next_edge = next->get_internal() - cur->get_internal();
-
-		if (next_edge.x > fixed::ZERO)
-		{
-			if (x_sign == 0)
-			{
-				x_first_sign = +1;
-			}
-			else if (x_sign < 0)
-			{
-				x_flips++;
-			}
-			x_sign = +1;
-		}
-		else if (next_edge.x < fixed::ZERO)
-		{
-			if (x_sign == 0)
-			{
-				x_first_sign = -1;
-			}
-			else if (x_sign > 0)
-			{
-				x_flips++;
-			}
-			x_sign = -1;
-		}
-
-		if (x_flips > 2)
-		{
-			return false;
-		}
-
-		if (next_edge.y > fixed::ZERO)
-		{
-			if (y_sign == 0)
-			{
-				y_first_sign = +1;
-			}
-			else if (y_sign < 0)
-			{
-				y_flips++;
-			}
-			y_sign = +1;
-		}
-		else if (next_edge.y < fixed::ZERO)
-		{
-			if (y_sign == 0)
-			{
-				y_first_sign = -1;
-			}
-			else if (y_sign > 0)
-			{
-				y_flips++;
-			}
-			y_sign = -1;
-		}
-
-		if (y_flips > 2)
-		{
-			return false;
-		}
-
-		// Find out the orientation of this pair of edges and ensure it doesn't
-		// differ from previous ones.
-		fixed w = previous_edge.x * next_edge.y - next_edge.x * previous_edge.y;
-		if (w_sign == fixed::ZERO && w != fixed::ZERO)
-		{
-			w_sign = w;
-		}
-		else if (w_sign > fixed::ZERO && w < fixed::ZERO)
-		{
-			return false;
-		}
-		else if (w_sign < fixed::ZERO && w > fixed::ZERO)
-		{
-			return false;
-		}
+		Ref<SGFixedVector2> p = p_vertices[i];
+		ERR_FAIL_COND_V_MSG(!p.is_valid(), false, "Vertex in polygon is invalid");
+		points.push_back(p->get_internal());
 	}
 
-	// Final wrap-around sign flips.
-	if (x_sign != 0 && x_first_sign != 0 && x_sign != x_first_sign)
+	if (SGPolygon2DInternal::is_convex(points))
 	{
-		x_flips++;
-	}
-	if (y_sign != 0 && y_first_sign != 0 && y_sign != y_first_sign)
-	{
-		y_flips++;
-	}
-
-	// Convex polygons have two sign flips along each axis.
-	if (x_flips != 2 || y_flips != 2)
-	{
-		return false;
+		return true;
 	}
 
-	// We've passed all the tests!
-	return true;
+	std::vector<std::vector<SGFixedVector2Internal>> parts;
+	return SGPolygon2DInternal::decompose(points, parts);
 }
 
 Array SGCollisionPolygon2D::_get_fixed_polygon_pairs() const
@@ -400,7 +290,7 @@ void SGCollisionPolygon2D::set_disabled(bool p_disabled)
 	if (disabled != p_disabled)
 	{
 		disabled = p_disabled;
-		if (collision_object_rid.is_valid() && !concave)
+		if (collision_object_rid.is_valid() && !invalid)
 		{
 			SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
 			if (disabled)
@@ -460,7 +350,7 @@ void SGCollisionPolygon2D::set_fixed_polygon(const Array &p_fixed_polygon)
 		update_polygon();
 	}
 
-	check_concave();
+	check_invalid();
 	update_internal_shape();
 	update_configuration_warnings();
 }
@@ -477,7 +367,7 @@ void SGCollisionPolygon2D::update_internal_shape() const
 
 void SGCollisionPolygon2D::sync_to_physics_engine() const
 {
-	if (!disabled && !concave)
+	if (!disabled && !invalid)
 	{
 		SGPhysics2DServer::get_singleton()->shape_set_transform(rid, get_fixed_transform());
 	}
@@ -491,9 +381,9 @@ PackedStringArray SGCollisionPolygon2D::_get_configuration_warnings() const
 	{
 		warnings.push_back(TTR("Need a polygon with 3 or more points."));
 	}
-	else if (concave)
+	else if (invalid)
 	{
-		warnings.push_back(TTR("This polygon is concave. Only convex polygons are supported."));
+		warnings.push_back(TTR("This polygon crosses itself. Only simple polygons are supported."));
 	}
 
 	return warnings;
@@ -503,7 +393,7 @@ SGCollisionPolygon2D::SGCollisionPolygon2D()
 {
 	aabb = Rect2(-10, -10, 20, 20);
 	disabled = false;
-	concave = false;
+	invalid = false;
 
 	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
 	rid = physics_server->shape_create(SGPhysics2DServer::SHAPE_POLYGON);
@@ -513,7 +403,7 @@ SGCollisionPolygon2D::SGCollisionPolygon2D()
 SGCollisionPolygon2D::~SGCollisionPolygon2D()
 {
 	SGPhysics2DServer *physics_server = SGPhysics2DServer::get_singleton();
-	if (collision_object_rid.is_valid() && !disabled && !concave)
+	if (collision_object_rid.is_valid() && !disabled && !invalid)
 	{
 		physics_server->collision_object_remove_shape(collision_object_rid, rid);
 	}
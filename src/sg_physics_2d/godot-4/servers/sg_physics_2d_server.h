@@ -24,6 +24,8 @@
 #ifndef SG_PHYSICS_2D_SERVER_H
 #define SG_PHYSICS_2D_SERVER_H
 
+#include <atomic>
+
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/templates/rid_owner.hpp>
@@ -37,6 +39,7 @@ class SGPhysics2DServer;
 class SGShape2DInternal;
 class SGCollisionObject2DInternal;
 class SGWorld2DInternal;
+struct SGRayCastBatch;
 
 class SGAreaCollision2D : public RefCounted {
 	GDCLASS(SGAreaCollision2D, RefCounted);
@@ -59,6 +62,36 @@ public:
 	SGAreaCollision2D();
 };
 
+class SGAreaOverlapEvent2D : public RefCounted {
+	GDCLASS(SGAreaOverlapEvent2D, RefCounted);
+
+public:
+	enum EventType {
+		OVERLAP_BEGIN = 0,
+		OVERLAP_END = 1,
+	};
+
+private:
+	EventType type;
+	SGCollisionObject2D *area;
+	RID area_rid;
+	SGCollisionObject2D *collider;
+	RID collider_rid;
+
+protected:
+	static void _bind_methods();
+
+public:
+	EventType get_type() const;
+	SGCollisionObject2D *get_area() const;
+	RID get_area_rid() const;
+	SGCollisionObject2D *get_collider() const;
+	RID get_collider_rid() const;
+
+	SGAreaOverlapEvent2D(EventType p_type, SGCollisionObject2D *p_area, RID p_area_rid, SGCollisionObject2D *p_collider, RID p_collider_rid);
+	SGAreaOverlapEvent2D();
+};
+
 class SGKinematicCollision2D : public RefCounted {
 	GDCLASS(SGKinematicCollision2D, RefCounted);
 
@@ -113,6 +146,14 @@ class SGPhysics2DServer : public Object {
 
 	RID default_world;
 
+	// The batch being spread across the WorkerThreadPool by world_cast_rays().
+	// Its tasks can't be given their own arguments, so only one batch can be
+	// spread at a time. It's claimed atomically, so a batch started on
+	// another thread meanwhile fails instead of replacing it.
+	std::atomic<SGRayCastBatch *> ray_cast_batch { nullptr };
+
+	void _cast_ray_batch_task(int p_chunk);
+
 protected:
 	static void _bind_methods();
 
@@ -125,6 +166,13 @@ public:
 		SHAPE_CIRCLE,
 		SHAPE_POLYGON,
 		SHAPE_CAPSULE,
+		SHAPE_GRID,
+	};
+
+	enum GridCellType {
+		GRID_CELL_EMPTY = 0,
+		GRID_CELL_SOLID = 1,
+		GRID_CELL_ONE_WAY = 2,
 	};
 
 	enum CollisionObjectType {
@@ -140,6 +188,25 @@ public:
 		BODY_CHARACTER = 1,
 	};
 
+	enum BroadphaseType {
+		BROADPHASE_DEFAULT = -1,
+		BROADPHASE_SPATIAL_HASH = 0,
+		BROADPHASE_AABB_TREE = 1,
+	};
+
+	enum NarrowphaseType {
+		NARROWPHASE_DEFAULT = -1,
+		NARROWPHASE_SAT = 0,
+		NARROWPHASE_GJK = 1,
+	};
+
+	enum SlideFlags {
+		SLIDE_COLLIDED = 1,
+		SLIDE_ON_FLOOR = 2,
+		SLIDE_ON_CEILING = 4,
+		SLIDE_ON_WALL = 8,
+	};
+
 	RID shape_create(ShapeType p_shape_type);
 	ShapeType shape_get_type(RID p_shape) const;
 	void shape_set_data(RID p_shape, const Variant &p_data);
@@ -164,6 +231,16 @@ public:
 	void polygon_set_points(RID p_shape, const Array &p_points);
 	Array polygon_get_points(RID p_shape) const;
 
+	void grid_set_cell_size(RID p_shape, const Ref<SGFixedVector2> &p_cell_size);
+	Ref<SGFixedVector2> grid_get_cell_size(RID p_shape) const;
+	void grid_set_size(RID p_shape, int p_width, int p_height);
+	int grid_get_width(RID p_shape) const;
+	int grid_get_height(RID p_shape) const;
+	void grid_set_cell(RID p_shape, int p_x, int p_y, GridCellType p_type);
+	GridCellType grid_get_cell(RID p_shape, int p_x, int p_y) const;
+	void grid_set_cells(RID p_shape, const PackedByteArray &p_cells);
+	PackedByteArray grid_get_cells(RID p_shape) const;
+
 	RID collision_object_create(CollisionObjectType p_object_type, BodyType p_body_type = BODY_UNKNOWN);
 	CollisionObjectType collision_object_get_type(RID p_object);
 	void collision_object_set_data(RID p_object, const Variant &p_data);
@@ -182,12 +259,12 @@ public:
 	void collision_object_set_monitorable(RID p_object, bool p_monitorable);
 	bool collision_object_get_monitorable(RID p_object) const;
 
-	Array area_get_overlapping_areas(RID p_area) const;
-	Array area_get_overlapping_bodies(RID p_area) const;
-	Array area_get_overlapping_area_collisions(RID p_area) const;
-	Array area_get_overlapping_body_collisions(RID p_area) const;
-	int area_get_overlapping_area_count(RID p_area) const;
-	int area_get_overlapping_body_count(RID p_area) const;
+	Array area_get_overlapping_areas(RID p_area);
+	Array area_get_overlapping_bodies(RID p_area);
+	Array area_get_overlapping_area_collisions(RID p_area);
+	Array area_get_overlapping_body_collisions(RID p_area);
+	int area_get_overlapping_area_count(RID p_area);
+	int area_get_overlapping_body_count(RID p_area);
 
 	BodyType body_get_type(RID p_body) const;
 	void body_set_safe_margin(RID p_body, int p_safe_margin);
@@ -195,12 +272,29 @@ public:
 	bool body_unstuck(RID p_body, int p_max_attempts) const;
 	Ref<SGKinematicCollision2D> body_move_and_collide(RID p_body, const Ref<SGFixedVector2> &p_linear_velocity) const;
 
-	RID world_create();
+	RID world_create(BroadphaseType p_broadphase_type = BROADPHASE_DEFAULT);
+	BroadphaseType world_get_broadphase_type(RID p_world) const;
+	void world_set_broadphase_margin(RID p_world, int64_t p_margin);
+	int64_t world_get_broadphase_margin(RID p_world) const;
+	void world_set_broadphase_cell_size(RID p_world, int p_cell_size);
+	int world_get_broadphase_cell_size(RID p_world) const;
+	int world_tune_broadphase_cell_size(RID p_world);
+	Dictionary world_get_broadphase_statistics(RID p_world) const;
+	void world_reset_broadphase_statistics(RID p_world);
+	void world_set_narrowphase_type(RID p_world, NarrowphaseType p_narrowphase_type);
+	NarrowphaseType world_get_narrowphase_type(RID p_world) const;
+	Array world_pop_overlap_events(RID p_world);
+	PackedByteArray world_save_snapshot(RID p_world) const;
+	bool world_load_snapshot(RID p_world, const PackedByteArray &p_snapshot);
+	int64_t world_get_state_hash(RID p_world);
+	void world_prepare_for_concurrent_queries(RID p_world);
+	Dictionary world_move_and_slide_bodies(RID p_world, const Array &p_bodies, const PackedInt64Array &p_velocities, const Ref<SGFixedVector2> &p_up_direction, int p_max_slides = 4, int64_t p_floor_max_angle = 51471);
 	RID get_default_world();
 	void world_add_collision_object(RID p_world, RID p_object);
 	void world_remove_collision_object(RID p_world, RID p_object);
 
 	Ref<SGRayCastCollision2D> world_cast_ray(RID p_world, const Ref<SGFixedVector2> &p_start, const Ref<SGFixedVector2> &p_cast_to, uint32_t p_collision_mask, Array p_exceptions = Array(), bool p_collide_with_areas = false, bool p_collide_with_bodies = true);
+	Dictionary world_cast_rays(RID p_world, const PackedInt64Array &p_starts, const PackedInt64Array &p_cast_tos, const PackedInt32Array &p_collision_masks, Array p_exceptions = Array(), bool p_collide_with_areas = false, bool p_collide_with_bodies = true);
 
 	void free_rid(RID p_rid);
 
@@ -209,14 +303,20 @@ public:
 	SGCollisionObject2DInternal *collision_object_get_internal(RID p_object);
 	SGWorld2DInternal *world_get_internal(RID p_world);
 	SGWorld2DInternal *get_default_world_internal();
+	Ref<SGKinematicCollision2D> kinematic_collision_from_internal(SGCollisionObject2DInternal *p_collider, const SGFixedVector2Internal &p_normal, const SGFixedVector2Internal &p_remainder) const;
 
 	SGPhysics2DServer();
 	~SGPhysics2DServer();
 
 };
 
+VARIANT_ENUM_CAST(SGAreaOverlapEvent2D::EventType);
 VARIANT_ENUM_CAST(SGPhysics2DServer::ShapeType);
+VARIANT_ENUM_CAST(SGPhysics2DServer::GridCellType);
 VARIANT_ENUM_CAST(SGPhysics2DServer::CollisionObjectType);
 VARIANT_ENUM_CAST(SGPhysics2DServer::BodyType);
+VARIANT_ENUM_CAST(SGPhysics2DServer::BroadphaseType);
+VARIANT_ENUM_CAST(SGPhysics2DServer::NarrowphaseType);
+VARIANT_ENUM_CAST(SGPhysics2DServer::SlideFlags);
 
 #endif
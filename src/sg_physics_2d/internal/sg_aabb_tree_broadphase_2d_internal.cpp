@@ -0,0 +1,480 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "sg_aabb_tree_broadphase_2d_internal.h"
+
+#include "sg_bodies_2d_internal.h"
+
+int32_t SGAABBTreeBroadphase2DInternal::_allocate_node() {
+	int32_t index;
+	if (free_list == NULL_NODE) {
+		index = (int32_t)nodes.size();
+		nodes.push_back(Node());
+	}
+	else {
+		index = free_list;
+		free_list = nodes[index].next;
+	}
+
+	Node &node = nodes[index];
+	node.element = NULL_ELEMENT;
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+
+	return index;
+}
+
+void SGAABBTreeBroadphase2DInternal::_free_node(int32_t p_node) {
+	Node &node = nodes[p_node];
+	node.element = NULL_ELEMENT;
+	node.next = free_list;
+	node.height = -1;
+	free_list = p_node;
+}
+
+// Adapted from Box2D: https://github.com/erincatto/box2d
+// Copyright (c) 2009 Erin Catto http://www.box2d.org
+// License: MIT
+void SGAABBTreeBroadphase2DInternal::_insert_leaf(int32_t p_leaf) {
+	if (root == NULL_NODE) {
+		root = p_leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling for this leaf, by descending the tree and
+	// comparing the cost of the perimeter we'd add on each side.
+	SGFixedRect2Internal leaf_bounds = nodes[p_leaf].bounds;
+	int32_t index = root;
+	while (!nodes[index].is_leaf()) {
+		const Node &node = nodes[index];
+		const Node &child1 = nodes[node.child1];
+		const Node &child2 = nodes[node.child2];
+
+		fixed perimeter = _get_perimeter(node.bounds);
+		fixed combined_perimeter = _get_perimeter(node.bounds.merge(leaf_bounds));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		fixed cost = combined_perimeter + combined_perimeter;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		fixed inheritance_cost = (combined_perimeter - perimeter) + (combined_perimeter - perimeter);
+
+		fixed cost1 = _get_perimeter(leaf_bounds.merge(child1.bounds)) + inheritance_cost;
+		if (!child1.is_leaf()) {
+			cost1 -= _get_perimeter(child1.bounds);
+		}
+
+		fixed cost2 = _get_perimeter(leaf_bounds.merge(child2.bounds)) + inheritance_cost;
+		if (!child2.is_leaf()) {
+			cost2 -= _get_perimeter(child2.bounds);
+		}
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+
+	int32_t sibling = index;
+
+	// Create a new parent for the sibling and the leaf.
+	int32_t old_parent = nodes[sibling].parent;
+	int32_t new_parent = _allocate_node();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].bounds = leaf_bounds.merge(nodes[sibling].bounds);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = p_leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[p_leaf].parent = new_parent;
+
+	if (old_parent != NULL_NODE) {
+		if (nodes[old_parent].child1 == sibling) {
+			nodes[old_parent].child1 = new_parent;
+		}
+		else {
+			nodes[old_parent].child2 = new_parent;
+		}
+	}
+	else {
+		root = new_parent;
+	}
+
+	// Walk back up the tree, fixing heights and bounds.
+	index = nodes[p_leaf].parent;
+	while (index != NULL_NODE) {
+		index = _balance(index);
+
+		Node &node = nodes[index];
+		const Node &child1 = nodes[node.child1];
+		const Node &child2 = nodes[node.child2];
+		node.height = 1 + MAX(child1.height, child2.height);
+		node.bounds = child1.bounds.merge(child2.bounds);
+
+		index = node.parent;
+	}
+}
+
+// Adapted from Box2D: https://github.com/erincatto/box2d
+// Copyright (c) 2009 Erin Catto http://www.box2d.org
+// License: MIT
+void SGAABBTreeBroadphase2DInternal::_remove_leaf(int32_t p_leaf) {
+	if (p_leaf == root) {
+		root = NULL_NODE;
+		return;
+	}
+
+	int32_t parent = nodes[p_leaf].parent;
+	int32_t grand_parent = nodes[parent].parent;
+	int32_t sibling = (nodes[parent].child1 == p_leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grand_parent == NULL_NODE) {
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		_free_node(parent);
+		return;
+	}
+
+	// Destroy the parent and connect the sibling to the grand parent.
+	if (nodes[grand_parent].child1 == parent) {
+		nodes[grand_parent].child1 = sibling;
+	}
+	else {
+		nodes[grand_parent].child2 = sibling;
+	}
+	nodes[sibling].parent = grand_parent;
+	_free_node(parent);
+
+	// Adjust ancestor bounds.
+	int32_t index = grand_parent;
+	while (index != NULL_NODE) {
+		index = _balance(index);
+
+		Node &node = nodes[index];
+		const Node &child1 = nodes[node.child1];
+		const Node &child2 = nodes[node.child2];
+		node.bounds = child1.bounds.merge(child2.bounds);
+		node.height = 1 + MAX(child1.height, child2.height);
+
+		index = node.parent;
+	}
+}
+
+// Performs a left or right rotation if node A is imbalanced, and returns
+// the index of the new root of this sub-tree.
+//
+// Adapted from Box2D: https://github.com/erincatto/box2d
+// Copyright (c) 2009 Erin Catto http://www.box2d.org
+// License: MIT
+int32_t SGAABBTreeBroadphase2DInternal::_balance(int32_t p_a) {
+	Node *a = &nodes[p_a];
+	if (a->is_leaf() || a->height < 2) {
+		return p_a;
+	}
+
+	int32_t i_b = a->child1;
+	int32_t i_c = a->child2;
+	Node *b = &nodes[i_b];
+	Node *c = &nodes[i_c];
+
+	int32_t balance = c->height - b->height;
+
+	// Rotate C up.
+	if (balance > 1) {
+		int32_t i_f = c->child1;
+		int32_t i_g = c->child2;
+		Node *f = &nodes[i_f];
+		Node *g = &nodes[i_g];
+
+		// Swap A and C.
+		c->child1 = p_a;
+		c->parent = a->parent;
+		a->parent = i_c;
+
+		// A's old parent should point to C.
+		if (c->parent != NULL_NODE) {
+			if (nodes[c->parent].child1 == p_a) {
+				nodes[c->parent].child1 = i_c;
+			}
+			else {
+				nodes[c->parent].child2 = i_c;
+			}
+		}
+		else {
+			root = i_c;
+		}
+
+		// Rotate.
+		if (f->height > g->height) {
+			c->child2 = i_f;
+			a->child2 = i_g;
+			g->parent = p_a;
+			a->bounds = b->bounds.merge(g->bounds);
+			c->bounds = a->bounds.merge(f->bounds);
+			a->height = 1 + MAX(b->height, g->height);
+			c->height = 1 + MAX(a->height, f->height);
+		}
+		else {
+			c->child2 = i_g;
+			a->child2 = i_f;
+			f->parent = p_a;
+			a->bounds = b->bounds.merge(f->bounds);
+			c->bounds = a->bounds.merge(g->bounds);
+			a->height = 1 + MAX(b->height, f->height);
+			c->height = 1 + MAX(a->height, g->height);
+		}
+
+		return i_c;
+	}
+
+	// Rotate B up.
+	if (balance < -1) {
+		int32_t i_d = b->child1;
+		int32_t i_e = b->child2;
+		Node *d = &nodes[i_d];
+		Node *e = &nodes[i_e];
+
+		// Swap A and B.
+		b->child1 = p_a;
+		b->parent = a->parent;
+		a->parent = i_b;
+
+		// A's old parent should point to B.
+		if (b->parent != NULL_NODE) {
+			if (nodes[b->parent].child1 == p_a) {
+				nodes[b->parent].child1 = i_b;
+			}
+			else {
+				nodes[b->parent].child2 = i_b;
+			}
+		}
+		else {
+			root = i_b;
+		}
+
+		// Rotate.
+		if (d->height > e->height) {
+			b->child2 = i_d;
+			a->child1 = i_e;
+			e->parent = p_a;
+			a->bounds = c->bounds.merge(e->bounds);
+			b->bounds = a->bounds.merge(d->bounds);
+			a->height = 1 + MAX(c->height, e->height);
+			b->height = 1 + MAX(a->height, d->height);
+		}
+		else {
+			b->child2 = i_e;
+			a->child1 = i_d;
+			d->parent = p_a;
+			a->bounds = c->bounds.merge(d->bounds);
+			b->bounds = a->bounds.merge(e->bounds);
+			a->height = 1 + MAX(c->height, d->height);
+			b->height = 1 + MAX(a->height, e->height);
+		}
+
+		return i_b;
+	}
+
+	return p_a;
+}
+
+int32_t SGAABBTreeBroadphase2DInternal::create_element(SGCollisionObject2DInternal *p_object) {
+	int32_t element = _allocate_element(p_object);
+	if (element == (int32_t)element_nodes.size()) {
+		element_nodes.push_back(0);
+	}
+
+	int32_t node = _allocate_node();
+	element_nodes[element] = node;
+	nodes[node].bounds = element_fat_bounds[element];
+	nodes[node].element = element;
+	_insert_leaf(node);
+
+	return element;
+}
+
+void SGAABBTreeBroadphase2DInternal::update_element(int32_t p_element) {
+	if (!_update_element_bounds(p_element)) {
+		return;
+	}
+
+	int32_t node = element_nodes[p_element];
+	const SGFixedRect2Internal &fat_bounds = element_fat_bounds[p_element];
+	const SGFixedRect2Internal &node_bounds = nodes[node].bounds;
+	if (fat_bounds.position == node_bounds.position && fat_bounds.size == node_bounds.size) {
+		return;
+	}
+
+	_remove_leaf(node);
+	nodes[node].bounds = fat_bounds;
+	_insert_leaf(node);
+}
+
+void SGAABBTreeBroadphase2DInternal::delete_element(int32_t p_element) {
+	int32_t node = element_nodes[p_element];
+	_remove_leaf(node);
+	_free_node(node);
+	element_nodes[p_element] = NULL_NODE;
+	_free_element(p_element);
+}
+
+void SGAABBTreeBroadphase2DInternal::find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	if (root == NULL_NODE) {
+		_count_query(0);
+		return;
+	}
+
+	// A depth-first traversal never has more than one pending node per
+	// level, so the stack can't grow past the height of the tree.
+	int32_t local_stack[QUERY_STACK_SIZE];
+	std::vector<int32_t> heap_stack;
+	int32_t *stack = local_stack;
+	if (nodes[root].height >= QUERY_STACK_SIZE) {
+		heap_stack.resize(nodes[root].height + 1);
+		stack = heap_stack.data();
+	}
+
+	uint64_t candidates = 0;
+	int stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+
+		if (!p_bounds.intersects(node.bounds)) {
+			continue;
+		}
+
+		if (node.is_leaf()) {
+			candidates++;
+			if (!element_filters[node.element].passes(p_type, p_collision_layer, p_collision_mask)) {
+				continue;
+			}
+			// Leaves hold the fat bounds, so check against the exact ones.
+			if (!p_bounds.intersects(element_bounds[node.element])) {
+				continue;
+			}
+			p_result_handler->handle_result(element_objects[node.element], nullptr);
+		}
+		else {
+			stack[stack_size++] = node.child1;
+			stack[stack_size++] = node.child2;
+		}
+	}
+
+	_count_query(candidates);
+}
+
+void SGAABBTreeBroadphase2DInternal::find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	if (root == NULL_NODE) {
+		_count_query(0);
+		return;
+	}
+
+	SGFixedRect2Internal segment_bounds(p_start, SGFixedVector2Internal());
+	segment_bounds.expand_to(p_start + p_cast_to);
+
+	int32_t local_stack[QUERY_STACK_SIZE];
+	std::vector<int32_t> heap_stack;
+	int32_t *stack = local_stack;
+	if (nodes[root].height >= QUERY_STACK_SIZE) {
+		heap_stack.resize(nodes[root].height + 1);
+		stack = heap_stack.data();
+	}
+
+	// Only changes after reporting a result.
+	SGFixedVector2Internal hit;
+	bool has_hit = p_result_handler->get_closest_hit(hit);
+
+	uint64_t candidates = 0;
+	int stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+
+		if (!_segment_may_touch(p_start, p_cast_to, segment_bounds, node.bounds)) {
+			continue;
+		}
+		if (has_hit && _is_past_point(p_start, p_cast_to, node.bounds, hit)) {
+			continue;
+		}
+
+		if (node.is_leaf()) {
+			candidates++;
+			if (!element_filters[node.element].passes(p_type, p_collision_layer, p_collision_mask)) {
+				continue;
+			}
+			if (!_segment_may_touch(p_start, p_cast_to, segment_bounds, element_bounds[node.element])) {
+				continue;
+			}
+			p_result_handler->handle_result(element_objects[node.element], nullptr);
+			has_hit = p_result_handler->get_closest_hit(hit);
+		}
+		else {
+			stack[stack_size++] = node.child1;
+			stack[stack_size++] = node.child2;
+		}
+	}
+
+	_count_query(candidates);
+}
+
+void SGAABBTreeBroadphase2DInternal::set_margin(fixed p_margin) {
+	if (margin == p_margin) {
+		return;
+	}
+	margin = p_margin;
+	rebuild();
+}
+
+void SGAABBTreeBroadphase2DInternal::rebuild() {
+	// Throw away all the nodes, rather than removing the leaves one at a time.
+	nodes.clear();
+	root = NULL_NODE;
+	free_list = NULL_NODE;
+
+	// Re-insert everything in a deterministic order.
+	for (int32_t element : element_list) {
+		element_bounds[element] = element_objects[element]->get_bounds();
+		_reset_fat_bounds(element);
+
+		int32_t node = _allocate_node();
+		element_nodes[element] = node;
+		nodes[node].bounds = element_fat_bounds[element];
+		nodes[node].element = element;
+		_insert_leaf(node);
+	}
+}
+
+SGAABBTreeBroadphase2DInternal::SGAABBTreeBroadphase2DInternal() {
+	root = NULL_NODE;
+	free_list = NULL_NODE;
+}
+
+SGAABBTreeBroadphase2DInternal::~SGAABBTreeBroadphase2DInternal() {
+}
@@ -0,0 +1,99 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SG_AABB_TREE_BROADPHASE_2D_INTERNAL_H
+#define SG_AABB_TREE_BROADPHASE_2D_INTERNAL_H
+
+#include <vector>
+
+#include "sg_broadphase_2d_internal.h"
+
+// A dynamic bounding volume hierarchy, in the style of Box2D's b2DynamicTree.
+//
+// Unlike the spatial hash, each element lives in exactly one leaf no matter
+// how big it is, so huge static geometry and tiny fast-moving objects are
+// equally cheap to maintain. Everything is done with fixed-point math and
+// integer node indices, so the shape of the tree (and therefore the order of
+// results from find_nearby()) is fully determined by the order of operations.
+class SGAABBTreeBroadphase2DInternal : public SGBroadphase2DInternal {
+public:
+
+	static const int32_t NULL_NODE = -1;
+	static const int32_t QUERY_STACK_SIZE = 128;
+
+	struct Node {
+		SGFixedRect2Internal bounds;
+		// The element in a leaf, or NULL_ELEMENT.
+		int32_t element;
+		union {
+			int32_t parent;
+			int32_t next;
+		};
+		int32_t child1;
+		int32_t child2;
+		// Leaves have a height of 0, free nodes have a height of -1.
+		int32_t height;
+
+		_FORCE_INLINE_ bool is_leaf() const { return child1 == NULL_NODE; }
+	};
+
+private:
+	std::vector<Node> nodes;
+	int32_t root;
+	int32_t free_list;
+
+	// The leaf of each element, indexed by its handle.
+	std::vector<int32_t> element_nodes;
+
+	int32_t _allocate_node();
+	void _free_node(int32_t p_node);
+
+	void _insert_leaf(int32_t p_leaf);
+	void _remove_leaf(int32_t p_leaf);
+	int32_t _balance(int32_t p_node);
+
+	_FORCE_INLINE_ static fixed _get_perimeter(const SGFixedRect2Internal &p_bounds) {
+		// Really the half perimeter, but we only ever compare them.
+		return p_bounds.size.x + p_bounds.size.y;
+	}
+
+public:
+	virtual BroadphaseType get_broadphase_type() const override { return BROADPHASE_AABB_TREE; }
+
+	virtual int32_t create_element(SGCollisionObject2DInternal *p_object) override;
+	virtual void update_element(int32_t p_element) override;
+	virtual void delete_element(int32_t p_element) override;
+
+	virtual void find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+	virtual void find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+
+	virtual void set_margin(fixed p_margin) override;
+	virtual void rebuild() override;
+
+	_FORCE_INLINE_ int32_t get_height() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+	SGAABBTreeBroadphase2DInternal();
+	~SGAABBTreeBroadphase2DInternal();
+};
+
+#endif
@@ -29,38 +29,87 @@
 #include "sg_broadphase_2d_internal.h"
 #include "sg_utils_internal.h"
 
+void SGCollisionObject2DInternal::_update_broadphase_element() {
+	if (broadphase && monitorable && broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
+		broadphase->update_element(broadphase_element);
+	}
+}
+
+void SGCollisionObject2DInternal::_mark_changed() {
+	if (world) {
+		world->mark_overlaps_dirty(this);
+		world->mark_state_hash_dirty(this);
+	}
+}
+
+uint64_t SGCollisionObject2DInternal::_compute_state_hash() const {
+	uint64_t hash = sg_hash_mix(object_type);
+	for (int i = 0; i < 3; i++) {
+		hash = sg_hash_combine(hash, transform.elements[i].x.value);
+		hash = sg_hash_combine(hash, transform.elements[i].y.value);
+	}
+	hash = sg_hash_combine(hash, collision_layer);
+	hash = sg_hash_combine(hash, collision_mask);
+	hash = sg_hash_combine(hash, monitorable);
+	for (const SGShape2DInternal *shape : shapes) {
+		hash = shape->hash_state(hash);
+	}
+	return hash;
+}
+
+void SGCollisionObject2DInternal::_set_transform_silently(const SGFixedTransform2DInternal &p_transform) {
+	transform = p_transform;
+	for (SGShape2DInternal *shape : shapes) {
+		shape->mark_global_xform_dirty();
+	}
+}
+
+void SGCollisionObject2DInternal::_restore_transforms(const SGFixedTransform2DInternal &p_transform, const SGFixedTransform2DInternal *p_shape_transforms) {
+	for (std::vector<SGShape2DInternal *>::size_type i = 0; i < shapes.size(); i++) {
+		shapes[i]->transform = p_shape_transforms[i];
+	}
+	_set_transform_silently(p_transform);
+	motion_origin = p_transform.get_origin();
+}
+
 void SGCollisionObject2DInternal::set_transform(const SGFixedTransform2DInternal &p_transform) {
 	transform = p_transform;
+	motion_origin = transform.get_origin();
 	for(SGShape2DInternal *shape : shapes) {
 		shape->mark_global_xform_dirty();
 	}
 
 	if (broadphase && monitorable) {
-		if (broadphase_element) {
+		if (broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
 			broadphase->update_element(broadphase_element);
 		}
 		else {
 			broadphase_element = broadphase->create_element(this);
 		}
 	}
+
+	_mark_changed();
 }
 
 void SGCollisionObject2DInternal::add_shape(SGShape2DInternal *p_shape) {
 	p_shape->set_owner(this);
 	shapes.push_back(p_shape);
 
-	if (broadphase && monitorable && broadphase_element) {
-		broadphase->update_element(broadphase_element);
-	}
+	_update_broadphase_element();
+	_mark_changed();
 }
 
 void SGCollisionObject2DInternal::remove_shape(SGShape2DInternal *p_shape) {
 	p_shape->set_owner(nullptr);
 	sg_remove_by_value(shapes, p_shape);
 
-	if (broadphase && monitorable && broadphase_element) {
-		broadphase->update_element(broadphase_element);
-	}
+	_update_broadphase_element();
+	_mark_changed();
+}
+
+void SGCollisionObject2DInternal::shape_changed(SGShape2DInternal *p_shape) {
+	_update_broadphase_element();
+	_mark_changed();
 }
 
 SGFixedRect2Internal SGCollisionObject2DInternal::get_bounds() const {
@@ -79,9 +128,13 @@ SGFixedRect2Internal SGCollisionObject2DInternal::get_bounds() const {
 void SGCollisionObject2DInternal::add_to_broadphase(SGBroadphase2DInternal *p_broadphase) {
 	remove_from_broadphase();
 	broadphase = p_broadphase;
-	if (transform == SGFixedTransform2DInternal()) {
+	if (!monitorable) {
+		// Objects that aren't monitorable are kept out of the broadphase.
+		broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
+	}
+	else if (transform == SGFixedTransform2DInternal()) {
 		// Defer creation of the broadphase element until we update the transform.
-		broadphase_element = nullptr;
+		broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
 	}
 	else {
 		broadphase_element = broadphase->create_element(this);
@@ -90,11 +143,11 @@ void SGCollisionObject2DInternal::add_to_broadphase(SGBroadphase2DInternal *p_br
 
 void SGCollisionObject2DInternal::remove_from_broadphase() {
 	if (broadphase) {
-		if (monitorable && broadphase_element) {
+		if (monitorable && broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
 			broadphase->delete_element(broadphase_element);
 		}
 		broadphase = nullptr;
-		broadphase_element = nullptr;
+		broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
 	}
 }
 
@@ -107,31 +160,61 @@ void SGCollisionObject2DInternal::set_monitorable(bool p_monitorable) {
 		if (!monitorable) {
 			broadphase_element = broadphase->create_element(this);
 		}
-		else if (broadphase_element) {
+		else if (broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
 			broadphase->delete_element(broadphase_element);
-			broadphase_element = nullptr;
+			broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
 		}
 	}
 	monitorable = p_monitorable;
+
+	_mark_changed();
+}
+
+void SGCollisionObject2DInternal::set_collision_layer(uint32_t p_collision_layer) {
+	if (collision_layer != p_collision_layer) {
+		collision_layer = p_collision_layer;
+		if (broadphase && monitorable && broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
+			broadphase->update_element_filter(broadphase_element);
+		}
+		_mark_changed();
+	}
+}
+
+void SGCollisionObject2DInternal::set_collision_mask(uint32_t p_collision_mask) {
+	if (collision_mask != p_collision_mask) {
+		collision_mask = p_collision_mask;
+		if (broadphase && monitorable && broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
+			broadphase->update_element_filter(broadphase_element);
+		}
+		_mark_changed();
+	}
 }
 
 SGCollisionObject2DInternal::SGCollisionObject2DInternal(ObjectType p_type) {
 	object_type = p_type;
 	world = nullptr;
 	broadphase = nullptr;
-	broadphase_element = nullptr;
+	broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
 	data = nullptr;
 	collision_layer = 1;
 	collision_mask = 1;
 	monitorable = true;
+	overlaps_dirty = false;
+	state_hash = 0;
+	state_hash_dirty = false;
 }
 
 SGCollisionObject2DInternal::~SGCollisionObject2DInternal() {
+	// Shapes can outlive the object they're attached to.
+	for (SGShape2DInternal *shape : shapes) {
+		shape->set_owner(nullptr);
+	}
 }
 
 SGArea2DInternal::SGArea2DInternal()
 	: SGCollisionObject2DInternal(OBJECT_AREA)
 {
+	overlaps_tracked = false;
 }
 
 SGArea2DInternal::~SGArea2DInternal() {
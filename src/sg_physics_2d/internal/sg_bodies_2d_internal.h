@@ -28,8 +28,10 @@
 
 #include "sg_shapes_2d_internal.h"
 #include "sg_broadphase_2d_internal.h"
+#include "sg_pool_internal.h"
 
 class SGWorld2DInternal;
+class SGArea2DInternal;
 
 class SGCollisionObject2DInternal {
 public:
@@ -42,28 +44,55 @@ public:
 private:
 	ObjectType object_type;
 	SGFixedTransform2DInternal transform;
+	// Where the object was last really moved to. While the world is testing
+	// a motion by moving it silently, this is where the motion started.
+	SGFixedVector2Internal motion_origin;
 	std::vector<SGShape2DInternal *> shapes;
 	SGWorld2DInternal *world;
 	SGBroadphase2DInternal *broadphase;
-	SGBroadphase2DInternal::Element *broadphase_element;
+	// The handle of the object's element in the broadphase, or NULL_ELEMENT.
+	int32_t broadphase_element;
 	void *data;
 
 	uint32_t collision_layer;
 	uint32_t collision_mask;
 	bool monitorable;
 
+	// Used by the world to keep the cached area overlaps up-to-date.
+	bool overlaps_dirty;
+	std::vector<SGArea2DInternal *> overlap_monitors;
+
+	// Used by the world to keep its state hash up-to-date. This is the hash
+	// the world last added in for this object.
+	uint64_t state_hash;
+	bool state_hash_dirty;
+
 	friend class SGWorld2DInternal;
 
 	_FORCE_INLINE_ void set_world(SGWorld2DInternal *p_world) {
 		world = p_world;
 	}
 
+	void _update_broadphase_element();
+	void _mark_changed();
+	uint64_t _compute_state_hash() const;
+
+	// Moves the object without updating the broadphase or letting the world
+	// know, for testing positions. set_transform() must be called when done.
+	void _set_transform_silently(const SGFixedTransform2DInternal &p_transform);
+
+	// Sets the transforms of the object and its shapes, without updating the
+	// broadphase or the overlap cache. Used when restoring world snapshots,
+	// which update those for all objects at once afterwards.
+	void _restore_transforms(const SGFixedTransform2DInternal &p_transform, const SGFixedTransform2DInternal *p_shape_transforms);
+
 public:
 	_FORCE_INLINE_ ObjectType get_object_type() const { return object_type; }
 	_FORCE_INLINE_ SGWorld2DInternal *get_world() const { return world; }
 
 	_FORCE_INLINE_ SGFixedTransform2DInternal get_transform() const { return transform; }
 	void set_transform(const SGFixedTransform2DInternal &p_transform);
+	_FORCE_INLINE_ SGFixedVector2Internal get_motion_origin() const { return motion_origin; }
 
 	void add_shape(SGShape2DInternal *p_shape);
 	void remove_shape(SGShape2DInternal *p_shape);
@@ -80,15 +109,20 @@ public:
 	_FORCE_INLINE_ void set_data(void *p_data) { data = p_data; }
 	_FORCE_INLINE_ void *get_data() const { return data; }
 
-	_FORCE_INLINE_ void set_collision_layer(uint32_t p_collision_layer) { collision_layer = p_collision_layer; }
+	void set_collision_layer(uint32_t p_collision_layer);
 	_FORCE_INLINE_ uint32_t get_collision_layer() const { return collision_layer; }
 
-	_FORCE_INLINE_ void set_collision_mask(uint32_t p_collision_mask) { collision_mask = p_collision_mask; }
+	void set_collision_mask(uint32_t p_collision_mask);
 	_FORCE_INLINE_ uint32_t get_collision_mask() const { return collision_mask; }
 
 	void set_monitorable(bool p_monitorable);
 	_FORCE_INLINE_ bool get_monitorable() { return monitorable; }
 
+	_FORCE_INLINE_ bool is_overlaps_dirty() const { return overlaps_dirty; }
+
+	// Called by shapes when they are changed while attached to this object.
+	void shape_changed(SGShape2DInternal *p_shape);
+
 	_FORCE_INLINE_ bool test_collision_layers(SGCollisionObject2DInternal *p_other) const {
 		return (collision_layer & p_other->collision_mask) || (p_other->collision_layer & collision_mask);
 	}
@@ -99,12 +133,35 @@ public:
 };
 
 class SGArea2DInternal : public SGCollisionObject2DInternal {
+	SG_POOL_ALLOCATED(SGArea2DInternal);
+
+public:
+	struct CachedOverlap {
+		SGCollisionObject2DInternal *object;
+		SGShape2DInternal *shape;
+
+		_FORCE_INLINE_ CachedOverlap(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_shape)
+			: object(p_object), shape(p_shape) { }
+	};
+
+private:
+	// Only set once something has asked the world for this area's cached
+	// overlaps, so that we don't maintain them for areas nobody looks at.
+	bool overlaps_tracked;
+	std::vector<CachedOverlap> cached_overlaps;
+
+	friend class SGWorld2DInternal;
+
 public:
+	_FORCE_INLINE_ bool is_tracking_overlaps() const { return overlaps_tracked; }
+
 	SGArea2DInternal();
 	~SGArea2DInternal();
 };
 
 class SGBody2DInternal : public SGCollisionObject2DInternal {
+	SG_POOL_ALLOCATED(SGBody2DInternal);
+
 public:
 
 	enum BodyType {
@@ -23,180 +23,623 @@
 
 #include "sg_broadphase_2d_internal.h"
 
+#include <algorithm>
+
+
+#include "sg_aabb_tree_broadphase_2d_internal.h"
 #include "sg_bodies_2d_internal.h"
 #include "sg_utils_internal.h"
 
-void SGBroadphase2DInternal::_add_element_to_cells(SGBroadphase2DInternal::Element *p_element) {
-	HashKey from = p_element->from;
-	HashKey to = p_element->to;
+SGBroadphase2DInternal *SGBroadphase2DInternal::create(BroadphaseType p_type, int p_cell_size) {
+	switch (p_type) {
+		case BROADPHASE_AABB_TREE:
+			return new SGAABBTreeBroadphase2DInternal();
 
-	for (int32_t x = from.x; x <= to.x; x++) {
-		for (int32_t y = from.y; y <= to.y; y++) {
-			HashKey key(x, y);
-			auto cell_iter = cells.find(key);
-			Cell *cell;
-
-			if (cell_iter != cells.end()) {
-				cell = cell_iter->second;
-			} else {
-				cell = new Cell();
-				cells.insert(std::make_pair(key, cell));
+		case BROADPHASE_SPATIAL_HASH:
+		default:
+			return new SGSpatialHashBroadphase2DInternal(p_cell_size);
+	}
+}
+
+int32_t SGBroadphase2DInternal::_allocate_element(SGCollisionObject2DInternal *p_object) {
+	int32_t element;
+	if (free_elements.size() > 0) {
+		element = free_elements.back();
+		free_elements.pop_back();
+	}
+	else {
+		element = element_objects.size();
+		element_objects.push_back(nullptr);
+		element_bounds.push_back(SGFixedRect2Internal());
+		element_fat_bounds.push_back(SGFixedRect2Internal());
+		element_filters.push_back(ElementFilter());
+		element_list_positions.push_back(-1);
+	}
+
+	element_objects[element] = p_object;
+	element_bounds[element] = p_object->get_bounds();
+	_reset_fat_bounds(element);
+	element_filters[element].type = p_object->get_object_type();
+	update_element_filter(element);
+
+	element_list_positions[element] = element_list.size();
+	element_list.push_back(element);
+
+	return element;
+}
+
+void SGBroadphase2DInternal::_free_element(int32_t p_element) {
+	int32_t position = element_list_positions[p_element];
+	int32_t last = element_list.back();
+	element_list[position] = last;
+	element_list_positions[last] = position;
+	element_list.pop_back();
+
+	element_objects[p_element] = nullptr;
+	element_list_positions[p_element] = -1;
+	free_elements.push_back(p_element);
+}
+
+void SGBroadphase2DInternal::update_element_filter(int32_t p_element) {
+	ElementFilter &filter = element_filters[p_element];
+	filter.collision_layer = element_objects[p_element]->get_collision_layer();
+	filter.collision_mask = element_objects[p_element]->get_collision_mask();
+}
+
+void SGBroadphase2DInternal::get_statistics(Statistics &r_statistics) const {
+	r_statistics.element_count = element_list.size();
+	r_statistics.cell_count = element_list.size();
+	r_statistics.cell_entry_count = element_list.size();
+	r_statistics.query_count = query_count.load(std::memory_order_relaxed);
+	r_statistics.query_candidate_count = query_candidate_count.load(std::memory_order_relaxed);
+}
+
+void SGBroadphase2DInternal::reset_query_statistics() {
+	query_count.store(0, std::memory_order_relaxed);
+	query_candidate_count.store(0, std::memory_order_relaxed);
+}
+
+void SGBroadphase2DInternal::_reset_fat_bounds(int32_t p_element) {
+	SGFixedRect2Internal &fat_bounds = element_fat_bounds[p_element];
+	fat_bounds = element_bounds[p_element];
+	if (margin > fixed::ZERO) {
+		fat_bounds.grow_by(margin);
+	}
+}
+
+bool SGBroadphase2DInternal::_update_element_bounds(int32_t p_element) {
+	element_bounds[p_element] = element_objects[p_element]->get_bounds();
+	if (margin > fixed::ZERO && element_fat_bounds[p_element].encloses(element_bounds[p_element])) {
+		return false;
+	}
+	_reset_fat_bounds(p_element);
+	return true;
+}
+
+bool SGBroadphase2DInternal::_segment_may_touch(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedRect2Internal &p_segment_bounds, const SGFixedRect2Internal &p_bounds) {
+	if (!p_segment_bounds.intersects(p_bounds)) {
+		return false;
+	}
+
+	// Check the corners furthest to either side of the segment, with a little
+	// leeway for the rounding in the cross products.
+	SGFixedVector2Internal min = p_bounds.get_min() - p_start - SGFixedVector2Internal(fixed(RAY_TOLERANCE), fixed(RAY_TOLERANCE));
+	SGFixedVector2Internal max = p_bounds.get_max() - p_start + SGFixedVector2Internal(fixed(RAY_TOLERANCE), fixed(RAY_TOLERANCE));
+	fixed left = p_cast_to.x * (p_cast_to.x > fixed::ZERO ? min.y : max.y) - p_cast_to.y * (p_cast_to.y > fixed::ZERO ? max.x : min.x);
+	fixed right = p_cast_to.x * (p_cast_to.x > fixed::ZERO ? max.y : min.y) - p_cast_to.y * (p_cast_to.y > fixed::ZERO ? min.x : max.x);
+	return left <= fixed::ZERO && right >= fixed::ZERO;
+}
+
+bool SGBroadphase2DInternal::_is_past_point(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedRect2Internal &p_bounds, const SGFixedVector2Internal &p_point) {
+	// The corner which is the least far along the ray.
+	fixed tolerance = fixed(_get_ray_tolerance(p_cast_to));
+	SGFixedVector2Internal min = p_bounds.get_min() - SGFixedVector2Internal(tolerance, tolerance);
+	SGFixedVector2Internal max = p_bounds.get_max() + SGFixedVector2Internal(tolerance, tolerance);
+	SGFixedVector2Internal corner(p_cast_to.x > fixed::ZERO ? min.x : max.x, p_cast_to.y > fixed::ZERO ? min.y : max.y);
+	return (corner - p_start).dot(p_cast_to) > (p_point - p_start).dot(p_cast_to);
+}
+
+int32_t SGSpatialHashBroadphase2DInternal::_find_cell(HashKey p_key) const {
+	uint32_t index = p_key.hash() & table_mask;
+	while (true) {
+		const Slot &slot = table[index];
+		if (slot.cell == NULL_CELL) {
+			return NULL_CELL;
+		}
+		if (slot.key == p_key) {
+			return slot.cell;
+		}
+		index = (index + 1) & table_mask;
+	}
+}
+
+int32_t SGSpatialHashBroadphase2DInternal::_find_or_create_cell(HashKey p_key) {
+	// Keep the load factor at or below 1/2, so probe sequences stay short.
+	if ((table_used + 1) * 2 > table.size()) {
+		_resize_table(table.size() * 2);
+	}
+
+	uint32_t index = p_key.hash() & table_mask;
+	while (true) {
+		Slot &slot = table[index];
+		if (slot.cell == NULL_CELL) {
+			break;
+		}
+		if (slot.key == p_key) {
+			return slot.cell;
+		}
+		index = (index + 1) & table_mask;
+	}
+
+	int32_t cell;
+	if (free_cell != NULL_CELL) {
+		cell = free_cell;
+		free_cell = cell_pool[cell].next_free;
+	} else {
+		cell = cell_pool.size();
+		cell_pool.push_back(Cell());
+	}
+	cell_pool[cell].next_free = NULL_CELL;
+
+	table[index].key = p_key;
+	table[index].cell = cell;
+	table_used++;
+
+	return cell;
+}
+
+void SGSpatialHashBroadphase2DInternal::_erase_cell(HashKey p_key) {
+	uint32_t index = p_key.hash() & table_mask;
+	while (true) {
+		if (table[index].cell == NULL_CELL) {
+			return;
+		}
+		if (table[index].key == p_key) {
+			break;
+		}
+		index = (index + 1) & table_mask;
+	}
+
+	// Return the cell to the pool, keeping its element list's capacity.
+	int32_t cell = table[index].cell;
+	cell_pool[cell].elements.clear();
+	cell_pool[cell].next_free = free_cell;
+	free_cell = cell;
+	table_used--;
+
+	// Backward shift deletion: rather than leaving a tombstone, move later
+	// entries in the probe sequence back into the hole.
+	uint32_t hole = index;
+	uint32_t next = index;
+	while (true) {
+		table[hole].cell = NULL_CELL;
+
+		while (true) {
+			next = (next + 1) & table_mask;
+			if (table[next].cell == NULL_CELL) {
+				return;
+			}
+
+			// Entries whose home slot is cyclically within (hole, next] must stay put.
+			uint32_t home = table[next].key.hash() & table_mask;
+			if (hole <= next ? (hole < home && home <= next) : (hole < home || home <= next)) {
+				continue;
 			}
 
-			cell->elements.push_back(p_element);
+			table[hole] = table[next];
+			hole = next;
+			break;
 		}
 	}
 }
 
-void SGBroadphase2DInternal::_remove_element_from_cells(SGBroadphase2DInternal::Element *p_element) {
-	HashKey from = p_element->from;
-	HashKey to = p_element->to;
+void SGSpatialHashBroadphase2DInternal::_resize_table(uint32_t p_capacity) {
+	std::vector<Slot> old_table;
+	old_table.swap(table);
+
+	Slot empty;
+	empty.key = HashKey((uint64_t)0);
+	empty.cell = NULL_CELL;
+
+	table.resize(p_capacity, empty);
+	table_mask = p_capacity - 1;
+
+	for (const Slot &slot : old_table) {
+		if (slot.cell == NULL_CELL) {
+			continue;
+		}
+		uint32_t index = slot.key.hash() & table_mask;
+		while (table[index].cell != NULL_CELL) {
+			index = (index + 1) & table_mask;
+		}
+		table[index] = slot;
+	}
+}
+
+void SGSpatialHashBroadphase2DInternal::_add_element_to_cells(int32_t p_element) {
+	HashKey from = element_from[p_element];
+	HashKey to = element_to[p_element];
+	cell_entry_count += ((int64_t)to.x - from.x + 1) * ((int64_t)to.y - from.y + 1);
+
+	for (int32_t x = from.x; x <= to.x; x++) {
+		for (int32_t y = from.y; y <= to.y; y++) {
+			int32_t cell = _find_or_create_cell(HashKey(x, y));
+			cell_pool[cell].elements.push_back(p_element);
+		}
+	}
+}
+
+void SGSpatialHashBroadphase2DInternal::_remove_element_from_cells(int32_t p_element) {
+	HashKey from = element_from[p_element];
+	HashKey to = element_to[p_element];
+	cell_entry_count -= ((int64_t)to.x - from.x + 1) * ((int64_t)to.y - from.y + 1);
 
 	for (int32_t x = from.x; x <= to.x; x++) {
 		for (int32_t y = from.y; y <= to.y; y++) {
 			HashKey key(x, y);
-			auto cell_iter = cells.find(key);
+			int32_t cell = _find_cell(key);
 
-			if (cell_iter == cells.end()) {
+			if (cell == NULL_CELL) {
 				continue;
 			}
 
-			Cell *cell = cell_iter->second;
-			sg_remove_by_value(cell->elements, p_element);
+			std::vector<int32_t> &cell_elements = cell_pool[cell].elements;
+			sg_remove_by_value(cell_elements, p_element);
 
-			if (cell->elements.size() == 0) {
-				cells.erase(key);
-				delete cell;
+			if (cell_elements.size() == 0) {
+				_erase_cell(key);
 			}
 		}
 	}
 }
 
-void SGBroadphase2DInternal::_clear_cells() {
-	for (auto i : cells) {
-		delete i.second;
+void SGSpatialHashBroadphase2DInternal::_clear_cells() {
+	for (Slot &slot : table) {
+		if (slot.cell != NULL_CELL) {
+			cell_pool[slot.cell].elements.clear();
+			cell_pool[slot.cell].next_free = free_cell;
+			free_cell = slot.cell;
+			slot.cell = NULL_CELL;
+		}
 	}
-	cells.clear();
+	table_used = 0;
+	cell_entry_count = 0;
 }
 
-SGBroadphase2DInternal::Element *SGBroadphase2DInternal::create_element(SGCollisionObject2DInternal *p_object) {
-	SGBroadphase2DInternal::Element *element = new SGBroadphase2DInternal::Element();
-	elements.push_back(element);
-
-	element->object = p_object;
-	element->bounds = p_object->get_bounds();
-
-	SGFixedVector2Internal min = element->bounds.get_min();
-	SGFixedVector2Internal max = element->bounds.get_max();
+int32_t SGSpatialHashBroadphase2DInternal::create_element(SGCollisionObject2DInternal *p_object) {
+	int32_t element = _allocate_element(p_object);
+	if (element == (int32_t)element_from.size()) {
+		element_from.push_back(HashKey((uint64_t)0));
+		element_to.push_back(HashKey((uint64_t)0));
+	}
 
-	element->from = HashKey(
-		min.x.to_int() / cell_size,
-		min.y.to_int() / cell_size);
-	element->to = HashKey(
-		max.x.to_int() / cell_size,
-		max.y.to_int() / cell_size);
+	element_from[element] = _get_min_key(element_fat_bounds[element]);
+	element_to[element] = _get_max_key(element_fat_bounds[element]);
 
 	_add_element_to_cells(element);
 
 	return element;
 }
 
-void SGBroadphase2DInternal::update_element(SGBroadphase2DInternal::Element *p_element) {
-	p_element->bounds = p_element->object->get_bounds();
-
-	SGFixedVector2Internal min = p_element->bounds.get_min();
-	SGFixedVector2Internal max = p_element->bounds.get_max();
-
-	HashKey from(
-		min.x.to_int() / cell_size,
-		min.y.to_int() / cell_size);
-	HashKey to(
-		max.x.to_int() / cell_size,
-		max.y.to_int() / cell_size);
+void SGSpatialHashBroadphase2DInternal::update_element(int32_t p_element) {
+	if (!_update_element_bounds(p_element)) {
+		return;
+	}
 
+	HashKey from = _get_min_key(element_fat_bounds[p_element]);
+	HashKey to = _get_max_key(element_fat_bounds[p_element]);
 
-	if (p_element->from == from && p_element->to == to) {
+	if (element_from[p_element] == from && element_to[p_element] == to) {
 		return;
 	}
 
 	_remove_element_from_cells(p_element);
 
-	p_element->from = from;
-	p_element->to = to;
+	element_from[p_element] = from;
+	element_to[p_element] = to;
 
 	_add_element_to_cells(p_element);
 }
 
-void SGBroadphase2DInternal::delete_element(SGBroadphase2DInternal::Element *p_element) {
+void SGSpatialHashBroadphase2DInternal::delete_element(int32_t p_element) {
 	_remove_element_from_cells(p_element);
-	sg_remove_by_value(elements, p_element);
-	delete p_element;
+	_free_element(p_element);
 }
 
-void SGBroadphase2DInternal::find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type) const {
-	SGFixedVector2Internal min = p_bounds.get_min();
-	SGFixedVector2Internal max = p_bounds.get_max();
-
-	HashKey from(
-		min.x.to_int() / cell_size,
-		min.y.to_int() / cell_size);
-	HashKey to(
-		max.x.to_int() / cell_size,
-		max.y.to_int() / cell_size);
-
-	uint64_t query_id = (++current_query_id);
+void SGSpatialHashBroadphase2DInternal::find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	HashKey from = _get_min_key(p_bounds);
+	HashKey to = _get_max_key(p_bounds);
+	uint64_t candidates = 0;
 
 	for (int32_t x = from.x; x <= to.x; x++) {
 		for (int32_t y = from.y; y <= to.y; y++) {
-			HashKey key(x, y);
-			auto cell_iter = cells.find(key);
+			int32_t cell = _find_cell(HashKey(x, y));
 
-			if (cell_iter == cells.end()) {
+			if (cell == NULL_CELL) {
 				continue;
 			}
 
-			for (SGBroadphase2DInternal::Element *element : cell_iter->second->elements) {
-				if (element->query_id == query_id) {
+			candidates += cell_pool[cell].elements.size();
+			for (int32_t element : cell_pool[cell].elements) {
+				// Elements spanning several cells are only reported from the
+				// first of them that the query visits. This needs no state
+				// to be written, so queries can run concurrently.
+				HashKey element_from_key = element_from[element];
+				if (x != MAX(element_from_key.x, from.x) || y != MAX(element_from_key.y, from.y)) {
 					continue;
 				}
-				if ((element->object->get_object_type() & p_type) && p_bounds.intersects(element->bounds)) {
-					element->query_id = query_id;
-					p_result_handler->handle_result(element->object, nullptr);
+				if (!element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+					continue;
 				}
+				if (!p_bounds.intersects(element_bounds[element])) {
+					continue;
+				}
+				p_result_handler->handle_result(element_objects[element], nullptr);
 			}
 		}
 	}
+
+	_count_query(candidates);
+}
+
+// Returns the sign of p_a * p_b - p_c * p_d, without any overflow.
+static _FORCE_INLINE_ int sg_compare_products(int64_t p_a, int64_t p_b, int64_t p_c, int64_t p_d) {
+	int64_t high1, high2;
+	uint64_t low1, low2;
+	sg_mul_64_128(p_a, p_b, high1, low1);
+	sg_mul_64_128(p_c, p_d, high2, low2);
+	if (high1 != high2) {
+		return high1 < high2 ? -1 : 1;
+	}
+	if (low1 != low2) {
+		return low1 < low2 ? -1 : 1;
+	}
+	return 0;
 }
 
-void SGBroadphase2DInternal::set_cell_size(int p_cell_size) {
+void SGSpatialHashBroadphase2DInternal::find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	SGFixedVector2Internal end = p_start + p_cast_to;
+	SGFixedRect2Internal segment_bounds(p_start, SGFixedVector2Internal());
+	segment_bounds.expand_to(end);
+	HashKey from = _get_min_key(segment_bounds);
+	HashKey to = _get_max_key(segment_bounds);
+
+	// Walk the cells the segment passes through, in order (Amanatides & Woo).
+	int32_t cell[2] = { (int32_t)(p_start.x.to_int() / cell_size), (int32_t)(p_start.y.to_int() / cell_size) };
+	int32_t end_cell[2] = { (int32_t)(end.x.to_int() / cell_size), (int32_t)(end.y.to_int() / cell_size) };
+	int32_t step[2];
+	for (int axis = 0; axis < 2; axis++) {
+		step[axis] = p_cast_to[axis] > fixed::ZERO ? 1 : (p_cast_to[axis] < fixed::ZERO ? -1 : 0);
+	}
+
+	int64_t tolerance = _get_ray_tolerance(p_cast_to);
+
+	HashKey previous((uint64_t)0);
+	bool first = true;
+	uint64_t candidates = 0;
+	while (true) {
+		HashKey key(cell[0], cell[1]);
+		int32_t cell_index = _find_cell(key);
+		if (cell_index != NULL_CELL) {
+			candidates += cell_pool[cell_index].elements.size();
+			for (int32_t element : cell_pool[cell_index].elements) {
+				// A line passes through any rectangle of cells in one go, so
+				// elements spanning several cells are only reported if the
+				// previous cell wasn't one of them.
+				if (!first) {
+					HashKey element_from_key = element_from[element];
+					HashKey element_to_key = element_to[element];
+					if (previous.x >= element_from_key.x && previous.x <= element_to_key.x && previous.y >= element_from_key.y && previous.y <= element_to_key.y) {
+						continue;
+					}
+				}
+				if (!element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+					continue;
+				}
+				if (!_segment_may_touch(p_start, p_cast_to, segment_bounds, element_bounds[element])) {
+					continue;
+				}
+				p_result_handler->handle_result(element_objects[element], nullptr);
+			}
+		}
+
+		if (cell[0] == end_cell[0] && cell[1] == end_cell[1]) {
+			break;
+		}
+
+		// Find the side the segment leaves the cell through first, by
+		// comparing (side - start) / cast_to for both axes exactly.
+		fixed side[2];
+		for (int axis = 0; axis < 2; axis++) {
+			side[axis] = _get_cell_start(step[axis] > 0 ? cell[axis] + 1 : cell[axis]);
+		}
+		int axis;
+		bool corner = false;
+		if (step[0] == 0) {
+			axis = 1;
+		}
+		else if (step[1] == 0) {
+			axis = 0;
+		}
+		else {
+			int order = sg_compare_products((side[0].value - p_start.x.value) * step[0], p_cast_to.y.value * step[1], (side[1].value - p_start.y.value) * step[1], p_cast_to.x.value * step[0]);
+			if (order != 0) {
+				axis = order < 0 ? 0 : 1;
+			}
+			else if (step[0] == step[1]) {
+				// Straight through the corner.
+				axis = 0;
+				corner = true;
+			}
+			else {
+				// Cells include their lower sides, so when going up one axis
+				// and down the other, the segment touches the cell beside
+				// this one before carrying on diagonally.
+				axis = step[0] > 0 ? 0 : 1;
+			}
+		}
+
+		// Stop if the closest hit is before the next cell starts.
+		SGFixedVector2Internal hit;
+		if (p_result_handler->get_closest_hit(hit)) {
+			if (step[axis] > 0 ? hit[axis].value < side[axis].value - tolerance : hit[axis].value >= side[axis].value + tolerance) {
+				break;
+			}
+		}
+
+		previous = key;
+		first = false;
+		cell[axis] += step[axis];
+		if (corner) {
+			cell[1] += step[1];
+		}
+
+		// Only a safety net, in case of a bug in the above.
+		if (cell[0] < from.x || cell[0] > to.x || cell[1] < from.y || cell[1] > to.y) {
+			break;
+		}
+	}
+
+	_count_query(candidates);
+}
+
+void SGSpatialHashBroadphase2DInternal::_rebuild_cells() {
+	_clear_cells();
+	for (int32_t element : element_list) {
+		element_from[element] = _get_min_key(element_fat_bounds[element]);
+		element_to[element] = _get_max_key(element_fat_bounds[element]);
+		_add_element_to_cells(element);
+	}
+}
+
+void SGSpatialHashBroadphase2DInternal::set_cell_size(int p_cell_size) {
 	if (cell_size != p_cell_size) {
 		cell_size = p_cell_size;
+		_rebuild_cells();
+	}
+}
 
-		_clear_cells();
-		for (SGBroadphase2DInternal::Element *element : elements) {
-			SGFixedVector2Internal min = element->bounds.get_min();
-			SGFixedVector2Internal max = element->bounds.get_max();
+void SGSpatialHashBroadphase2DInternal::set_margin(fixed p_margin) {
+	if (margin != p_margin) {
+		margin = p_margin;
+		rebuild();
+	}
+}
+
+void SGSpatialHashBroadphase2DInternal::rebuild() {
+	for (int32_t element : element_list) {
+		element_bounds[element] = element_objects[element]->get_bounds();
+		_reset_fat_bounds(element);
+	}
+	_rebuild_cells();
+}
 
-			element->from = HashKey(
-				min.x.to_int() / cell_size,
-				min.y.to_int() / cell_size);
-			element->to = HashKey(
-				max.x.to_int() / cell_size,
-				max.y.to_int() / cell_size);
+void SGSpatialHashBroadphase2DInternal::get_statistics(Statistics &r_statistics) const {
+	SGBroadphase2DInternal::get_statistics(r_statistics);
+	r_statistics.cell_count = table_used;
+	r_statistics.cell_entry_count = cell_entry_count;
+}
 
-			_add_element_to_cells(element);
+int64_t SGSpatialHashBroadphase2DInternal::_estimate_cost(int p_cell_size, int64_t p_max_cell_entries, std::vector<uint64_t> &r_keys) const {
+	// Use the exact bounds grown by the margin, rather than the fat bounds,
+	// which depend on how the elements got to where they are (for example,
+	// loading a snapshot resets them).
+	int64_t entries = 0;
+	for (int32_t element : element_list) {
+		SGFixedRect2Internal bounds = element_bounds[element];
+		if (margin > fixed::ZERO) {
+			bounds.grow_by(margin);
+		}
+		HashKey from = _get_min_key(bounds, p_cell_size);
+		HashKey to = _get_max_key(bounds, p_cell_size);
+		entries += ((int64_t)to.x - from.x + 1) * ((int64_t)to.y - from.y + 1);
+		if (entries > p_max_cell_entries) {
+			return -1;
 		}
 	}
+
+	r_keys.clear();
+	r_keys.reserve(entries);
+	for (int32_t element : element_list) {
+		SGFixedRect2Internal bounds = element_bounds[element];
+		if (margin > fixed::ZERO) {
+			bounds.grow_by(margin);
+		}
+		HashKey from = _get_min_key(bounds, p_cell_size);
+		HashKey to = _get_max_key(bounds, p_cell_size);
+		for (int32_t x = from.x; x <= to.x; x++) {
+			for (int32_t y = from.y; y <= to.y; y++) {
+				r_keys.push_back(HashKey(x, y).key);
+			}
+		}
+	}
+	std::sort(r_keys.begin(), r_keys.end());
+
+	// If every element were used as a query, each would look up all of its
+	// cells, and look at every element in them. Looking a cell up costs
+	// roughly as much as looking at a few elements.
+	int64_t cost = 0;
+	std::size_t run_start = 0;
+	for (std::size_t i = 1; i <= r_keys.size(); i++) {
+		if (i == r_keys.size() || r_keys[i] != r_keys[run_start]) {
+			int64_t occupancy = i - run_start;
+			cost += occupancy * (occupancy + 4);
+			run_start = i;
+		}
+	}
+	return cost;
 }
 
-SGBroadphase2DInternal::SGBroadphase2DInternal(int p_cell_size) {
+int SGSpatialHashBroadphase2DInternal::find_best_cell_size() const {
+	if (element_list.size() == 0) {
+		return cell_size;
+	}
+
+	// Cells so small that elements are in dozens of them are never worth it,
+	// and would take a lot of memory to estimate.
+	int64_t max_cell_entries = (int64_t)element_list.size() * 16;
+	std::vector<uint64_t> keys;
+
+	int64_t current_cost = _estimate_cost(cell_size, max_cell_entries, keys);
+
+	// Steps of about the square root of 2, going down from the largest,
+	// since once elements are in too many cells they can only be in more.
+	// The cost only has one low point, so stop once it's well past it.
+	int sizes[32];
+	int size_count = 0;
+	for (int size = MIN_TUNED_CELL_SIZE; size <= MAX_TUNED_CELL_SIZE; size = (size_count % 2 == 1) ? size * 3 / 2 : size * 4 / 3) {
+		sizes[size_count++] = size;
+	}
+
+	int best_size = cell_size;
+	int64_t best_cost = -1;
+	for (int i = size_count - 1; i >= 0; i--) {
+		int64_t cost = _estimate_cost(sizes[i], max_cell_entries, keys);
+		if (cost < 0 || (best_cost >= 0 && cost > best_cost * 2)) {
+			break;
+		}
+		if (best_cost < 0 || cost < best_cost) {
+			best_size = sizes[i];
+			best_cost = cost;
+		}
+	}
+
+	// Only switch if it's at least an eighth cheaper.
+	if (best_cost < 0 || (current_cost >= 0 && best_cost * 8 > current_cost * 7)) {
+		return cell_size;
+	}
+	return best_size;
+}
+
+SGSpatialHashBroadphase2DInternal::SGSpatialHashBroadphase2DInternal(int p_cell_size) {
 	cell_size = p_cell_size;
-	current_query_id = 0;
+	cell_entry_count = 0;
+
+	table_used = 0;
+	free_cell = NULL_CELL;
+	_resize_table(INITIAL_TABLE_SIZE);
 }
 
-SGBroadphase2DInternal::~SGBroadphase2DInternal() {
+SGSpatialHashBroadphase2DInternal::~SGSpatialHashBroadphase2DInternal() {
 	_clear_cells();
-	for (SGBroadphase2DInternal::Element *element : elements) {
-		delete element;
-	}
 }
@@ -24,13 +24,173 @@
 #ifndef SG_BROADPHASE_2D_INTERNAL_H
 #define SG_BROADPHASE_2D_INTERNAL_H
 
+#include <atomic>
 #include <vector>
-#include <unordered_map>
 
 #include "sg_fixed_rect2_internal.h"
 #include "sg_result_handler_internal.h"
 
 class SGBroadphase2DInternal {
+public:
+
+	enum BroadphaseType {
+		BROADPHASE_SPATIAL_HASH,
+		BROADPHASE_AABB_TREE,
+		// Only used for the partition of a world holding its static bodies.
+		BROADPHASE_STATIC,
+	};
+
+	static const int32_t NULL_ELEMENT = -1;
+
+	// A copy of what queries filter on, so that candidates which get rejected
+	// never have to touch their object.
+	struct ElementFilter {
+		uint32_t collision_layer;
+		uint32_t collision_mask;
+		int type;
+
+		// Same as SGCollisionObject2DInternal::test_collision_layers().
+		_FORCE_INLINE_ bool passes(int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+			return (type & p_type) && ((collision_layer & p_collision_mask) || (p_collision_layer & collision_mask));
+		}
+	};
+
+	struct Statistics {
+		int element_count;
+		// The cells with something in them. Broadphases that aren't divided
+		// into cells count each element as being in a cell of its own.
+		int64_t cell_count;
+		// The total of how many cells each element is in.
+		int64_t cell_entry_count;
+		// Since the query statistics were last reset.
+		uint64_t query_count;
+		// The elements queries looked at, before filtering them on their
+		// bounds, type and collision layers.
+		uint64_t query_candidate_count;
+	};
+
+protected:
+	// Elements are stored as parallel arrays, indexed by a handle which stays
+	// the same for as long as the element exists. Queries scanning lots of
+	// candidates then read their bounds packed together, rather than
+	// following a pointer to a separate allocation for each of them.
+	std::vector<SGCollisionObject2DInternal *> element_objects;
+	// The exact bounds of the object, which queries are filtered against.
+	std::vector<SGFixedRect2Internal> element_bounds;
+	// The bounds grown by the margin, which is what's actually stored in the
+	// broadphase's cells or nodes.
+	std::vector<SGFixedRect2Internal> element_fat_bounds;
+	std::vector<ElementFilter> element_filters;
+	// Where each element is in the list of live elements.
+	std::vector<int32_t> element_list_positions;
+
+	// The live elements, in the order they're rebuilt in. Deleting swaps the
+	// last element into the gap, so the order only depends on the history.
+	std::vector<int32_t> element_list;
+	std::vector<int32_t> free_elements;
+
+	fixed margin;
+
+	// Queries can run concurrently, so they only add to these once, when
+	// they're done.
+	mutable std::atomic<uint64_t> query_count;
+	mutable std::atomic<uint64_t> query_candidate_count;
+
+	_FORCE_INLINE_ void _count_query(uint64_t p_candidates) const {
+		query_count.fetch_add(1, std::memory_order_relaxed);
+		query_candidate_count.fetch_add(p_candidates, std::memory_order_relaxed);
+	}
+
+	// Takes a free handle (or adds one) and fills in the object and bounds.
+	int32_t _allocate_element(SGCollisionObject2DInternal *p_object);
+	void _free_element(int32_t p_element);
+
+	// Refreshes the element's bounds from its object, and returns true if
+	// they've left its fat bounds (which are then recomputed), meaning that
+	// the element needs to be moved within the broadphase.
+	bool _update_element_bounds(int32_t p_element);
+	void _reset_fat_bounds(int32_t p_element);
+
+	// How far (in raw fixed-point units) apart points on a ray need to be
+	// before one is considered to be further along, to be sure about it
+	// despite the rounding in intersection points.
+	static const int64_t RAY_TOLERANCE = 64;
+
+	// Intersection points are found as a fraction of the ray, so their
+	// rounding grows with its length: allow for a few steps of that fraction
+	// on top of RAY_TOLERANCE.
+	_FORCE_INLINE_ static int64_t _get_ray_tolerance(const SGFixedVector2Internal &p_cast_to) {
+		return RAY_TOLERANCE + ((p_cast_to.x.abs().value + p_cast_to.y.abs().value) >> 14);
+	}
+
+	// Whether p_bounds could touch the segment from p_start to p_start + p_cast_to:
+	// it has to overlap the segment's bounds, and can't be entirely on
+	// one side of it.
+	static bool _segment_may_touch(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedRect2Internal &p_segment_bounds, const SGFixedRect2Internal &p_bounds);
+
+	// Whether all of p_bounds is further along the ray than p_point.
+	static bool _is_past_point(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedRect2Internal &p_bounds, const SGFixedVector2Internal &p_point);
+
+public:
+	virtual BroadphaseType get_broadphase_type() const = 0;
+
+	virtual int32_t create_element(SGCollisionObject2DInternal *p_object) = 0;
+	virtual void update_element(int32_t p_element) = 0;
+	virtual void delete_element(int32_t p_element) = 0;
+
+	_FORCE_INLINE_ SGCollisionObject2DInternal *get_element_object(int32_t p_element) const { return element_objects[p_element]; }
+	_FORCE_INLINE_ const SGFixedRect2Internal &get_element_bounds(int32_t p_element) const { return element_bounds[p_element]; }
+	_FORCE_INLINE_ int get_element_count() const { return element_list.size(); }
+
+	// Needs to be called whenever the object's collision layer or mask change.
+	void update_element_filter(int32_t p_element);
+
+	// p_type is really SGCollisionObject2DInternal::ObjectType, but I couldn't work out the circulate dependencies.
+	//
+	// Only objects whose layer is in p_collision_mask, or whose mask includes
+	// something in p_collision_layer, are found. By default, that's anything
+	// which could collide with something.
+	//
+	// Queries don't modify the broadphase, so any number of them can run at
+	// the same time from different threads, as long as nothing is being
+	// added, updated or deleted.
+	virtual void find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const = 0;
+
+	// Like find_nearby(), but for the elements near the segment from p_start
+	// to p_start + p_cast_to. Stops once nothing left could be closer than
+	// the closest hit that p_result_handler has found so far.
+	virtual void find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const = 0;
+
+	// Only meaningful for broadphases that are partitioned into cells.
+	virtual void set_cell_size(int p_cell_size) { }
+	virtual int get_cell_size() const { return 0; }
+
+	// For tuning the broadphase, not for anything that needs to be kept in
+	// sync between peers: the query statistics depend on what's been
+	// queried, including any frames that were simulated again after a
+	// rollback.
+	virtual void get_statistics(Statistics &r_statistics) const;
+	void reset_query_statistics();
+
+	// Elements are stored with their bounds grown by this margin, and are
+	// only moved within the broadphase once their bounds leave that area.
+	// Objects idling or jittering in place then cost nearly nothing.
+	virtual void set_margin(fixed p_margin) = 0;
+	_FORCE_INLINE_ fixed get_margin() const { return margin; }
+
+	// Refreshes the bounds of every element from its object and rebuilds the
+	// broadphase from scratch. Cheaper than updating each element when most
+	// of the objects have been moved at once.
+	virtual void rebuild() = 0;
+
+	SGBroadphase2DInternal() : query_count(0), query_candidate_count(0) { margin = fixed::ZERO; }
+
+	static SGBroadphase2DInternal *create(BroadphaseType p_type, int p_cell_size);
+
+	virtual ~SGBroadphase2DInternal() { }
+};
+
+class SGSpatialHashBroadphase2DInternal : public SGBroadphase2DInternal {
 public:
 
 	struct HashKey {
@@ -56,52 +216,116 @@ public:
 		_FORCE_INLINE_ bool operator==(HashKey p_other) const { return key == p_other.key; }
 		_FORCE_INLINE_ bool operator<(HashKey p_other) const { return key < p_other.key; }
 
-		struct HashFunction {
-			_FORCE_INLINE_ size_t operator()(const HashKey &key) const {
-				return key.key;
-			}
-		};
-	};
-
-	struct Element {
-		SGCollisionObject2DInternal *object;
-		SGFixedRect2Internal bounds;
-		HashKey from;
-		HashKey to;
-		uint64_t query_id;
-
-		_FORCE_INLINE_ Element() {
-			object = nullptr;
-			query_id = 0;
+		_FORCE_INLINE_ uint32_t hash() const {
+			// Mix the bits (MurmurHash3's finalizer), since neighboring cells
+			// have nearly identical keys, which is terrible for linear probing.
+			uint64_t h = key;
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ULL;
+			h ^= h >> 33;
+			return (uint32_t)h;
 		}
 	};
 
+	// Cells are never freed, only returned to the pool, so that their element
+	// lists keep their capacity and moving objects don't cause any allocation
+	// once the world has warmed up.
 	struct Cell {
-		std::vector<Element *> elements;
+		std::vector<int32_t> elements;
+		int32_t next_free;
 	};
 
+	static const int32_t NULL_CELL = -1;
+	static const uint32_t INITIAL_TABLE_SIZE = 256;
+
+	// The range of cell sizes find_best_cell_size() picks from.
+	static const int MIN_TUNED_CELL_SIZE = 16;
+	static const int MAX_TUNED_CELL_SIZE = 4096;
+
 private:
-	std::vector<Element *> elements;
-	std::unordered_map<HashKey, Cell *, HashKey::HashFunction> cells;
+	// An open-addressing hash table (with linear probing) mapping cell keys
+	// to indexes in the cell pool.
+	struct Slot {
+		HashKey key;
+		int32_t cell;
+	};
+
+	std::vector<Slot> table;
+	uint32_t table_mask;
+	uint32_t table_used;
+
+	std::vector<Cell> cell_pool;
+	int32_t free_cell;
+
 	int cell_size;
-	mutable uint64_t current_query_id;
+	int64_t cell_entry_count;
+
+	// The range of cells each element is in, indexed by its handle.
+	std::vector<HashKey> element_from;
+	std::vector<HashKey> element_to;
 
-	void _add_element_to_cells(Element *p_element);
-	void _remove_element_from_cells(Element *p_element);
+	int32_t _find_cell(HashKey p_key) const;
+	int32_t _find_or_create_cell(HashKey p_key);
+	void _erase_cell(HashKey p_key);
+	void _resize_table(uint32_t p_capacity);
+
+	void _add_element_to_cells(int32_t p_element);
+	void _remove_element_from_cells(int32_t p_element);
 	void _clear_cells();
+	void _rebuild_cells();
+
+	_FORCE_INLINE_ static HashKey _get_min_key(const SGFixedRect2Internal &p_bounds, int p_cell_size) {
+		SGFixedVector2Internal min = p_bounds.get_min();
+		return HashKey(min.x.to_int() / p_cell_size, min.y.to_int() / p_cell_size);
+	}
+
+	_FORCE_INLINE_ static HashKey _get_max_key(const SGFixedRect2Internal &p_bounds, int p_cell_size) {
+		SGFixedVector2Internal max = p_bounds.get_max();
+		return HashKey(max.x.to_int() / p_cell_size, max.y.to_int() / p_cell_size);
+	}
+
+	_FORCE_INLINE_ HashKey _get_min_key(const SGFixedRect2Internal &p_bounds) const { return _get_min_key(p_bounds, cell_size); }
+	_FORCE_INLINE_ HashKey _get_max_key(const SGFixedRect2Internal &p_bounds) const { return _get_max_key(p_bounds, cell_size); }
+
+	// What it would cost to use the given cell size, or -1 if each element
+	// would be in more than p_max_cell_entries cells on average.
+	int64_t _estimate_cost(int p_cell_size, int64_t p_max_cell_entries, std::vector<uint64_t> &r_keys) const;
+
+	// Where cells start along either axis. Keys are rounded towards zero, so
+	// the cells either side of zero are one unit shorter than the rest.
+	_FORCE_INLINE_ fixed _get_cell_start(int32_t p_cell) const {
+		return fixed::from_int(p_cell > 0 ? (int64_t)p_cell * cell_size : ((int64_t)p_cell - 1) * cell_size + 1);
+	}
 
 public:
-	Element *create_element(SGCollisionObject2DInternal *p_object);
-	void update_element(Element *p_element);
-	void delete_element(Element *p_element);
+	virtual BroadphaseType get_broadphase_type() const override { return BROADPHASE_SPATIAL_HASH; }
 
-	// p_type is really SGCollisionObject2DInternal::ObjectType, but I couldn't work out the circulate dependencies.
-	void find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type = 3) const;
+	virtual int32_t create_element(SGCollisionObject2DInternal *p_object) override;
+	virtual void update_element(int32_t p_element) override;
+	virtual void delete_element(int32_t p_element) override;
+
+	virtual void find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+	virtual void find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+
+	virtual void set_cell_size(int p_cell_size) override;
+	virtual int get_cell_size() const override { return cell_size; }
+	virtual void set_margin(fixed p_margin) override;
+	virtual void rebuild() override;
+
+	virtual void get_statistics(Statistics &r_statistics) const override;
 
-	void set_cell_size(int p_cell_size);
+	// Estimates which cell size would make the broadphase cheapest to
+	// maintain and query, given the elements it has now. This only looks at
+	// their bounds (and not at the query statistics), so it gives the same
+	// answer on every peer whose world is in the same state. The current
+	// size is kept unless another is clearly better, so that calling this
+	// regularly doesn't flip back and forth between two sizes.
+	int find_best_cell_size() const;
 
-	SGBroadphase2DInternal(int p_cell_size);
-	~SGBroadphase2DInternal();
+	SGSpatialHashBroadphase2DInternal(int p_cell_size);
+	~SGSpatialHashBroadphase2DInternal();
 };
 
 #endif
@@ -51,7 +51,7 @@ Interval SGCollisionDetector2DInternal::get_interval(const SGShape2DInternal &sh
 		const SGCapsule2DInternal& capsule = (const SGCapsule2DInternal&)shape;
 		SGFixedTransform2DInternal t = shape.get_global_transform();
 		const fixed scaled_radius = capsule.get_radius() * t.get_scale().x;
-		const std::vector<SGFixedVector2Internal> verts = capsule.get_global_vertices();
+		const std::vector<SGFixedVector2Internal> &verts = capsule.get_global_vertices();
 		result.min = axis.dot(verts[0]);
 		result.max = axis.dot(verts[1]);
 		if (result.min > result.max) {
@@ -61,7 +61,7 @@ Interval SGCollisionDetector2DInternal::get_interval(const SGShape2DInternal &sh
 		result.max += scaled_radius;
 	}
 	else {
-		std::vector<SGFixedVector2Internal> verts = shape.get_global_vertices();
+		const std::vector<SGFixedVector2Internal> &verts = shape.get_global_vertices();
 		result.min = result.max = axis.dot(verts[0]);
 		for (std::size_t i = 1; i < verts.size(); i++) {
 			fixed projection = axis.dot(verts[i]);
@@ -100,11 +100,11 @@ bool SGCollisionDetector2DInternal::overlaps_on_axis(const SGShape2DInternal &sh
 	return false;
 }
 
-bool SGCollisionDetector2DInternal::sat_test(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const std::vector<SGFixedVector2Internal> &axes,
+bool SGCollisionDetector2DInternal::sat_test(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const SGFixedVector2Internal *axes, std::size_t axis_count,
 fixed p_margin, SGFixedVector2Internal &best_separation_vector, fixed &best_separation_length, SGFixedVector2Internal &collision_normal) {
 	fixed separation_component;
 
-	for (std::size_t i = 0; i < axes.size(); i++) {
+	for (std::size_t i = 0; i < axis_count; i++) {
 		const SGFixedVector2Internal &axis = axes[i];
 		if (axis == SGFixedVector2Internal::ZERO) {
 			continue;
@@ -211,7 +211,7 @@ bool SGCollisionDetector2DInternal::Circle_overlaps_Rectangle(const SGCircle2DIn
 	// Next, we need to find the axis to check for the circle (it's a vector
 	// from the closest vertex to the circle center).
 
-	std::vector<SGFixedVector2Internal> vertices = rectangle.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &vertices = rectangle.get_global_vertices();
 	SGFixedTransform2DInternal ct = circle.get_global_transform();
 	SGFixedVector2Internal closest_vertex = vertices[0];
 	fixed closest_distance = (ct.get_origin() - vertices[0]).length();
@@ -224,9 +224,8 @@ bool SGCollisionDetector2DInternal::Circle_overlaps_Rectangle(const SGCircle2DIn
 		}
 	}
 
-	std::vector<SGFixedVector2Internal> circle_axes;
-	circle_axes.push_back((ct.get_origin() - closest_vertex).normalized());
-	if (!sat_test(rectangle, circle, circle_axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	const SGFixedVector2Internal circle_axis = (ct.get_origin() - closest_vertex).normalized();
+	if (!sat_test(rectangle, circle, &circle_axis, 1, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
@@ -283,7 +282,7 @@ bool SGCollisionDetector2DInternal::Polygon_overlaps_Circle(const SGPolygon2DInt
 	// Next, we need to find the axis to check for the circle (it's a vector
 	// from the closest vertex to the circle center).
 
-	std::vector<SGFixedVector2Internal> vertices = polygon.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &vertices = polygon.get_global_vertices();
 	SGFixedTransform2DInternal ct = circle.get_global_transform();
 	SGFixedVector2Internal closest_vertex = vertices[0];
 	fixed closest_distance = (ct.get_origin() - vertices[0]).length();
@@ -296,9 +295,8 @@ bool SGCollisionDetector2DInternal::Polygon_overlaps_Circle(const SGPolygon2DInt
 		}
 	}
 
-	std::vector<SGFixedVector2Internal> circle_axes;
-	circle_axes.push_back((ct.get_origin() - closest_vertex).normalized());
-	if (!sat_test(polygon, circle, circle_axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	const SGFixedVector2Internal circle_axis = (ct.get_origin() - closest_vertex).normalized();
+	if (!sat_test(polygon, circle, &circle_axis, 1, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
@@ -339,17 +337,17 @@ bool SGCollisionDetector2DInternal::Capsule_overlaps_Circle(const SGCapsule2DInt
 	SGFixedVector2Internal best_separation_vector;
 	fixed best_separation_length;
 	SGFixedVector2Internal collision_normal;
-	std::vector<SGFixedVector2Internal> axes;
+	SGFixedVector2Internal axes[3];
 	const SGFixedTransform2DInternal capsule_transform = capsule.get_global_transform();
 	// Capsule width axis
-	axes.push_back(capsule_transform.elements[0].normalized());
+	axes[0] = capsule_transform.elements[0].normalized();
 
 	// Center of the circle to capsule internal endpoints
-	const std::vector<SGFixedVector2Internal> verts = capsule.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &verts = capsule.get_global_vertices();
 	const SGFixedVector2Internal circle_center = circle.get_global_transform().get_origin();
-	axes.push_back((circle_center - verts[0]).normalized());
-	axes.push_back((circle_center - verts[1]).normalized());
-	if (!sat_test(capsule, circle, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	axes[1] = (circle_center - verts[0]).normalized();
+	axes[2] = (circle_center - verts[1]).normalized();
+	if (!sat_test(capsule, circle, axes, 3, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
@@ -372,16 +370,16 @@ bool SGCollisionDetector2DInternal::Capsule_overlaps_Rectangle(const SGCapsule2D
 		return false;
 	}
 
-	std::vector<SGFixedVector2Internal> axes;
+	SGFixedVector2Internal axes[3];
 	// Capsule width axis
-	axes.push_back(capsule_transform.elements[0].normalized());
+	axes[0] = capsule_transform.elements[0].normalized();
 
 	// Rectangle vertex to capsule internal endpoints
-	const std::vector<SGFixedVector2Internal> capsule_endpoints = capsule.get_global_vertices();
-	axes.push_back((rectangle.get_closest_vertex(capsule_endpoints[0]) - capsule_endpoints[0]).normalized());
-	axes.push_back((rectangle.get_closest_vertex(capsule_endpoints[1]) - capsule_endpoints[1]).normalized());
+	const std::vector<SGFixedVector2Internal> &capsule_endpoints = capsule.get_global_vertices();
+	axes[1] = (rectangle.get_closest_vertex(capsule_endpoints[0]) - capsule_endpoints[0]).normalized();
+	axes[2] = (rectangle.get_closest_vertex(capsule_endpoints[1]) - capsule_endpoints[1]).normalized();
 
-	if (!sat_test(capsule, rectangle, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	if (!sat_test(capsule, rectangle, axes, 3, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
@@ -404,22 +402,22 @@ bool SGCollisionDetector2DInternal::Capsule_overlaps_Polygon(const SGCapsule2DIn
 		return false;
 	}
 
-	std::vector<SGFixedVector2Internal> axes;
 	// Capsule width axis
-	axes.push_back(capsule_transform.elements[0].normalized());
-	if (!sat_test(capsule, polygon, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	const SGFixedVector2Internal width_axis = capsule_transform.elements[0].normalized();
+	if (!sat_test(capsule, polygon, &width_axis, 1, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
 	// Polygon vertices to capsule internal endpoints
-	const std::vector<SGFixedVector2Internal> capsule_endpoints = capsule.get_global_vertices();
-	const std::vector<SGFixedVector2Internal> polygon_vertices = polygon.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &capsule_endpoints = capsule.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &polygon_vertices = polygon.get_global_vertices();
 	for (std::size_t i = 0; i < polygon_vertices.size(); i++) {
-		axes.clear();
-		axes.push_back((polygon_vertices[i] - capsule_endpoints[0]).normalized());
-		axes.push_back((polygon_vertices[i] - capsule_endpoints[1]).normalized());
+		const SGFixedVector2Internal axes[2] = {
+			(polygon_vertices[i] - capsule_endpoints[0]).normalized(),
+			(polygon_vertices[i] - capsule_endpoints[1]).normalized(),
+		};
 
-		if (!sat_test(capsule, polygon, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+		if (!sat_test(capsule, polygon, axes, 2, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 			return false;
 		}
 	}
@@ -436,24 +434,23 @@ bool SGCollisionDetector2DInternal::Capsule_overlaps_Capsule(const SGCapsule2DIn
 	SGFixedVector2Internal best_separation_vector;
 	fixed best_separation_length;
 	SGFixedVector2Internal collision_normal;
-	std::vector<SGFixedVector2Internal> axes;
+	SGFixedVector2Internal axes[4];
 	// Capsule width axis
-	axes.push_back(capsule1.get_global_transform().elements[0].normalized());
-	axes.push_back(capsule2.get_global_transform().elements[0].normalized());
-	if (!sat_test(capsule1, capsule2, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	axes[0] = capsule1.get_global_transform().elements[0].normalized();
+	axes[1] = capsule2.get_global_transform().elements[0].normalized();
+	if (!sat_test(capsule1, capsule2, axes, 2, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
 	// Internal endpoints to internal endpoints
-	const std::vector<SGFixedVector2Internal> capsule1_endpoints = capsule1.get_global_vertices();
-	const std::vector<SGFixedVector2Internal> capsule2_endpoints = capsule2.get_global_vertices();
-	axes.clear();
-	axes.push_back((capsule1_endpoints[0] - capsule2_endpoints[0]).normalized());
-	axes.push_back((capsule1_endpoints[0] - capsule2_endpoints[1]).normalized());
-	axes.push_back((capsule1_endpoints[1] - capsule2_endpoints[0]).normalized());
-	axes.push_back((capsule1_endpoints[1] - capsule2_endpoints[1]).normalized());
-
-	if (!sat_test(capsule1, capsule2, axes, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
+	const std::vector<SGFixedVector2Internal> &capsule1_endpoints = capsule1.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &capsule2_endpoints = capsule2.get_global_vertices();
+	axes[0] = (capsule1_endpoints[0] - capsule2_endpoints[0]).normalized();
+	axes[1] = (capsule1_endpoints[0] - capsule2_endpoints[1]).normalized();
+	axes[2] = (capsule1_endpoints[1] - capsule2_endpoints[0]).normalized();
+	axes[3] = (capsule1_endpoints[1] - capsule2_endpoints[1]).normalized();
+
+	if (!sat_test(capsule1, capsule2, axes, 4, p_margin, best_separation_vector, best_separation_length, collision_normal)) {
 		return false;
 	}
 
@@ -493,9 +490,18 @@ bool SGCollisionDetector2DInternal::segment_intersects_Capsule(const SGFixedVect
 		}
 		colliding = true;
 	}
-	SGRectangle2DInternal rectangle(capsule.get_radius(), fixed(capsule.get_height().value / 2));
-	rectangle.set_transform(capsule.get_global_transform());
-	if (segment_intersects_Polygon(p_start, p_cast_to, rectangle, intersection_point, collision_normal)) {
+	// The box between the two end circles, in the same order as a rectangle's
+	// vertices, kept on the stack so that casting rays doesn't allocate.
+	SGFixedTransform2DInternal ct = capsule.get_global_transform();
+	fixed extents_x = capsule.get_radius();
+	fixed extents_y = fixed(capsule.get_height().value / 2);
+	SGFixedVector2Internal box[4] = {
+		ct.xform(SGFixedVector2Internal(-extents_x, -extents_y)),
+		ct.xform(SGFixedVector2Internal(extents_x, -extents_y)),
+		ct.xform(SGFixedVector2Internal(extents_x, extents_y)),
+		ct.xform(SGFixedVector2Internal(-extents_x, extents_y)),
+	};
+	if (segment_intersects_vertices(p_start, p_cast_to, box, 4, intersection_point, collision_normal)) {
 		fixed distance_squared = intersection_point.distance_squared_to(p_start);
 		if (!colliding || closest_distance_squared > distance_squared) {
 			p_intersection_point = intersection_point;
@@ -554,17 +560,20 @@ bool SGCollisionDetector2DInternal::segment_intersects_segment(const SGFixedVect
 }
 
 bool SGCollisionDetector2DInternal::segment_intersects_Polygon(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGShape2DInternal &polygon, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal) {
-	std::vector<SGFixedVector2Internal> verts = polygon.get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &verts = polygon.get_global_vertices();
+	return segment_intersects_vertices(p_start, p_cast_to, verts.data(), verts.size(), p_intersection_point, p_collision_normal);
+}
 
+bool SGCollisionDetector2DInternal::segment_intersects_vertices(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedVector2Internal *p_vertices, std::size_t p_vertex_count, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal) {
 	bool intersecting = false;
 
 	SGFixedVector2Internal closest_intersection_point;
 	SGFixedVector2Internal closest_collision_normal;
 	fixed closest_distance;
 
-	SGFixedVector2Internal previous = verts[verts.size() - 1];
-	for (std::size_t i = 0; i < verts.size(); i++) {
-		SGFixedVector2Internal cur = verts[i];
+	SGFixedVector2Internal previous = p_vertices[p_vertex_count - 1];
+	for (std::size_t i = 0; i < p_vertex_count; i++) {
+		SGFixedVector2Internal cur = p_vertices[i];
 		SGFixedVector2Internal edge = cur - previous;
 		SGFixedVector2Internal intersection_point;
 		if (segment_intersects_segment(p_start, p_cast_to, previous, edge, intersection_point)) {
@@ -648,3 +657,444 @@ bool SGCollisionDetector2DInternal::segment_intersects_Circle(const SGFixedVecto
 
 	return false;
 }
+
+_FORCE_INLINE_ static int sg_grid_cell_index(fixed p_position, fixed p_cell_size, int p_count) {
+	int64_t index = p_position.value / p_cell_size.value;
+	if (p_position.value < 0 && p_position.value % p_cell_size.value != 0) {
+		index--;
+	}
+	return (int)CLAMP(index, (int64_t)0, (int64_t)p_count - 1);
+}
+
+bool SGCollisionDetector2DInternal::segment_intersects_Grid(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGGrid2DInternal &grid, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal) {
+	const int count[2] = { grid.get_width(), grid.get_height() };
+	const SGFixedVector2Internal cell_size = grid.get_cell_size();
+	if (count[0] == 0 || count[1] == 0 || cell_size.x <= fixed::ZERO || cell_size.y <= fixed::ZERO) {
+		return false;
+	}
+
+	// Work in the grid's local space, where cells are axis-aligned.
+	SGFixedTransform2DInternal t = grid.get_global_transform();
+	SGFixedTransform2DInternal inverse = t.affine_inverse();
+	SGFixedVector2Internal start = inverse.xform(p_start);
+	SGFixedVector2Internal cast_to = inverse.xform(p_start + p_cast_to) - start;
+	if (cast_to == SGFixedVector2Internal::ZERO) {
+		return false;
+	}
+
+	// Clip the segment to the grid.
+	fixed t_enter = fixed::ZERO;
+	fixed t_exit = fixed::ONE;
+	int enter_axis = -1;
+	for (int axis = 0; axis < 2; axis++) {
+		fixed size = fixed(cell_size[axis].value * count[axis]);
+		if (cast_to[axis] == fixed::ZERO) {
+			if (start[axis] < fixed::ZERO || start[axis] > size) {
+				return false;
+			}
+			continue;
+		}
+		fixed t0 = -start[axis] / cast_to[axis];
+		fixed t1 = (size - start[axis]) / cast_to[axis];
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		if (t0 > t_enter) {
+			t_enter = t0;
+			enter_axis = axis;
+		}
+		t_exit = MIN(t_exit, t1);
+	}
+	if (t_enter > t_exit) {
+		return false;
+	}
+
+	int cell[2];
+	int step[2];
+	SGFixedVector2Internal entry = start + cast_to * t_enter;
+	for (int axis = 0; axis < 2; axis++) {
+		cell[axis] = sg_grid_cell_index(entry[axis], cell_size[axis], count[axis]);
+		step[axis] = cast_to[axis] > fixed::ZERO ? 1 : (cast_to[axis] < fixed::ZERO ? -1 : 0);
+	}
+
+	// A segment starting outside of the grid enters its first cell through
+	// the grid's edge, and one starting inside never hits its first cell.
+	SGGrid2DInternal::CellType previous = SGGrid2DInternal::CELL_EMPTY;
+	if (enter_axis == -1) {
+		previous = grid.get_cell(cell[0], cell[1]);
+	}
+
+	while (true) {
+		if (enter_axis != -1) {
+			SGGrid2DInternal::CellType type = grid.get_cell(cell[0], cell[1]);
+			bool hit = (type == SGGrid2DInternal::CELL_SOLID && previous != SGGrid2DInternal::CELL_SOLID) ||
+					(type == SGGrid2DInternal::CELL_ONE_WAY && previous == SGGrid2DInternal::CELL_EMPTY && enter_axis == 1 && step[1] > 0);
+			if (hit) {
+				// Find the point exactly on the side of the cell.
+				int other_axis = 1 - enter_axis;
+				fixed side = fixed(cell_size[enter_axis].value * (step[enter_axis] > 0 ? cell[enter_axis] : cell[enter_axis] + 1));
+				SGFixedVector2Internal point;
+				point[enter_axis] = side;
+				point[other_axis] = start[other_axis] + cast_to[other_axis] * (side - start[enter_axis]) / cast_to[enter_axis];
+
+				SGFixedVector2Internal normal;
+				normal[enter_axis] = fixed::from_int(-step[enter_axis]);
+
+				p_intersection_point = t.xform(point);
+				p_collision_normal = t.basis_xform(normal).normalized();
+				return true;
+			}
+			previous = type;
+		}
+
+		// Step to the neighbor whose side the segment crosses first.
+		fixed next[2];
+		for (int axis = 0; axis < 2; axis++) {
+			if (step[axis] == 0) {
+				next[axis] = fixed(INT64_MAX);
+				continue;
+			}
+			fixed side = fixed(cell_size[axis].value * (step[axis] > 0 ? cell[axis] + 1 : cell[axis]));
+			next[axis] = (side - start[axis]) / cast_to[axis];
+		}
+		int axis = next[0] <= next[1] ? 0 : 1;
+		if (next[axis] > t_exit) {
+			return false;
+		}
+		cell[axis] += step[axis];
+		if (cell[axis] < 0 || cell[axis] >= count[axis]) {
+			return false;
+		}
+		enter_axis = axis;
+	}
+}
+
+// The iteration limits are only a safety net: with polygonal cores, both
+// GJK and EPA finish once they run out of new support points, which takes
+// at most as many iterations as the cores have vertices between them.
+#define SG_GJK_MAX_ITERATIONS 64
+#define SG_EPA_MAX_POINTS 64
+
+struct SGSupportShape {
+	const SGFixedVector2Internal *points;
+	std::size_t count;
+	fixed radius;
+	// Storage for circles, whose core is a single point.
+	SGFixedVector2Internal center;
+
+	SGSupportShape(const SGShape2DInternal &p_shape) {
+		radius = fixed::ZERO;
+		switch (p_shape.get_shape_type()) {
+			case SGShape2DInternal::SHAPE_CIRCLE: {
+				SGFixedTransform2DInternal t = p_shape.get_global_transform();
+				center = t.get_origin();
+				points = &center;
+				count = 1;
+				// We only multiply by the scale.x because we don't support non-uniform scaling.
+				radius = ((const SGCircle2DInternal &)p_shape).get_radius() * t.get_scale().x;
+			} break;
+
+			case SGShape2DInternal::SHAPE_CAPSULE: {
+				const std::vector<SGFixedVector2Internal> &verts = p_shape.get_global_vertices();
+				points = verts.data();
+				count = verts.size();
+				radius = ((const SGCapsule2DInternal &)p_shape).get_radius() * p_shape.get_global_transform().get_scale().x;
+			} break;
+
+			default: {
+				const std::vector<SGFixedVector2Internal> &verts = p_shape.get_global_vertices();
+				points = verts.data();
+				count = verts.size();
+			} break;
+		}
+	}
+
+	// The first of the points furthest along p_direction, so that ties are
+	// always broken the same way.
+	_FORCE_INLINE_ SGFixedVector2Internal support(const SGFixedVector2Internal &p_direction) const {
+		std::size_t best = 0;
+		fixed best_projection = p_direction.dot(points[0]);
+		for (std::size_t i = 1; i < count; i++) {
+			fixed projection = p_direction.dot(points[i]);
+			if (projection > best_projection) {
+				best_projection = projection;
+				best = i;
+			}
+		}
+		return points[best];
+	}
+};
+
+// Support function of the Minkowski difference of the two cores.
+_FORCE_INLINE_ static SGFixedVector2Internal sg_minkowski_support(const SGSupportShape &p_shape1, const SGSupportShape &p_shape2, const SGFixedVector2Internal &p_direction) {
+	return p_shape1.support(p_direction) - p_shape2.support(-p_direction);
+}
+
+// The point on the segment from p_a to p_b that's closest to the origin.
+static SGFixedVector2Internal sg_closest_point_on_segment_to_origin(const SGFixedVector2Internal &p_a, const SGFixedVector2Internal &p_b, bool &r_is_endpoint) {
+	SGFixedVector2Internal ab = p_b - p_a;
+	fixed ab_length_squared = ab.length_squared();
+	fixed t = ab_length_squared > fixed::ZERO ? -p_a.dot(ab) / ab_length_squared : fixed::ZERO;
+	r_is_endpoint = true;
+	if (t <= fixed::ZERO) {
+		return p_a;
+	}
+	if (t >= fixed::ONE) {
+		return p_b;
+	}
+	r_is_endpoint = false;
+	return p_a + ab * t;
+}
+
+// Runs GJK on the cores, returning true if they intersect. Otherwise, r_closest
+// is the point of their Minkowski difference that's closest to the origin.
+// When they intersect, r_simplex holds the points enclosing the origin.
+static bool sg_gjk(const SGSupportShape &p_shape1, const SGSupportShape &p_shape2, SGFixedVector2Internal *r_simplex, int &r_simplex_size, SGFixedVector2Internal &r_closest) {
+	// Every point in the simplex has to be on the boundary of the Minkowski
+	// difference for EPA to work, so start from a support point too.
+	SGFixedVector2Internal v = p_shape1.points[0] - p_shape2.points[0];
+	if (v == SGFixedVector2Internal::ZERO) {
+		v = SGFixedVector2Internal(fixed::ONE, fixed::ZERO);
+	}
+	v = sg_minkowski_support(p_shape1, p_shape2, v);
+	r_simplex[0] = v;
+	r_simplex_size = 1;
+
+	for (int iteration = 0; iteration < SG_GJK_MAX_ITERATIONS; iteration++) {
+		if (v == SGFixedVector2Internal::ZERO) {
+			r_closest = v;
+			return true;
+		}
+
+		SGFixedVector2Internal w = sg_minkowski_support(p_shape1, p_shape2, -v);
+
+		// If the new point doesn't get us any closer to the origin, then v is
+		// as close as we'll get.
+		if (v.dot(v) - v.dot(w) <= fixed::ZERO) {
+			break;
+		}
+		bool duplicate = false;
+		for (int i = 0; i < r_simplex_size; i++) {
+			duplicate = duplicate || r_simplex[i] == w;
+		}
+		if (duplicate) {
+			break;
+		}
+
+		r_simplex[r_simplex_size++] = w;
+
+		if (r_simplex_size == 2) {
+			bool is_endpoint;
+			v = sg_closest_point_on_segment_to_origin(r_simplex[0], r_simplex[1], is_endpoint);
+			if (is_endpoint) {
+				r_simplex[0] = v;
+				r_simplex_size = 1;
+			}
+			continue;
+		}
+
+		// We've got a triangle: does it contain the origin?
+		const SGFixedVector2Internal &a = r_simplex[0];
+		const SGFixedVector2Internal &b = r_simplex[1];
+		const SGFixedVector2Internal &c = r_simplex[2];
+		fixed area = (b - a).cross(c - a);
+		if (area != fixed::ZERO) {
+			fixed sign = area > fixed::ZERO ? fixed::ONE : fixed::NEG_ONE;
+			if ((b - a).cross(-a) * sign >= fixed::ZERO && (c - b).cross(-b) * sign >= fixed::ZERO && (a - c).cross(-c) * sign >= fixed::ZERO) {
+				r_closest = SGFixedVector2Internal::ZERO;
+				return true;
+			}
+		}
+
+		// If not, keep the edge with the new point that's closest to the
+		// origin (the edge opposite the new point can't be any closer).
+		bool ca_is_endpoint, cb_is_endpoint;
+		SGFixedVector2Internal ca = sg_closest_point_on_segment_to_origin(c, a, ca_is_endpoint);
+		SGFixedVector2Internal cb = sg_closest_point_on_segment_to_origin(c, b, cb_is_endpoint);
+		if (ca.length_squared() <= cb.length_squared()) {
+			v = ca;
+			r_simplex[1] = c;
+			r_simplex_size = ca_is_endpoint ? 1 : 2;
+			if (ca_is_endpoint) {
+				r_simplex[0] = v;
+			}
+		}
+		else {
+			v = cb;
+			r_simplex[0] = b;
+			r_simplex[1] = c;
+			r_simplex_size = cb_is_endpoint ? 1 : 2;
+			if (cb_is_endpoint) {
+				r_simplex[0] = v;
+			}
+		}
+	}
+
+	r_closest = v;
+	return v == SGFixedVector2Internal::ZERO;
+}
+
+// Runs EPA on the cores, starting from the simplex that GJK found enclosing
+// the origin. Gives the direction to move shape1 out of shape2, and how far
+// the cores are overlapping along it.
+static void sg_epa(const SGSupportShape &p_shape1, const SGSupportShape &p_shape2, SGFixedVector2Internal *p_simplex, int p_simplex_size, SGFixedVector2Internal &r_normal, fixed &r_depth) {
+	SGFixedVector2Internal polytope[SG_EPA_MAX_POINTS];
+	int size = 0;
+
+	// The origin is on a point or an edge of the Minkowski difference,
+	// so try to grow it into a triangle.
+	if (p_simplex_size == 1) {
+		SGFixedVector2Internal a = sg_minkowski_support(p_shape1, p_shape2, SGFixedVector2Internal(fixed::ONE, fixed::ZERO));
+		SGFixedVector2Internal b = sg_minkowski_support(p_shape1, p_shape2, SGFixedVector2Internal(fixed::NEG_ONE, fixed::ZERO));
+		if (a == b) {
+			a = sg_minkowski_support(p_shape1, p_shape2, SGFixedVector2Internal(fixed::ZERO, fixed::ONE));
+			b = sg_minkowski_support(p_shape1, p_shape2, SGFixedVector2Internal(fixed::ZERO, fixed::NEG_ONE));
+		}
+		p_simplex[0] = a;
+		p_simplex[1] = b;
+		p_simplex_size = a == b ? 1 : 2;
+	}
+	if (p_simplex_size == 2) {
+		SGFixedVector2Internal n = (p_simplex[1] - p_simplex[0]).tangent();
+		SGFixedVector2Internal c = sg_minkowski_support(p_shape1, p_shape2, n);
+		if (n.dot(c - p_simplex[0]) <= fixed::ZERO) {
+			c = sg_minkowski_support(p_shape1, p_shape2, -n);
+		}
+		p_simplex[2] = c;
+		p_simplex_size = (p_simplex[1] - p_simplex[0]).cross(c - p_simplex[0]) == fixed::ZERO ? 2 : 3;
+	}
+
+	if (p_simplex_size < 3) {
+		// The Minkowski difference is flat (or a single point), so the cores
+		// are only touching. Arbitrarily decide to move shape1 up, or off to
+		// the side of the line they're on.
+		if (p_simplex_size == 2) {
+			r_normal = (p_simplex[1] - p_simplex[0]).tangent().normalized();
+			if (r_normal.y > fixed::ZERO || (r_normal.y == fixed::ZERO && r_normal.x < fixed::ZERO)) {
+				r_normal = -r_normal;
+			}
+		}
+		else {
+			r_normal = SGFixedVector2Internal(fixed::ZERO, fixed::NEG_ONE);
+		}
+		r_depth = fixed::ZERO;
+		return;
+	}
+
+	// Wind the polytope counter-clockwise, so the outward normal of each edge is its tangent().
+	polytope[0] = p_simplex[0];
+	if ((p_simplex[1] - p_simplex[0]).cross(p_simplex[2] - p_simplex[0]) > fixed::ZERO) {
+		polytope[1] = p_simplex[1];
+		polytope[2] = p_simplex[2];
+	}
+	else {
+		polytope[1] = p_simplex[2];
+		polytope[2] = p_simplex[1];
+	}
+	size = 3;
+
+	SGFixedVector2Internal normals[SG_EPA_MAX_POINTS];
+	fixed distances[SG_EPA_MAX_POINTS];
+	for (int i = 0; i < size; i++) {
+		normals[i] = (polytope[(i + 1) % size] - polytope[i]).tangent().normalized();
+		distances[i] = normals[i].dot(polytope[i]);
+	}
+
+	while (true) {
+		int closest = 0;
+		for (int i = 1; i < size; i++) {
+			if (distances[i] < distances[closest]) {
+				closest = i;
+			}
+		}
+
+		r_normal = normals[closest];
+		r_depth = distances[closest];
+
+		if (size == SG_EPA_MAX_POINTS) {
+			break;
+		}
+
+		SGFixedVector2Internal support = sg_minkowski_support(p_shape1, p_shape2, r_normal);
+		if (r_normal.dot(support) - r_depth <= fixed::ZERO) {
+			// This edge is on the boundary of the Minkowski difference.
+			break;
+		}
+		// Rounding can make an edge look like it's not on the boundary when
+		// it really is, but then the support point will be one we've got.
+		bool duplicate = false;
+		for (int i = 0; i < size; i++) {
+			duplicate = duplicate || polytope[i] == support;
+		}
+		if (duplicate) {
+			break;
+		}
+
+		// Split the edge at the new point.
+		for (int i = size; i > closest + 1; i--) {
+			polytope[i] = polytope[i - 1];
+			normals[i] = normals[i - 1];
+			distances[i] = distances[i - 1];
+		}
+		polytope[closest + 1] = support;
+		size++;
+		for (int i = closest; i <= closest + 1; i++) {
+			normals[i] = (polytope[(i + 1) % size] - polytope[i]).tangent().normalized();
+			distances[i] = normals[i].dot(polytope[i]);
+		}
+	}
+
+	// The normal points out of the Minkowski difference, so moving shape1
+	// out of shape2 means going the other way.
+	r_normal = -r_normal;
+	if (r_depth < fixed::ZERO) {
+		r_depth = fixed::ZERO;
+	}
+}
+
+bool SGCollisionDetector2DInternal::GJK_overlaps(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, fixed p_margin, OverlapInfo *p_info) {
+	SGSupportShape support1(shape1);
+	SGSupportShape support2(shape2);
+	if (support1.count == 0 || support2.count == 0) {
+		return false;
+	}
+
+	// Like SAT, the margin grows both shapes.
+	fixed radius = support1.radius + support2.radius + p_margin * fixed::TWO;
+
+	SGFixedVector2Internal simplex[3];
+	int simplex_size;
+	SGFixedVector2Internal closest;
+
+	SGFixedVector2Internal collision_normal;
+	fixed separation;
+	if (sg_gjk(support1, support2, simplex, simplex_size, closest)) {
+		fixed depth;
+		sg_epa(support1, support2, simplex, simplex_size, collision_normal, depth);
+		separation = depth + radius;
+	}
+	else {
+		// The cores are apart, so they only overlap if the radius covers the gap.
+		fixed distance = closest.length();
+		if (distance >= radius) {
+			return false;
+		}
+		collision_normal = closest.normalized();
+		separation = radius - distance;
+	}
+
+	SGFixedVector2Internal separation_vector = collision_normal * separation;
+
+	// if the correction is too small it will be set to 0 and the overlap won't be corrected
+	// in that case we don't consider it an overlap
+	if (separation <= fixed::ZERO || (collision_normal.x != fixed::ZERO && separation_vector.x == fixed::ZERO) || (collision_normal.y != fixed::ZERO && separation_vector.y == fixed::ZERO)) {
+		return false;
+	}
+
+	if (p_info) {
+		p_info->collision_normal = collision_normal;
+		p_info->separation = separation_vector;
+	}
+
+	return true;
+}
@@ -56,8 +56,12 @@ public:
 	static Interval get_interval(const SGShape2DInternal &shape, const SGFixedVector2Internal &axis, fixed p_margin);
 
 	static bool overlaps_on_axis(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const SGFixedVector2Internal &axis, fixed p_margin, fixed &separation);
-	static bool sat_test(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const std::vector<SGFixedVector2Internal> &axes,
+	static bool sat_test(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const SGFixedVector2Internal *axes, std::size_t axis_count,
 		fixed p_margin, SGFixedVector2Internal &best_separation_vector, fixed &best_separation_length, SGFixedVector2Internal &collision_normal);
+	_FORCE_INLINE_ static bool sat_test(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, const std::vector<SGFixedVector2Internal> &axes,
+		fixed p_margin, SGFixedVector2Internal &best_separation_vector, fixed &best_separation_length, SGFixedVector2Internal &collision_normal) {
+		return sat_test(shape1, shape2, axes.data(), axes.size(), p_margin, best_separation_vector, best_separation_length, collision_normal);
+	}
 	//
 	// Rectangles
 	//
@@ -88,6 +92,17 @@ public:
 	static bool Capsule_overlaps_Polygon(const SGCapsule2DInternal& capsule, const SGPolygon2DInternal& polygon, fixed p_margin, OverlapInfo* p_info);
 	static bool Capsule_overlaps_Capsule(const SGCapsule2DInternal& capsule1, const SGCapsule2DInternal& capsule2, fixed p_margin, OverlapInfo* p_info);
 
+	//
+	// GJK/EPA
+	//
+
+	// Works for any pair of convex shapes, by treating each one as a
+	// polygon, line segment or point (its "core") grown by a radius. The
+	// cost grows linearly with the number of vertices, rather than with the
+	// square like SAT, but the results can differ from SAT by rounding, and
+	// for curved shapes, where SAT only tests an approximate set of axes.
+	static bool GJK_overlaps(const SGShape2DInternal &shape1, const SGShape2DInternal &shape2, fixed p_margin, OverlapInfo *p_info = nullptr);
+
 	//
 	// Line segments
 	//
@@ -97,8 +112,15 @@ public:
 	// since they are both polygons with connected vertices returned by
 	// get_global_vertices().
 	static bool segment_intersects_Polygon(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGShape2DInternal &polygon, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal);
+	// The same, for a convex polygon given as its global vertices, so that
+	// temporary polygons don't need a shape.
+	static bool segment_intersects_vertices(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGFixedVector2Internal *p_vertices, std::size_t p_vertex_count, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal);
 	static bool segment_intersects_Circle(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGCircle2DInternal &circle, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal);
 	static bool segment_intersects_Capsule(const SGFixedVector2Internal& p_start, const SGFixedVector2Internal& p_cast_to, const SGCapsule2DInternal& capsule, SGFixedVector2Internal& p_intersection_point, SGFixedVector2Internal& p_collision_normal);
+	// Walks the cells under the segment in order, and stops at the first side
+	// of a solid cell that isn't shared with another solid cell. One-way cells
+	// are only hit from above.
+	static bool segment_intersects_Grid(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, const SGGrid2DInternal &grid, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal);
 
 };
 
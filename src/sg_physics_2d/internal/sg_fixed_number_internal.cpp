@@ -23,12 +23,107 @@
 
 #include "sg_fixed_number_internal.h"
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+// Returns the index of the highest set bit, which must exist.
+static _FORCE_INLINE_ int sg_highest_bit_64(uint64_t p_value) {
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(p_value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanReverse64(&index, p_value);
+	return (int)index;
+#else
+	int index = 0;
+	for (int shift = 32; shift > 0; shift >>= 1) {
+		if (p_value >> shift) {
+			p_value >>= shift;
+			index += shift;
+		}
+	}
+	return index;
+#endif
+}
+
+// sqrt(t + 1) * 1024, rounded up, for t from 256 to 1023.
+static const uint16_t sg_sqrt_table[768] = {
+	16416, 16448, 16480, 16512, 16544, 16575, 16607, 16639, 16670, 16701, 16733, 16764,
+	16795, 16827, 16858, 16889, 16920, 16951, 16982, 17012, 17043, 17074, 17105, 17135,
+	17166, 17196, 17227, 17257, 17288, 17318, 17348, 17378, 17408, 17439, 17469, 17499,
+	17529, 17558, 17588, 17618, 17648, 17677, 17707, 17737, 17766, 17796, 17825, 17855,
+	17884, 17913, 17942, 17972, 18001, 18030, 18059, 18088, 18117, 18146, 18175, 18204,
+	18232, 18261, 18290, 18318, 18347, 18376, 18404, 18432, 18461, 18489, 18518, 18546,
+	18574, 18602, 18631, 18659, 18687, 18715, 18743, 18771, 18799, 18827, 18854, 18882,
+	18910, 18938, 18965, 18993, 19020, 19048, 19076, 19103, 19130, 19158, 19185, 19212,
+	19240, 19267, 19294, 19321, 19348, 19375, 19403, 19430, 19456, 19483, 19510, 19537,
+	19564, 19591, 19618, 19644, 19671, 19698, 19724, 19751, 19777, 19804, 19830, 19857,
+	19883, 19909, 19936, 19962, 19988, 20014, 20041, 20067, 20093, 20119, 20145, 20171,
+	20197, 20223, 20249, 20275, 20301, 20326, 20352, 20378, 20404, 20429, 20455, 20480,
+	20506, 20532, 20557, 20583, 20608, 20634, 20659, 20684, 20710, 20735, 20760, 20785,
+	20811, 20836, 20861, 20886, 20911, 20936, 20961, 20986, 21011, 21036, 21061, 21086,
+	21111, 21136, 21160, 21185, 21210, 21235, 21259, 21284, 21309, 21333, 21358, 21382,
+	21407, 21431, 21456, 21480, 21504, 21529, 21553, 21578, 21602, 21626, 21650, 21674,
+	21699, 21723, 21747, 21771, 21795, 21819, 21843, 21867, 21891, 21915, 21939, 21963,
+	21987, 22011, 22034, 22058, 22082, 22106, 22129, 22153, 22177, 22200, 22224, 22247,
+	22271, 22295, 22318, 22342, 22365, 22388, 22412, 22435, 22459, 22482, 22505, 22528,
+	22552, 22575, 22598, 22621, 22645, 22668, 22691, 22714, 22737, 22760, 22783, 22806,
+	22829, 22852, 22875, 22898, 22921, 22944, 22966, 22989, 23012, 23035, 23058, 23080,
+	23103, 23126, 23148, 23171, 23194, 23216, 23239, 23261, 23284, 23306, 23329, 23351,
+	23374, 23396, 23419, 23441, 23463, 23486, 23508, 23530, 23552, 23575, 23597, 23619,
+	23641, 23664, 23686, 23708, 23730, 23752, 23774, 23796, 23818, 23840, 23862, 23884,
+	23906, 23928, 23950, 23972, 23994, 24015, 24037, 24059, 24081, 24103, 24124, 24146,
+	24168, 24189, 24211, 24233, 24254, 24276, 24298, 24319, 24341, 24362, 24384, 24405,
+	24427, 24448, 24470, 24491, 24512, 24534, 24555, 24576, 24598, 24619, 24640, 24662,
+	24683, 24704, 24725, 24747, 24768, 24789, 24810, 24831, 24852, 24873, 24894, 24915,
+	24937, 24958, 24979, 25000, 25020, 25041, 25062, 25083, 25104, 25125, 25146, 25167,
+	25188, 25208, 25229, 25250, 25271, 25291, 25312, 25333, 25354, 25374, 25395, 25416,
+	25436, 25457, 25477, 25498, 25518, 25539, 25560, 25580, 25600, 25621, 25641, 25662,
+	25682, 25703, 25723, 25743, 25764, 25784, 25804, 25825, 25845, 25865, 25886, 25906,
+	25926, 25946, 25967, 25987, 26007, 26027, 26047, 26067, 26087, 26107, 26128, 26148,
+	26168, 26188, 26208, 26228, 26248, 26268, 26288, 26308, 26327, 26347, 26367, 26387,
+	26407, 26427, 26447, 26466, 26486, 26506, 26526, 26546, 26565, 26585, 26605, 26624,
+	26644, 26664, 26684, 26703, 26723, 26742, 26762, 26782, 26801, 26821, 26840, 26860,
+	26879, 26899, 26918, 26938, 26957, 26977, 26996, 27015, 27035, 27054, 27074, 27093,
+	27112, 27132, 27151, 27170, 27190, 27209, 27228, 27247, 27267, 27286, 27305, 27324,
+	27343, 27363, 27382, 27401, 27420, 27439, 27458, 27477, 27496, 27515, 27534, 27554,
+	27573, 27592, 27611, 27630, 27648, 27667, 27686, 27705, 27724, 27743, 27762, 27781,
+	27800, 27819, 27837, 27856, 27875, 27894, 27913, 27931, 27950, 27969, 27988, 28006,
+	28025, 28044, 28063, 28081, 28100, 28119, 28137, 28156, 28174, 28193, 28212, 28230,
+	28249, 28267, 28286, 28304, 28323, 28341, 28360, 28378, 28397, 28415, 28434, 28452,
+	28471, 28489, 28507, 28526, 28544, 28563, 28581, 28599, 28618, 28636, 28654, 28672,
+	28691, 28709, 28727, 28746, 28764, 28782, 28800, 28818, 28837, 28855, 28873, 28891,
+	28909, 28927, 28945, 28964, 28982, 29000, 29018, 29036, 29054, 29072, 29090, 29108,
+	29126, 29144, 29162, 29180, 29198, 29216, 29234, 29252, 29270, 29288, 29306, 29323,
+	29341, 29359, 29377, 29395, 29413, 29430, 29448, 29466, 29484, 29502, 29519, 29537,
+	29555, 29573, 29590, 29608, 29626, 29643, 29661, 29679, 29696, 29714, 29732, 29749,
+	29767, 29785, 29802, 29820, 29837, 29855, 29873, 29890, 29908, 29925, 29943, 29960,
+	29978, 29995, 30013, 30030, 30048, 30065, 30082, 30100, 30117, 30135, 30152, 30169,
+	30187, 30204, 30222, 30239, 30256, 30274, 30291, 30308, 30325, 30343, 30360, 30377,
+	30395, 30412, 30429, 30446, 30463, 30481, 30498, 30515, 30532, 30549, 30567, 30584,
+	30601, 30618, 30635, 30652, 30669, 30686, 30703, 30720, 30738, 30755, 30772, 30789,
+	30806, 30823, 30840, 30857, 30874, 30891, 30908, 30925, 30942, 30959, 30975, 30992,
+	31009, 31026, 31043, 31060, 31077, 31094, 31111, 31127, 31144, 31161, 31178, 31195,
+	31212, 31228, 31245, 31262, 31279, 31295, 31312, 31329, 31346, 31362, 31379, 31396,
+	31412, 31429, 31446, 31462, 31479, 31496, 31512, 31529, 31546, 31562, 31579, 31596,
+	31612, 31629, 31645, 31662, 31678, 31695, 31711, 31728, 31744, 31761, 31778, 31794,
+	31810, 31827, 31843, 31860, 31876, 31893, 31909, 31926, 31942, 31958, 31975, 31991,
+	32008, 32024, 32040, 32057, 32073, 32089, 32106, 32122, 32138, 32155, 32171, 32187,
+	32204, 32220, 32236, 32252, 32269, 32285, 32301, 32317, 32334, 32350, 32366, 32382,
+	32398, 32415, 32431, 32447, 32463, 32479, 32495, 32511, 32528, 32544, 32560, 32576,
+	32592, 32608, 32624, 32640, 32656, 32672, 32688, 32704, 32720, 32736, 32752, 32768,
+};
+
 /**
- * Copied from https://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Binary_numeral_system_.28base_2.29
- * but modified to use 64-bit numbers.
+ * Returns the integer square root (rounded down) of the absolute value,
+ * negated for negative numbers, like fix16_sqrt() (ie. sqrt(-x) = -sqrt(x)).
  *
- * Like fix16_sqrt(), for negative numbers we return the negated square root of
- * the absolute value (ie. sqrt(-x) = -sqrt(x)).
+ * The top 10 bits of the number give an estimate from the table that is
+ * never too small and good to about 9 bits. Two Newton steps then make it
+ * good to more than 32 bits, and since Newton's method on integers never
+ * drops below the root when it starts above it, the last step can only be
+ * off by one. This gives exactly the same results as the bit-by-bit method.
  */
 int64_t sg_sqrt_64(int64_t num) {
 	if (num == 0) {
@@ -36,29 +131,76 @@ int64_t sg_sqrt_64(int64_t num) {
 	}
 
 	bool neg = num < 0;
-	if (neg) {
-		num = -num;
+	uint64_t n = neg ? (uint64_t)0 - (uint64_t)num : (uint64_t)num;
+
+	// Split n into t * 2^shift with t in [256, 1024), where shift is even, so
+	// that sqrt(n) <= sqrt(t + 1) * 2^(shift / 2).
+	int shift = (sg_highest_bit_64(n) & ~1) - 8;
+	uint64_t t = shift >= 0 ? n >> shift : n << -shift;
+	uint64_t x = sg_sqrt_table[t - 256];
+	int x_shift = shift / 2 - 10;
+	if (x_shift >= 0) {
+		x <<= x_shift;
+	}
+	else {
+		// Round up, so the estimate stays above the root.
+		x = (x + (((uint64_t)1 << -x_shift) - 1)) >> -x_shift;
 	}
-	int64_t res = 0;
-	int64_t bit = 1LL << 62;
 
-	// Start bit at the highest power of four that's less than or equal to num.
-	while (bit > num) {
-		bit >>= 2;
+	x = (x + n / x) >> 1;
+	x = (x + n / x) >> 1;
+	if (x * x > n) {
+		x--;
 	}
 
-	while (bit != 0) {
-		if (num >= res + bit) {
-			num -= res + bit;
-			res = (res >> 1) + bit;
-		}
-		else {
-			res >>= 1;
+	return neg ? -(int64_t)x : (int64_t)x;
+}
+
+int64_t sg_div_128_64(int64_t p_high, uint64_t p_low, int64_t p_divisor) {
+#if defined(__SIZEOF_INT128__)
+	__int128 quotient = (((__int128)p_high << 64) | p_low) / p_divisor;
+
+	#ifdef SG_FIXED_MATH_CHECKS
+	ERR_FAIL_COND_V_MSG((int64_t)quotient != quotient,
+		fixed::ARITHMETIC_OVERFLOW.value, "Fixed-point division overflow");
+	#endif
+
+	return (int64_t)quotient;
+#else
+	// Long division of the magnitudes, one bit at a time.
+	bool neg = (p_high < 0) != (p_divisor < 0);
+	uint64_t high = (uint64_t)p_high;
+	uint64_t low = p_low;
+	if (p_high < 0) {
+		low = ~low + 1;
+		high = ~high + (low == 0 ? 1 : 0);
+	}
+	uint64_t divisor = p_divisor < 0 ? (uint64_t)0 - (uint64_t)p_divisor : (uint64_t)p_divisor;
+
+	#ifdef SG_FIXED_MATH_CHECKS
+	ERR_FAIL_COND_V_MSG(high >= divisor,
+		fixed::ARITHMETIC_OVERFLOW.value, "Fixed-point division overflow");
+	#endif
+
+	uint64_t remainder = high % divisor;
+	uint64_t quotient = 0;
+	for (int i = 63; i >= 0; i--) {
+		bool carry = (remainder >> 63) != 0;
+		remainder = (remainder << 1) | ((low >> i) & 1);
+		quotient <<= 1;
+		if (carry || remainder >= divisor) {
+			remainder -= divisor;
+			quotient |= 1;
 		}
-		bit >>= 2;
 	}
 
-	return neg ? -res : res;
+	#ifdef SG_FIXED_MATH_CHECKS
+	ERR_FAIL_COND_V_MSG(quotient > (neg ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX),
+		fixed::ARITHMETIC_OVERFLOW.value, "Fixed-point division overflow");
+	#endif
+
+	return neg ? (int64_t)((uint64_t)0 - quotient) : (int64_t)quotient;
+#endif
 }
 
 const fixed fixed::ZERO = fixed(0);
@@ -75,6 +217,766 @@ const fixed fixed::EPSILON = fixed(1);
 const fixed fixed::ARITHMETIC_OVERFLOW = fixed(INT64_MIN);
 const fixed fixed::DEG_180 = fixed(11796480);
 
+#ifdef SG_FIXED_TRIG_TABLES
+
+// sin(t * PI / 2) * 65536, rounded, for t from 0 to 1 in steps of 1 / 4096.
+static const int32_t sg_sin_table[4097] = {
+	0, 25, 50, 75, 101, 126, 151, 176, 201, 226, 251, 276,
+	302, 327, 352, 377, 402, 427, 452, 478, 503, 528, 553, 578,
+	603, 628, 653, 679, 704, 729, 754, 779, 804, 829, 854, 880,
+	905, 930, 955, 980, 1005, 1030, 1056, 1081, 1106, 1131, 1156, 1181,
+	1206, 1231, 1257, 1282, 1307, 1332, 1357, 1382, 1407, 1432, 1458, 1483,
+	1508, 1533, 1558, 1583, 1608, 1633, 1659, 1684, 1709, 1734, 1759, 1784,
+	1809, 1834, 1860, 1885, 1910, 1935, 1960, 1985, 2010, 2035, 2061, 2086,
+	2111, 2136, 2161, 2186, 2211, 2236, 2261, 2287, 2312, 2337, 2362, 2387,
+	2412, 2437, 2462, 2488, 2513, 2538, 2563, 2588, 2613, 2638, 2663, 2688,
+	2714, 2739, 2764, 2789, 2814, 2839, 2864, 2889, 2914, 2940, 2965, 2990,
+	3015, 3040, 3065, 3090, 3115, 3140, 3165, 3191, 3216, 3241, 3266, 3291,
+	3316, 3341, 3366, 3391, 3417, 3442, 3467, 3492, 3517, 3542, 3567, 3592,
+	3617, 3642, 3667, 3693, 3718, 3743, 3768, 3793, 3818, 3843, 3868, 3893,
+	3918, 3943, 3969, 3994, 4019, 4044, 4069, 4094, 4119, 4144, 4169, 4194,
+	4219, 4244, 4270, 4295, 4320, 4345, 4370, 4395, 4420, 4445, 4470, 4495,
+	4520, 4545, 4570, 4596, 4621, 4646, 4671, 4696, 4721, 4746, 4771, 4796,
+	4821, 4846, 4871, 4896, 4921, 4946, 4972, 4997, 5022, 5047, 5072, 5097,
+	5122, 5147, 5172, 5197, 5222, 5247, 5272, 5297, 5322, 5347, 5372, 5397,
+	5422, 5448, 5473, 5498, 5523, 5548, 5573, 5598, 5623, 5648, 5673, 5698,
+	5723, 5748, 5773, 5798, 5823, 5848, 5873, 5898, 5923, 5948, 5973, 5998,
+	6023, 6048, 6073, 6098, 6123, 6148, 6173, 6199, 6224, 6249, 6274, 6299,
+	6324, 6349, 6374, 6399, 6424, 6449, 6474, 6499, 6524, 6549, 6574, 6599,
+	6624, 6649, 6674, 6699, 6724, 6749, 6774, 6799, 6824, 6849, 6874, 6899,
+	6924, 6949, 6974, 6999, 7024, 7049, 7074, 7099, 7124, 7149, 7174, 7199,
+	7224, 7249, 7273, 7298, 7323, 7348, 7373, 7398, 7423, 7448, 7473, 7498,
+	7523, 7548, 7573, 7598, 7623, 7648, 7673, 7698, 7723, 7748, 7773, 7798,
+	7823, 7848, 7873, 7898, 7923, 7947, 7972, 7997, 8022, 8047, 8072, 8097,
+	8122, 8147, 8172, 8197, 8222, 8247, 8272, 8297, 8322, 8346, 8371, 8396,
+	8421, 8446, 8471, 8496, 8521, 8546, 8571, 8596, 8621, 8646, 8670, 8695,
+	8720, 8745, 8770, 8795, 8820, 8845, 8870, 8895, 8919, 8944, 8969, 8994,
+	9019, 9044, 9069, 9094, 9119, 9144, 9168, 9193, 9218, 9243, 9268, 9293,
+	9318, 9343, 9367, 9392, 9417, 9442, 9467, 9492, 9517, 9542, 9566, 9591,
+	9616, 9641, 9666, 9691, 9716, 9740, 9765, 9790, 9815, 9840, 9865, 9890,
+	9914, 9939, 9964, 9989, 10014, 10039, 10063, 10088, 10113, 10138, 10163, 10188,
+	10212, 10237, 10262, 10287, 10312, 10336, 10361, 10386, 10411, 10436, 10461, 10485,
+	10510, 10535, 10560, 10585, 10609, 10634, 10659, 10684, 10709, 10733, 10758, 10783,
+	10808, 10833, 10857, 10882, 10907, 10932, 10956, 10981, 11006, 11031, 11056, 11080,
+	11105, 11130, 11155, 11179, 11204, 11229, 11254, 11278, 11303, 11328, 11353, 11377,
+	11402, 11427, 11452, 11476, 11501, 11526, 11551, 11575, 11600, 11625, 11650, 11674,
+	11699, 11724, 11749, 11773, 11798, 11823, 11847, 11872, 11897, 11922, 11946, 11971,
+	11996, 12020, 12045, 12070, 12095, 12119, 12144, 12169, 12193, 12218, 12243, 12267,
+	12292, 12317, 12341, 12366, 12391, 12415, 12440, 12465, 12490, 12514, 12539, 12564,
+	12588, 12613, 12638, 12662, 12687, 12711, 12736, 12761, 12785, 12810, 12835, 12859,
+	12884, 12909, 12933, 12958, 12983, 13007, 13032, 13056, 13081, 13106, 13130, 13155,
+	13180, 13204, 13229, 13253, 13278, 13303, 13327, 13352, 13376, 13401, 13426, 13450,
+	13475, 13499, 13524, 13549, 13573, 13598, 13622, 13647, 13672, 13696, 13721, 13745,
+	13770, 13794, 13819, 13844, 13868, 13893, 13917, 13942, 13966, 13991, 14016, 14040,
+	14065, 14089, 14114, 14138, 14163, 14187, 14212, 14236, 14261, 14285, 14310, 14334,
+	14359, 14384, 14408, 14433, 14457, 14482, 14506, 14531, 14555, 14580, 14604, 14629,
+	14653, 14678, 14702, 14727, 14751, 14776, 14800, 14825, 14849, 14874, 14898, 14922,
+	14947, 14971, 14996, 15020, 15045, 15069, 15094, 15118, 15143, 15167, 15192, 15216,
+	15240, 15265, 15289, 15314, 15338, 15363, 15387, 15411, 15436, 15460, 15485, 15509,
+	15534, 15558, 15582, 15607, 15631, 15656, 15680, 15704, 15729, 15753, 15778, 15802,
+	15826, 15851, 15875, 15900, 15924, 15948, 15973, 15997, 16021, 16046, 16070, 16095,
+	16119, 16143, 16168, 16192, 16216, 16241, 16265, 16289, 16314, 16338, 16362, 16387,
+	16411, 16435, 16460, 16484, 16508, 16533, 16557, 16581, 16606, 16630, 16654, 16679,
+	16703, 16727, 16751, 16776, 16800, 16824, 16849, 16873, 16897, 16922, 16946, 16970,
+	16994, 17019, 17043, 17067, 17091, 17116, 17140, 17164, 17188, 17213, 17237, 17261,
+	17285, 17310, 17334, 17358, 17382, 17407, 17431, 17455, 17479, 17504, 17528, 17552,
+	17576, 17600, 17625, 17649, 17673, 17697, 17721, 17746, 17770, 17794, 17818, 17842,
+	17867, 17891, 17915, 17939, 17963, 17987, 18012, 18036, 18060, 18084, 18108, 18132,
+	18156, 18181, 18205, 18229, 18253, 18277, 18301, 18325, 18350, 18374, 18398, 18422,
+	18446, 18470, 18494, 18518, 18543, 18567, 18591, 18615, 18639, 18663, 18687, 18711,
+	18735, 18759, 18783, 18808, 18832, 18856, 18880, 18904, 18928, 18952, 18976, 19000,
+	19024, 19048, 19072, 19096, 19120, 19144, 19168, 19192, 19216, 19240, 19264, 19288,
+	19313, 19337, 19361, 19385, 19409, 19433, 19457, 19481, 19505, 19529, 19553, 19577,
+	19600, 19624, 19648, 19672, 19696, 19720, 19744, 19768, 19792, 19816, 19840, 19864,
+	19888, 19912, 19936, 19960, 19984, 20008, 20032, 20056, 20080, 20103, 20127, 20151,
+	20175, 20199, 20223, 20247, 20271, 20295, 20319, 20343, 20366, 20390, 20414, 20438,
+	20462, 20486, 20510, 20534, 20557, 20581, 20605, 20629, 20653, 20677, 20701, 20724,
+	20748, 20772, 20796, 20820, 20844, 20867, 20891, 20915, 20939, 20963, 20987, 21010,
+	21034, 21058, 21082, 21106, 21129, 21153, 21177, 21201, 21224, 21248, 21272, 21296,
+	21320, 21343, 21367, 21391, 21415, 21438, 21462, 21486, 21510, 21533, 21557, 21581,
+	21604, 21628, 21652, 21676, 21699, 21723, 21747, 21771, 21794, 21818, 21842, 21865,
+	21889, 21913, 21936, 21960, 21984, 22007, 22031, 22055, 22078, 22102, 22126, 22149,
+	22173, 22197, 22220, 22244, 22268, 22291, 22315, 22339, 22362, 22386, 22409, 22433,
+	22457, 22480, 22504, 22527, 22551, 22575, 22598, 22622, 22645, 22669, 22693, 22716,
+	22740, 22763, 22787, 22810, 22834, 22858, 22881, 22905, 22928, 22952, 22975, 22999,
+	23022, 23046, 23069, 23093, 23116, 23140, 23163, 23187, 23210, 23234, 23257, 23281,
+	23304, 23328, 23351, 23375, 23398, 23422, 23445, 23469, 23492, 23516, 23539, 23563,
+	23586, 23610, 23633, 23656, 23680, 23703, 23727, 23750, 23774, 23797, 23820, 23844,
+	23867, 23891, 23914, 23937, 23961, 23984, 24008, 24031, 24054, 24078, 24101, 24124,
+	24148, 24171, 24195, 24218, 24241, 24265, 24288, 24311, 24335, 24358, 24381, 24405,
+	24428, 24451, 24475, 24498, 24521, 24545, 24568, 24591, 24614, 24638, 24661, 24684,
+	24708, 24731, 24754, 24777, 24801, 24824, 24847, 24870, 24894, 24917, 24940, 24963,
+	24987, 25010, 25033, 25056, 25080, 25103, 25126, 25149, 25172, 25196, 25219, 25242,
+	25265, 25288, 25312, 25335, 25358, 25381, 25404, 25427, 25451, 25474, 25497, 25520,
+	25543, 25566, 25589, 25613, 25636, 25659, 25682, 25705, 25728, 25751, 25774, 25798,
+	25821, 25844, 25867, 25890, 25913, 25936, 25959, 25982, 26005, 26028, 26051, 26075,
+	26098, 26121, 26144, 26167, 26190, 26213, 26236, 26259, 26282, 26305, 26328, 26351,
+	26374, 26397, 26420, 26443, 26466, 26489, 26512, 26535, 26558, 26581, 26604, 26627,
+	26650, 26673, 26696, 26719, 26742, 26765, 26787, 26810, 26833, 26856, 26879, 26902,
+	26925, 26948, 26971, 26994, 27017, 27040, 27062, 27085, 27108, 27131, 27154, 27177,
+	27200, 27223, 27245, 27268, 27291, 27314, 27337, 27360, 27382, 27405, 27428, 27451,
+	27474, 27497, 27519, 27542, 27565, 27588, 27611, 27633, 27656, 27679, 27702, 27725,
+	27747, 27770, 27793, 27816, 27838, 27861, 27884, 27907, 27929, 27952, 27975, 27998,
+	28020, 28043, 28066, 28088, 28111, 28134, 28156, 28179, 28202, 28225, 28247, 28270,
+	28293, 28315, 28338, 28361, 28383, 28406, 28429, 28451, 28474, 28496, 28519, 28542,
+	28564, 28587, 28610, 28632, 28655, 28677, 28700, 28723, 28745, 28768, 28790, 28813,
+	28835, 28858, 28881, 28903, 28926, 28948, 28971, 28993, 29016, 29038, 29061, 29083,
+	29106, 29129, 29151, 29174, 29196, 29219, 29241, 29264, 29286, 29308, 29331, 29353,
+	29376, 29398, 29421, 29443, 29466, 29488, 29511, 29533, 29555, 29578, 29600, 29623,
+	29645, 29668, 29690, 29712, 29735, 29757, 29780, 29802, 29824, 29847, 29869, 29891,
+	29914, 29936, 29959, 29981, 30003, 30026, 30048, 30070, 30093, 30115, 30137, 30160,
+	30182, 30204, 30226, 30249, 30271, 30293, 30316, 30338, 30360, 30382, 30405, 30427,
+	30449, 30472, 30494, 30516, 30538, 30560, 30583, 30605, 30627, 30649, 30672, 30694,
+	30716, 30738, 30760, 30783, 30805, 30827, 30849, 30871, 30893, 30916, 30938, 30960,
+	30982, 31004, 31026, 31049, 31071, 31093, 31115, 31137, 31159, 31181, 31203, 31225,
+	31248, 31270, 31292, 31314, 31336, 31358, 31380, 31402, 31424, 31446, 31468, 31490,
+	31512, 31534, 31556, 31578, 31600, 31622, 31644, 31666, 31688, 31710, 31732, 31754,
+	31776, 31798, 31820, 31842, 31864, 31886, 31908, 31930, 31952, 31974, 31996, 32018,
+	32040, 32062, 32084, 32106, 32127, 32149, 32171, 32193, 32215, 32237, 32259, 32281,
+	32303, 32324, 32346, 32368, 32390, 32412, 32434, 32456, 32477, 32499, 32521, 32543,
+	32565, 32586, 32608, 32630, 32652, 32674, 32695, 32717, 32739, 32761, 32783, 32804,
+	32826, 32848, 32870, 32891, 32913, 32935, 32956, 32978, 33000, 33022, 33043, 33065,
+	33087, 33108, 33130, 33152, 33173, 33195, 33217, 33238, 33260, 33282, 33303, 33325,
+	33347, 33368, 33390, 33412, 33433, 33455, 33476, 33498, 33520, 33541, 33563, 33584,
+	33606, 33628, 33649, 33671, 33692, 33714, 33735, 33757, 33778, 33800, 33821, 33843,
+	33865, 33886, 33908, 33929, 33951, 33972, 33994, 34015, 34037, 34058, 34079, 34101,
+	34122, 34144, 34165, 34187, 34208, 34230, 34251, 34272, 34294, 34315, 34337, 34358,
+	34380, 34401, 34422, 34444, 34465, 34486, 34508, 34529, 34551, 34572, 34593, 34615,
+	34636, 34657, 34679, 34700, 34721, 34743, 34764, 34785, 34806, 34828, 34849, 34870,
+	34892, 34913, 34934, 34955, 34977, 34998, 35019, 35040, 35062, 35083, 35104, 35125,
+	35146, 35168, 35189, 35210, 35231, 35252, 35274, 35295, 35316, 35337, 35358, 35380,
+	35401, 35422, 35443, 35464, 35485, 35506, 35527, 35549, 35570, 35591, 35612, 35633,
+	35654, 35675, 35696, 35717, 35738, 35759, 35781, 35802, 35823, 35844, 35865, 35886,
+	35907, 35928, 35949, 35970, 35991, 36012, 36033, 36054, 36075, 36096, 36117, 36138,
+	36159, 36180, 36201, 36222, 36243, 36263, 36284, 36305, 36326, 36347, 36368, 36389,
+	36410, 36431, 36452, 36473, 36493, 36514, 36535, 36556, 36577, 36598, 36619, 36639,
+	36660, 36681, 36702, 36723, 36744, 36764, 36785, 36806, 36827, 36848, 36868, 36889,
+	36910, 36931, 36951, 36972, 36993, 37014, 37034, 37055, 37076, 37097, 37117, 37138,
+	37159, 37179, 37200, 37221, 37241, 37262, 37283, 37303, 37324, 37345, 37365, 37386,
+	37407, 37427, 37448, 37469, 37489, 37510, 37530, 37551, 37572, 37592, 37613, 37633,
+	37654, 37674, 37695, 37716, 37736, 37757, 37777, 37798, 37818, 37839, 37859, 37880,
+	37900, 37921, 37941, 37962, 37982, 38003, 38023, 38044, 38064, 38085, 38105, 38126,
+	38146, 38166, 38187, 38207, 38228, 38248, 38269, 38289, 38309, 38330, 38350, 38370,
+	38391, 38411, 38432, 38452, 38472, 38493, 38513, 38533, 38554, 38574, 38594, 38615,
+	38635, 38655, 38675, 38696, 38716, 38736, 38757, 38777, 38797, 38817, 38838, 38858,
+	38878, 38898, 38919, 38939, 38959, 38979, 38999, 39020, 39040, 39060, 39080, 39100,
+	39120, 39141, 39161, 39181, 39201, 39221, 39241, 39261, 39282, 39302, 39322, 39342,
+	39362, 39382, 39402, 39422, 39442, 39462, 39482, 39503, 39523, 39543, 39563, 39583,
+	39603, 39623, 39643, 39663, 39683, 39703, 39723, 39743, 39763, 39783, 39803, 39823,
+	39843, 39863, 39882, 39902, 39922, 39942, 39962, 39982, 40002, 40022, 40042, 40062,
+	40082, 40102, 40121, 40141, 40161, 40181, 40201, 40221, 40241, 40260, 40280, 40300,
+	40320, 40340, 40359, 40379, 40399, 40419, 40439, 40458, 40478, 40498, 40518, 40537,
+	40557, 40577, 40597, 40616, 40636, 40656, 40675, 40695, 40715, 40735, 40754, 40774,
+	40794, 40813, 40833, 40853, 40872, 40892, 40912, 40931, 40951, 40970, 40990, 41010,
+	41029, 41049, 41068, 41088, 41108, 41127, 41147, 41166, 41186, 41205, 41225, 41244,
+	41264, 41283, 41303, 41323, 41342, 41362, 41381, 41401, 41420, 41439, 41459, 41478,
+	41498, 41517, 41537, 41556, 41576, 41595, 41614, 41634, 41653, 41673, 41692, 41711,
+	41731, 41750, 41770, 41789, 41808, 41828, 41847, 41866, 41886, 41905, 41924, 41944,
+	41963, 41982, 42002, 42021, 42040, 42059, 42079, 42098, 42117, 42136, 42156, 42175,
+	42194, 42213, 42233, 42252, 42271, 42290, 42309, 42329, 42348, 42367, 42386, 42405,
+	42424, 42444, 42463, 42482, 42501, 42520, 42539, 42558, 42578, 42597, 42616, 42635,
+	42654, 42673, 42692, 42711, 42730, 42749, 42768, 42787, 42806, 42825, 42844, 42863,
+	42882, 42901, 42920, 42939, 42958, 42977, 42996, 43015, 43034, 43053, 43072, 43091,
+	43110, 43129, 43148, 43167, 43186, 43205, 43223, 43242, 43261, 43280, 43299, 43318,
+	43337, 43356, 43374, 43393, 43412, 43431, 43450, 43469, 43487, 43506, 43525, 43544,
+	43562, 43581, 43600, 43619, 43638, 43656, 43675, 43694, 43713, 43731, 43750, 43769,
+	43787, 43806, 43825, 43843, 43862, 43881, 43899, 43918, 43937, 43955, 43974, 43993,
+	44011, 44030, 44049, 44067, 44086, 44104, 44123, 44141, 44160, 44179, 44197, 44216,
+	44234, 44253, 44271, 44290, 44308, 44327, 44345, 44364, 44382, 44401, 44419, 44438,
+	44456, 44475, 44493, 44512, 44530, 44549, 44567, 44585, 44604, 44622, 44641, 44659,
+	44677, 44696, 44714, 44733, 44751, 44769, 44788, 44806, 44824, 44843, 44861, 44879,
+	44898, 44916, 44934, 44953, 44971, 44989, 45007, 45026, 45044, 45062, 45080, 45099,
+	45117, 45135, 45153, 45172, 45190, 45208, 45226, 45244, 45262, 45281, 45299, 45317,
+	45335, 45353, 45371, 45390, 45408, 45426, 45444, 45462, 45480, 45498, 45516, 45534,
+	45552, 45571, 45589, 45607, 45625, 45643, 45661, 45679, 45697, 45715, 45733, 45751,
+	45769, 45787, 45805, 45823, 45841, 45859, 45877, 45895, 45912, 45930, 45948, 45966,
+	45984, 46002, 46020, 46038, 46056, 46074, 46091, 46109, 46127, 46145, 46163, 46181,
+	46199, 46216, 46234, 46252, 46270, 46288, 46305, 46323, 46341, 46359, 46376, 46394,
+	46412, 46430, 46447, 46465, 46483, 46501, 46518, 46536, 46554, 46571, 46589, 46607,
+	46624, 46642, 46660, 46677, 46695, 46713, 46730, 46748, 46765, 46783, 46801, 46818,
+	46836, 46853, 46871, 46889, 46906, 46924, 46941, 46959, 46976, 46994, 47011, 47029,
+	47046, 47064, 47081, 47099, 47116, 47134, 47151, 47169, 47186, 47204, 47221, 47238,
+	47256, 47273, 47291, 47308, 47325, 47343, 47360, 47378, 47395, 47412, 47430, 47447,
+	47464, 47482, 47499, 47516, 47534, 47551, 47568, 47585, 47603, 47620, 47637, 47654,
+	47672, 47689, 47706, 47723, 47741, 47758, 47775, 47792, 47809, 47827, 47844, 47861,
+	47878, 47895, 47912, 47930, 47947, 47964, 47981, 47998, 48015, 48032, 48049, 48067,
+	48084, 48101, 48118, 48135, 48152, 48169, 48186, 48203, 48220, 48237, 48254, 48271,
+	48288, 48305, 48322, 48339, 48356, 48373, 48390, 48407, 48424, 48441, 48458, 48474,
+	48491, 48508, 48525, 48542, 48559, 48576, 48593, 48610, 48626, 48643, 48660, 48677,
+	48694, 48711, 48727, 48744, 48761, 48778, 48795, 48811, 48828, 48845, 48862, 48878,
+	48895, 48912, 48929, 48945, 48962, 48979, 48995, 49012, 49029, 49045, 49062, 49079,
+	49095, 49112, 49129, 49145, 49162, 49179, 49195, 49212, 49228, 49245, 49262, 49278,
+	49295, 49311, 49328, 49344, 49361, 49377, 49394, 49410, 49427, 49443, 49460, 49476,
+	49493, 49509, 49526, 49542, 49559, 49575, 49592, 49608, 49624, 49641, 49657, 49674,
+	49690, 49706, 49723, 49739, 49756, 49772, 49788, 49805, 49821, 49837, 49854, 49870,
+	49886, 49902, 49919, 49935, 49951, 49968, 49984, 50000, 50016, 50033, 50049, 50065,
+	50081, 50097, 50114, 50130, 50146, 50162, 50178, 50195, 50211, 50227, 50243, 50259,
+	50275, 50291, 50307, 50324, 50340, 50356, 50372, 50388, 50404, 50420, 50436, 50452,
+	50468, 50484, 50500, 50516, 50532, 50548, 50564, 50580, 50596, 50612, 50628, 50644,
+	50660, 50676, 50692, 50708, 50724, 50740, 50756, 50771, 50787, 50803, 50819, 50835,
+	50851, 50867, 50882, 50898, 50914, 50930, 50946, 50962, 50977, 50993, 51009, 51025,
+	51041, 51056, 51072, 51088, 51104, 51119, 51135, 51151, 51166, 51182, 51198, 51213,
+	51229, 51245, 51260, 51276, 51292, 51307, 51323, 51339, 51354, 51370, 51386, 51401,
+	51417, 51432, 51448, 51463, 51479, 51495, 51510, 51526, 51541, 51557, 51572, 51588,
+	51603, 51619, 51634, 51650, 51665, 51681, 51696, 51711, 51727, 51742, 51758, 51773,
+	51789, 51804, 51819, 51835, 51850, 51865, 51881, 51896, 51911, 51927, 51942, 51957,
+	51973, 51988, 52003, 52019, 52034, 52049, 52065, 52080, 52095, 52110, 52126, 52141,
+	52156, 52171, 52186, 52202, 52217, 52232, 52247, 52262, 52277, 52293, 52308, 52323,
+	52338, 52353, 52368, 52383, 52398, 52414, 52429, 52444, 52459, 52474, 52489, 52504,
+	52519, 52534, 52549, 52564, 52579, 52594, 52609, 52624, 52639, 52654, 52669, 52684,
+	52699, 52714, 52729, 52744, 52759, 52773, 52788, 52803, 52818, 52833, 52848, 52863,
+	52878, 52892, 52907, 52922, 52937, 52952, 52967, 52981, 52996, 53011, 53026, 53040,
+	53055, 53070, 53085, 53099, 53114, 53129, 53144, 53158, 53173, 53188, 53202, 53217,
+	53232, 53246, 53261, 53276, 53290, 53305, 53319, 53334, 53349, 53363, 53378, 53392,
+	53407, 53422, 53436, 53451, 53465, 53480, 53494, 53509, 53523, 53538, 53552, 53567,
+	53581, 53596, 53610, 53625, 53639, 53653, 53668, 53682, 53697, 53711, 53726, 53740,
+	53754, 53769, 53783, 53797, 53812, 53826, 53840, 53855, 53869, 53883, 53898, 53912,
+	53926, 53941, 53955, 53969, 53983, 53998, 54012, 54026, 54040, 54054, 54069, 54083,
+	54097, 54111, 54125, 54140, 54154, 54168, 54182, 54196, 54210, 54224, 54239, 54253,
+	54267, 54281, 54295, 54309, 54323, 54337, 54351, 54365, 54379, 54393, 54407, 54421,
+	54435, 54449, 54463, 54477, 54491, 54505, 54519, 54533, 54547, 54561, 54575, 54589,
+	54603, 54617, 54630, 54644, 54658, 54672, 54686, 54700, 54714, 54727, 54741, 54755,
+	54769, 54783, 54796, 54810, 54824, 54838, 54852, 54865, 54879, 54893, 54906, 54920,
+	54934, 54948, 54961, 54975, 54989, 55002, 55016, 55030, 55043, 55057, 55071, 55084,
+	55098, 55111, 55125, 55139, 55152, 55166, 55179, 55193, 55206, 55220, 55233, 55247,
+	55260, 55274, 55288, 55301, 55314, 55328, 55341, 55355, 55368, 55382, 55395, 55409,
+	55422, 55435, 55449, 55462, 55476, 55489, 55502, 55516, 55529, 55542, 55556, 55569,
+	55582, 55596, 55609, 55622, 55636, 55649, 55662, 55675, 55689, 55702, 55715, 55728,
+	55742, 55755, 55768, 55781, 55794, 55808, 55821, 55834, 55847, 55860, 55873, 55887,
+	55900, 55913, 55926, 55939, 55952, 55965, 55978, 55991, 56004, 56017, 56030, 56043,
+	56056, 56069, 56082, 56095, 56108, 56121, 56134, 56147, 56160, 56173, 56186, 56199,
+	56212, 56225, 56238, 56251, 56264, 56277, 56289, 56302, 56315, 56328, 56341, 56354,
+	56367, 56379, 56392, 56405, 56418, 56431, 56443, 56456, 56469, 56482, 56494, 56507,
+	56520, 56533, 56545, 56558, 56571, 56583, 56596, 56609, 56621, 56634, 56647, 56659,
+	56672, 56684, 56697, 56710, 56722, 56735, 56747, 56760, 56773, 56785, 56798, 56810,
+	56823, 56835, 56848, 56860, 56873, 56885, 56898, 56910, 56923, 56935, 56948, 56960,
+	56972, 56985, 56997, 57010, 57022, 57034, 57047, 57059, 57072, 57084, 57096, 57109,
+	57121, 57133, 57145, 57158, 57170, 57182, 57195, 57207, 57219, 57231, 57244, 57256,
+	57268, 57280, 57293, 57305, 57317, 57329, 57341, 57353, 57366, 57378, 57390, 57402,
+	57414, 57426, 57438, 57450, 57463, 57475, 57487, 57499, 57511, 57523, 57535, 57547,
+	57559, 57571, 57583, 57595, 57607, 57619, 57631, 57643, 57655, 57667, 57679, 57691,
+	57703, 57714, 57726, 57738, 57750, 57762, 57774, 57786, 57798, 57809, 57821, 57833,
+	57845, 57857, 57869, 57880, 57892, 57904, 57916, 57927, 57939, 57951, 57963, 57974,
+	57986, 57998, 58009, 58021, 58033, 58045, 58056, 58068, 58079, 58091, 58103, 58114,
+	58126, 58138, 58149, 58161, 58172, 58184, 58195, 58207, 58219, 58230, 58242, 58253,
+	58265, 58276, 58288, 58299, 58311, 58322, 58334, 58345, 58356, 58368, 58379, 58391,
+	58402, 58414, 58425, 58436, 58448, 58459, 58470, 58482, 58493, 58504, 58516, 58527,
+	58538, 58550, 58561, 58572, 58583, 58595, 58606, 58617, 58628, 58640, 58651, 58662,
+	58673, 58685, 58696, 58707, 58718, 58729, 58740, 58751, 58763, 58774, 58785, 58796,
+	58807, 58818, 58829, 58840, 58851, 58862, 58873, 58885, 58896, 58907, 58918, 58929,
+	58940, 58951, 58962, 58972, 58983, 58994, 59005, 59016, 59027, 59038, 59049, 59060,
+	59071, 59082, 59093, 59103, 59114, 59125, 59136, 59147, 59158, 59168, 59179, 59190,
+	59201, 59212, 59222, 59233, 59244, 59255, 59265, 59276, 59287, 59297, 59308, 59319,
+	59330, 59340, 59351, 59362, 59372, 59383, 59393, 59404, 59415, 59425, 59436, 59446,
+	59457, 59468, 59478, 59489, 59499, 59510, 59520, 59531, 59541, 59552, 59562, 59573,
+	59583, 59594, 59604, 59615, 59625, 59635, 59646, 59656, 59667, 59677, 59687, 59698,
+	59708, 59719, 59729, 59739, 59750, 59760, 59770, 59781, 59791, 59801, 59811, 59822,
+	59832, 59842, 59852, 59863, 59873, 59883, 59893, 59903, 59914, 59924, 59934, 59944,
+	59954, 59964, 59975, 59985, 59995, 60005, 60015, 60025, 60035, 60045, 60055, 60065,
+	60075, 60086, 60096, 60106, 60116, 60126, 60136, 60146, 60156, 60166, 60175, 60185,
+	60195, 60205, 60215, 60225, 60235, 60245, 60255, 60265, 60275, 60284, 60294, 60304,
+	60314, 60324, 60334, 60343, 60353, 60363, 60373, 60383, 60392, 60402, 60412, 60422,
+	60431, 60441, 60451, 60460, 60470, 60480, 60490, 60499, 60509, 60518, 60528, 60538,
+	60547, 60557, 60567, 60576, 60586, 60595, 60605, 60614, 60624, 60634, 60643, 60653,
+	60662, 60672, 60681, 60691, 60700, 60710, 60719, 60728, 60738, 60747, 60757, 60766,
+	60776, 60785, 60794, 60804, 60813, 60823, 60832, 60841, 60851, 60860, 60869, 60879,
+	60888, 60897, 60906, 60916, 60925, 60934, 60943, 60953, 60962, 60971, 60980, 60990,
+	60999, 61008, 61017, 61026, 61035, 61045, 61054, 61063, 61072, 61081, 61090, 61099,
+	61108, 61117, 61127, 61136, 61145, 61154, 61163, 61172, 61181, 61190, 61199, 61208,
+	61217, 61226, 61235, 61244, 61253, 61261, 61270, 61279, 61288, 61297, 61306, 61315,
+	61324, 61333, 61341, 61350, 61359, 61368, 61377, 61386, 61394, 61403, 61412, 61421,
+	61429, 61438, 61447, 61456, 61464, 61473, 61482, 61491, 61499, 61508, 61517, 61525,
+	61534, 61543, 61551, 61560, 61568, 61577, 61586, 61594, 61603, 61611, 61620, 61628,
+	61637, 61646, 61654, 61663, 61671, 61680, 61688, 61697, 61705, 61713, 61722, 61730,
+	61739, 61747, 61756, 61764, 61772, 61781, 61789, 61798, 61806, 61814, 61823, 61831,
+	61839, 61848, 61856, 61864, 61873, 61881, 61889, 61897, 61906, 61914, 61922, 61930,
+	61939, 61947, 61955, 61963, 61971, 61979, 61988, 61996, 62004, 62012, 62020, 62028,
+	62036, 62045, 62053, 62061, 62069, 62077, 62085, 62093, 62101, 62109, 62117, 62125,
+	62133, 62141, 62149, 62157, 62165, 62173, 62181, 62189, 62197, 62205, 62212, 62220,
+	62228, 62236, 62244, 62252, 62260, 62268, 62275, 62283, 62291, 62299, 62307, 62314,
+	62322, 62330, 62338, 62346, 62353, 62361, 62369, 62376, 62384, 62392, 62400, 62407,
+	62415, 62423, 62430, 62438, 62445, 62453, 62461, 62468, 62476, 62483, 62491, 62499,
+	62506, 62514, 62521, 62529, 62536, 62544, 62551, 62559, 62566, 62574, 62581, 62589,
+	62596, 62604, 62611, 62618, 62626, 62633, 62641, 62648, 62655, 62663, 62670, 62677,
+	62685, 62692, 62699, 62707, 62714, 62721, 62729, 62736, 62743, 62750, 62758, 62765,
+	62772, 62779, 62787, 62794, 62801, 62808, 62815, 62822, 62830, 62837, 62844, 62851,
+	62858, 62865, 62872, 62879, 62886, 62894, 62901, 62908, 62915, 62922, 62929, 62936,
+	62943, 62950, 62957, 62964, 62971, 62978, 62985, 62992, 62998, 63005, 63012, 63019,
+	63026, 63033, 63040, 63047, 63054, 63060, 63067, 63074, 63081, 63088, 63095, 63101,
+	63108, 63115, 63122, 63128, 63135, 63142, 63149, 63155, 63162, 63169, 63175, 63182,
+	63189, 63195, 63202, 63209, 63215, 63222, 63229, 63235, 63242, 63248, 63255, 63262,
+	63268, 63275, 63281, 63288, 63294, 63301, 63307, 63314, 63320, 63327, 63333, 63340,
+	63346, 63353, 63359, 63365, 63372, 63378, 63385, 63391, 63397, 63404, 63410, 63416,
+	63423, 63429, 63435, 63442, 63448, 63454, 63461, 63467, 63473, 63479, 63486, 63492,
+	63498, 63504, 63510, 63517, 63523, 63529, 63535, 63541, 63547, 63554, 63560, 63566,
+	63572, 63578, 63584, 63590, 63596, 63602, 63608, 63614, 63621, 63627, 63633, 63639,
+	63645, 63651, 63657, 63663, 63668, 63674, 63680, 63686, 63692, 63698, 63704, 63710,
+	63716, 63722, 63728, 63733, 63739, 63745, 63751, 63757, 63763, 63768, 63774, 63780,
+	63786, 63792, 63797, 63803, 63809, 63814, 63820, 63826, 63832, 63837, 63843, 63849,
+	63854, 63860, 63866, 63871, 63877, 63882, 63888, 63894, 63899, 63905, 63910, 63916,
+	63922, 63927, 63933, 63938, 63944, 63949, 63955, 63960, 63966, 63971, 63976, 63982,
+	63987, 63993, 63998, 64004, 64009, 64014, 64020, 64025, 64031, 64036, 64041, 64047,
+	64052, 64057, 64062, 64068, 64073, 64078, 64084, 64089, 64094, 64099, 64105, 64110,
+	64115, 64120, 64125, 64131, 64136, 64141, 64146, 64151, 64156, 64161, 64167, 64172,
+	64177, 64182, 64187, 64192, 64197, 64202, 64207, 64212, 64217, 64222, 64227, 64232,
+	64237, 64242, 64247, 64252, 64257, 64262, 64267, 64272, 64277, 64282, 64287, 64291,
+	64296, 64301, 64306, 64311, 64316, 64320, 64325, 64330, 64335, 64340, 64344, 64349,
+	64354, 64359, 64363, 64368, 64373, 64378, 64382, 64387, 64392, 64396, 64401, 64406,
+	64410, 64415, 64420, 64424, 64429, 64433, 64438, 64443, 64447, 64452, 64456, 64461,
+	64465, 64470, 64474, 64479, 64483, 64488, 64492, 64497, 64501, 64506, 64510, 64514,
+	64519, 64523, 64528, 64532, 64536, 64541, 64545, 64550, 64554, 64558, 64563, 64567,
+	64571, 64575, 64580, 64584, 64588, 64593, 64597, 64601, 64605, 64609, 64614, 64618,
+	64622, 64626, 64630, 64635, 64639, 64643, 64647, 64651, 64655, 64659, 64663, 64667,
+	64672, 64676, 64680, 64684, 64688, 64692, 64696, 64700, 64704, 64708, 64712, 64716,
+	64720, 64724, 64728, 64732, 64735, 64739, 64743, 64747, 64751, 64755, 64759, 64763,
+	64766, 64770, 64774, 64778, 64782, 64786, 64789, 64793, 64797, 64801, 64804, 64808,
+	64812, 64816, 64819, 64823, 64827, 64830, 64834, 64838, 64841, 64845, 64849, 64852,
+	64856, 64859, 64863, 64867, 64870, 64874, 64877, 64881, 64884, 64888, 64892, 64895,
+	64899, 64902, 64905, 64909, 64912, 64916, 64919, 64923, 64926, 64930, 64933, 64936,
+	64940, 64943, 64947, 64950, 64953, 64957, 64960, 64963, 64967, 64970, 64973, 64976,
+	64980, 64983, 64986, 64989, 64993, 64996, 64999, 65002, 65006, 65009, 65012, 65015,
+	65018, 65021, 65025, 65028, 65031, 65034, 65037, 65040, 65043, 65046, 65049, 65052,
+	65055, 65058, 65061, 65064, 65067, 65070, 65073, 65076, 65079, 65082, 65085, 65088,
+	65091, 65094, 65097, 65100, 65103, 65106, 65109, 65111, 65114, 65117, 65120, 65123,
+	65126, 65128, 65131, 65134, 65137, 65139, 65142, 65145, 65148, 65150, 65153, 65156,
+	65159, 65161, 65164, 65167, 65169, 65172, 65175, 65177, 65180, 65182, 65185, 65188,
+	65190, 65193, 65195, 65198, 65200, 65203, 65205, 65208, 65210, 65213, 65215, 65218,
+	65220, 65223, 65225, 65228, 65230, 65233, 65235, 65237, 65240, 65242, 65245, 65247,
+	65249, 65252, 65254, 65256, 65259, 65261, 65263, 65265, 65268, 65270, 65272, 65275,
+	65277, 65279, 65281, 65283, 65286, 65288, 65290, 65292, 65294, 65296, 65299, 65301,
+	65303, 65305, 65307, 65309, 65311, 65313, 65315, 65317, 65320, 65322, 65324, 65326,
+	65328, 65330, 65332, 65334, 65336, 65338, 65339, 65341, 65343, 65345, 65347, 65349,
+	65351, 65353, 65355, 65357, 65358, 65360, 65362, 65364, 65366, 65368, 65369, 65371,
+	65373, 65375, 65376, 65378, 65380, 65382, 65383, 65385, 65387, 65388, 65390, 65392,
+	65393, 65395, 65397, 65398, 65400, 65402, 65403, 65405, 65406, 65408, 65410, 65411,
+	65413, 65414, 65416, 65417, 65419, 65420, 65422, 65423, 65425, 65426, 65428, 65429,
+	65430, 65432, 65433, 65435, 65436, 65437, 65439, 65440, 65442, 65443, 65444, 65446,
+	65447, 65448, 65449, 65451, 65452, 65453, 65455, 65456, 65457, 65458, 65460, 65461,
+	65462, 65463, 65464, 65465, 65467, 65468, 65469, 65470, 65471, 65472, 65473, 65474,
+	65476, 65477, 65478, 65479, 65480, 65481, 65482, 65483, 65484, 65485, 65486, 65487,
+	65488, 65489, 65490, 65491, 65492, 65493, 65493, 65494, 65495, 65496, 65497, 65498,
+	65499, 65500, 65500, 65501, 65502, 65503, 65504, 65504, 65505, 65506, 65507, 65507,
+	65508, 65509, 65510, 65510, 65511, 65512, 65512, 65513, 65514, 65514, 65515, 65516,
+	65516, 65517, 65517, 65518, 65519, 65519, 65520, 65520, 65521, 65521, 65522, 65522,
+	65523, 65523, 65524, 65524, 65525, 65525, 65526, 65526, 65527, 65527, 65527, 65528,
+	65528, 65529, 65529, 65529, 65530, 65530, 65530, 65531, 65531, 65531, 65532, 65532,
+	65532, 65532, 65533, 65533, 65533, 65533, 65534, 65534, 65534, 65534, 65534, 65535,
+	65535, 65535, 65535, 65535, 65535, 65535, 65536, 65536, 65536, 65536, 65536, 65536,
+	65536, 65536, 65536, 65536, 65536
+};
+
+// atan(t) * 65536, rounded, for t from 0 to 1 in steps of 1 / 4096.
+static const int32_t sg_atan_table[4097] = {
+	0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176,
+	192, 208, 224, 240, 256, 272, 288, 304, 320, 336, 352, 368,
+	384, 400, 416, 432, 448, 464, 480, 496, 512, 528, 544, 560,
+	576, 592, 608, 624, 640, 656, 672, 688, 704, 720, 736, 752,
+	768, 784, 800, 816, 832, 848, 864, 880, 896, 912, 928, 944,
+	960, 976, 992, 1008, 1024, 1040, 1056, 1072, 1088, 1104, 1120, 1136,
+	1152, 1168, 1184, 1200, 1216, 1232, 1248, 1264, 1280, 1296, 1312, 1328,
+	1344, 1360, 1376, 1392, 1408, 1424, 1440, 1456, 1472, 1488, 1504, 1520,
+	1536, 1552, 1568, 1584, 1600, 1616, 1632, 1648, 1664, 1680, 1696, 1712,
+	1728, 1744, 1760, 1776, 1792, 1808, 1824, 1840, 1856, 1871, 1887, 1903,
+	1919, 1935, 1951, 1967, 1983, 1999, 2015, 2031, 2047, 2063, 2079, 2095,
+	2111, 2127, 2143, 2159, 2175, 2191, 2207, 2223, 2239, 2255, 2271, 2287,
+	2303, 2319, 2335, 2351, 2367, 2383, 2399, 2415, 2431, 2447, 2463, 2479,
+	2495, 2511, 2527, 2543, 2559, 2575, 2591, 2607, 2623, 2639, 2655, 2671,
+	2686, 2702, 2718, 2734, 2750, 2766, 2782, 2798, 2814, 2830, 2846, 2862,
+	2878, 2894, 2910, 2926, 2942, 2958, 2974, 2990, 3006, 3022, 3038, 3054,
+	3070, 3086, 3102, 3118, 3134, 3150, 3166, 3181, 3197, 3213, 3229, 3245,
+	3261, 3277, 3293, 3309, 3325, 3341, 3357, 3373, 3389, 3405, 3421, 3437,
+	3453, 3469, 3485, 3501, 3517, 3533, 3549, 3564, 3580, 3596, 3612, 3628,
+	3644, 3660, 3676, 3692, 3708, 3724, 3740, 3756, 3772, 3788, 3804, 3820,
+	3836, 3852, 3868, 3883, 3899, 3915, 3931, 3947, 3963, 3979, 3995, 4011,
+	4027, 4043, 4059, 4075, 4091, 4107, 4123, 4138, 4154, 4170, 4186, 4202,
+	4218, 4234, 4250, 4266, 4282, 4298, 4314, 4330, 4346, 4362, 4377, 4393,
+	4409, 4425, 4441, 4457, 4473, 4489, 4505, 4521, 4537, 4553, 4569, 4585,
+	4600, 4616, 4632, 4648, 4664, 4680, 4696, 4712, 4728, 4744, 4760, 4776,
+	4791, 4807, 4823, 4839, 4855, 4871, 4887, 4903, 4919, 4935, 4951, 4966,
+	4982, 4998, 5014, 5030, 5046, 5062, 5078, 5094, 5110, 5126, 5141, 5157,
+	5173, 5189, 5205, 5221, 5237, 5253, 5269, 5285, 5300, 5316, 5332, 5348,
+	5364, 5380, 5396, 5412, 5428, 5443, 5459, 5475, 5491, 5507, 5523, 5539,
+	5555, 5571, 5586, 5602, 5618, 5634, 5650, 5666, 5682, 5698, 5713, 5729,
+	5745, 5761, 5777, 5793, 5809, 5825, 5840, 5856, 5872, 5888, 5904, 5920,
+	5936, 5952, 5967, 5983, 5999, 6015, 6031, 6047, 6063, 6079, 6094, 6110,
+	6126, 6142, 6158, 6174, 6190, 6205, 6221, 6237, 6253, 6269, 6285, 6301,
+	6316, 6332, 6348, 6364, 6380, 6396, 6411, 6427, 6443, 6459, 6475, 6491,
+	6507, 6522, 6538, 6554, 6570, 6586, 6602, 6617, 6633, 6649, 6665, 6681,
+	6697, 6712, 6728, 6744, 6760, 6776, 6792, 6807, 6823, 6839, 6855, 6871,
+	6887, 6902, 6918, 6934, 6950, 6966, 6981, 6997, 7013, 7029, 7045, 7061,
+	7076, 7092, 7108, 7124, 7140, 7155, 7171, 7187, 7203, 7219, 7234, 7250,
+	7266, 7282, 7298, 7313, 7329, 7345, 7361, 7377, 7392, 7408, 7424, 7440,
+	7456, 7471, 7487, 7503, 7519, 7535, 7550, 7566, 7582, 7598, 7614, 7629,
+	7645, 7661, 7677, 7692, 7708, 7724, 7740, 7756, 7771, 7787, 7803, 7819,
+	7834, 7850, 7866, 7882, 7898, 7913, 7929, 7945, 7961, 7976, 7992, 8008,
+	8024, 8039, 8055, 8071, 8087, 8102, 8118, 8134, 8150, 8165, 8181, 8197,
+	8213, 8228, 8244, 8260, 8276, 8291, 8307, 8323, 8339, 8354, 8370, 8386,
+	8402, 8417, 8433, 8449, 8465, 8480, 8496, 8512, 8528, 8543, 8559, 8575,
+	8590, 8606, 8622, 8638, 8653, 8669, 8685, 8701, 8716, 8732, 8748, 8763,
+	8779, 8795, 8811, 8826, 8842, 8858, 8873, 8889, 8905, 8920, 8936, 8952,
+	8968, 8983, 8999, 9015, 9030, 9046, 9062, 9077, 9093, 9109, 9125, 9140,
+	9156, 9172, 9187, 9203, 9219, 9234, 9250, 9266, 9281, 9297, 9313, 9328,
+	9344, 9360, 9376, 9391, 9407, 9423, 9438, 9454, 9470, 9485, 9501, 9517,
+	9532, 9548, 9564, 9579, 9595, 9611, 9626, 9642, 9657, 9673, 9689, 9704,
+	9720, 9736, 9751, 9767, 9783, 9798, 9814, 9830, 9845, 9861, 9877, 9892,
+	9908, 9923, 9939, 9955, 9970, 9986, 10002, 10017, 10033, 10049, 10064, 10080,
+	10095, 10111, 10127, 10142, 10158, 10173, 10189, 10205, 10220, 10236, 10252, 10267,
+	10283, 10298, 10314, 10330, 10345, 10361, 10376, 10392, 10408, 10423, 10439, 10454,
+	10470, 10486, 10501, 10517, 10532, 10548, 10564, 10579, 10595, 10610, 10626, 10641,
+	10657, 10673, 10688, 10704, 10719, 10735, 10751, 10766, 10782, 10797, 10813, 10828,
+	10844, 10860, 10875, 10891, 10906, 10922, 10937, 10953, 10968, 10984, 11000, 11015,
+	11031, 11046, 11062, 11077, 11093, 11108, 11124, 11139, 11155, 11171, 11186, 11202,
+	11217, 11233, 11248, 11264, 11279, 11295, 11310, 11326, 11341, 11357, 11372, 11388,
+	11403, 11419, 11435, 11450, 11466, 11481, 11497, 11512, 11528, 11543, 11559, 11574,
+	11590, 11605, 11621, 11636, 11652, 11667, 11683, 11698, 11714, 11729, 11745, 11760,
+	11776, 11791, 11807, 11822, 11838, 11853, 11869, 11884, 11899, 11915, 11930, 11946,
+	11961, 11977, 11992, 12008, 12023, 12039, 12054, 12070, 12085, 12101, 12116, 12132,
+	12147, 12162, 12178, 12193, 12209, 12224, 12240, 12255, 12271, 12286, 12301, 12317,
+	12332, 12348, 12363, 12379, 12394, 12410, 12425, 12440, 12456, 12471, 12487, 12502,
+	12518, 12533, 12548, 12564, 12579, 12595, 12610, 12625, 12641, 12656, 12672, 12687,
+	12703, 12718, 12733, 12749, 12764, 12780, 12795, 12810, 12826, 12841, 12856, 12872,
+	12887, 12903, 12918, 12933, 12949, 12964, 12980, 12995, 13010, 13026, 13041, 13056,
+	13072, 13087, 13103, 13118, 13133, 13149, 13164, 13179, 13195, 13210, 13225, 13241,
+	13256, 13272, 13287, 13302, 13318, 13333, 13348, 13364, 13379, 13394, 13410, 13425,
+	13440, 13456, 13471, 13486, 13502, 13517, 13532, 13548, 13563, 13578, 13594, 13609,
+	13624, 13640, 13655, 13670, 13686, 13701, 13716, 13731, 13747, 13762, 13777, 13793,
+	13808, 13823, 13839, 13854, 13869, 13884, 13900, 13915, 13930, 13946, 13961, 13976,
+	13991, 14007, 14022, 14037, 14053, 14068, 14083, 14098, 14114, 14129, 14144, 14159,
+	14175, 14190, 14205, 14221, 14236, 14251, 14266, 14282, 14297, 14312, 14327, 14343,
+	14358, 14373, 14388, 14404, 14419, 14434, 14449, 14464, 14480, 14495, 14510, 14525,
+	14541, 14556, 14571, 14586, 14601, 14617, 14632, 14647, 14662, 14678, 14693, 14708,
+	14723, 14738, 14754, 14769, 14784, 14799, 14814, 14830, 14845, 14860, 14875, 14890,
+	14906, 14921, 14936, 14951, 14966, 14981, 14997, 15012, 15027, 15042, 15057, 15073,
+	15088, 15103, 15118, 15133, 15148, 15163, 15179, 15194, 15209, 15224, 15239, 15254,
+	15270, 15285, 15300, 15315, 15330, 15345, 15360, 15376, 15391, 15406, 15421, 15436,
+	15451, 15466, 15481, 15497, 15512, 15527, 15542, 15557, 15572, 15587, 15602, 15617,
+	15633, 15648, 15663, 15678, 15693, 15708, 15723, 15738, 15753, 15768, 15784, 15799,
+	15814, 15829, 15844, 15859, 15874, 15889, 15904, 15919, 15934, 15949, 15965, 15980,
+	15995, 16010, 16025, 16040, 16055, 16070, 16085, 16100, 16115, 16130, 16145, 16160,
+	16175, 16190, 16205, 16220, 16236, 16251, 16266, 16281, 16296, 16311, 16326, 16341,
+	16356, 16371, 16386, 16401, 16416, 16431, 16446, 16461, 16476, 16491, 16506, 16521,
+	16536, 16551, 16566, 16581, 16596, 16611, 16626, 16641, 16656, 16671, 16686, 16701,
+	16716, 16731, 16746, 16761, 16776, 16791, 16806, 16821, 16836, 16851, 16866, 16881,
+	16895, 16910, 16925, 16940, 16955, 16970, 16985, 17000, 17015, 17030, 17045, 17060,
+	17075, 17090, 17105, 17120, 17135, 17150, 17164, 17179, 17194, 17209, 17224, 17239,
+	17254, 17269, 17284, 17299, 17314, 17329, 17343, 17358, 17373, 17388, 17403, 17418,
+	17433, 17448, 17463, 17478, 17492, 17507, 17522, 17537, 17552, 17567, 17582, 17597,
+	17611, 17626, 17641, 17656, 17671, 17686, 17701, 17716, 17730, 17745, 17760, 17775,
+	17790, 17805, 17819, 17834, 17849, 17864, 17879, 17894, 17909, 17923, 17938, 17953,
+	17968, 17983, 17997, 18012, 18027, 18042, 18057, 18072, 18086, 18101, 18116, 18131,
+	18146, 18160, 18175, 18190, 18205, 18220, 18234, 18249, 18264, 18279, 18294, 18308,
+	18323, 18338, 18353, 18367, 18382, 18397, 18412, 18427, 18441, 18456, 18471, 18486,
+	18500, 18515, 18530, 18545, 18559, 18574, 18589, 18604, 18618, 18633, 18648, 18663,
+	18677, 18692, 18707, 18722, 18736, 18751, 18766, 18780, 18795, 18810, 18825, 18839,
+	18854, 18869, 18883, 18898, 18913, 18928, 18942, 18957, 18972, 18986, 19001, 19016,
+	19030, 19045, 19060, 19074, 19089, 19104, 19119, 19133, 19148, 19163, 19177, 19192,
+	19207, 19221, 19236, 19251, 19265, 19280, 19295, 19309, 19324, 19338, 19353, 19368,
+	19382, 19397, 19412, 19426, 19441, 19456, 19470, 19485, 19499, 19514, 19529, 19543,
+	19558, 19573, 19587, 19602, 19616, 19631, 19646, 19660, 19675, 19689, 19704, 19719,
+	19733, 19748, 19762, 19777, 19792, 19806, 19821, 19835, 19850, 19864, 19879, 19894,
+	19908, 19923, 19937, 19952, 19966, 19981, 19996, 20010, 20025, 20039, 20054, 20068,
+	20083, 20097, 20112, 20126, 20141, 20156, 20170, 20185, 20199, 20214, 20228, 20243,
+	20257, 20272, 20286, 20301, 20315, 20330, 20344, 20359, 20373, 20388, 20402, 20417,
+	20431, 20446, 20460, 20475, 20489, 20504, 20518, 20533, 20547, 20562, 20576, 20591,
+	20605, 20620, 20634, 20648, 20663, 20677, 20692, 20706, 20721, 20735, 20750, 20764,
+	20779, 20793, 20807, 20822, 20836, 20851, 20865, 20880, 20894, 20908, 20923, 20937,
+	20952, 20966, 20981, 20995, 21009, 21024, 21038, 21053, 21067, 21081, 21096, 21110,
+	21125, 21139, 21153, 21168, 21182, 21197, 21211, 21225, 21240, 21254, 21268, 21283,
+	21297, 21312, 21326, 21340, 21355, 21369, 21383, 21398, 21412, 21426, 21441, 21455,
+	21469, 21484, 21498, 21513, 21527, 21541, 21556, 21570, 21584, 21598, 21613, 21627,
+	21641, 21656, 21670, 21684, 21699, 21713, 21727, 21742, 21756, 21770, 21785, 21799,
+	21813, 21827, 21842, 21856, 21870, 21885, 21899, 21913, 21927, 21942, 21956, 21970,
+	21984, 21999, 22013, 22027, 22042, 22056, 22070, 22084, 22099, 22113, 22127, 22141,
+	22156, 22170, 22184, 22198, 22212, 22227, 22241, 22255, 22269, 22284, 22298, 22312,
+	22326, 22340, 22355, 22369, 22383, 22397, 22411, 22426, 22440, 22454, 22468, 22482,
+	22497, 22511, 22525, 22539, 22553, 22568, 22582, 22596, 22610, 22624, 22638, 22653,
+	22667, 22681, 22695, 22709, 22723, 22738, 22752, 22766, 22780, 22794, 22808, 22822,
+	22836, 22851, 22865, 22879, 22893, 22907, 22921, 22935, 22950, 22964, 22978, 22992,
+	23006, 23020, 23034, 23048, 23062, 23076, 23091, 23105, 23119, 23133, 23147, 23161,
+	23175, 23189, 23203, 23217, 23231, 23245, 23260, 23274, 23288, 23302, 23316, 23330,
+	23344, 23358, 23372, 23386, 23400, 23414, 23428, 23442, 23456, 23470, 23484, 23498,
+	23512, 23526, 23540, 23554, 23568, 23583, 23597, 23611, 23625, 23639, 23653, 23667,
+	23681, 23695, 23709, 23723, 23737, 23751, 23765, 23779, 23792, 23806, 23820, 23834,
+	23848, 23862, 23876, 23890, 23904, 23918, 23932, 23946, 23960, 23974, 23988, 24002,
+	24016, 24030, 24044, 24058, 24072, 24086, 24100, 24113, 24127, 24141, 24155, 24169,
+	24183, 24197, 24211, 24225, 24239, 24253, 24267, 24280, 24294, 24308, 24322, 24336,
+	24350, 24364, 24378, 24392, 24406, 24419, 24433, 24447, 24461, 24475, 24489, 24503,
+	24516, 24530, 24544, 24558, 24572, 24586, 24600, 24613, 24627, 24641, 24655, 24669,
+	24683, 24697, 24710, 24724, 24738, 24752, 24766, 24779, 24793, 24807, 24821, 24835,
+	24849, 24862, 24876, 24890, 24904, 24918, 24931, 24945, 24959, 24973, 24987, 25000,
+	25014, 25028, 25042, 25055, 25069, 25083, 25097, 25110, 25124, 25138, 25152, 25166,
+	25179, 25193, 25207, 25221, 25234, 25248, 25262, 25275, 25289, 25303, 25317, 25330,
+	25344, 25358, 25372, 25385, 25399, 25413, 25426, 25440, 25454, 25468, 25481, 25495,
+	25509, 25522, 25536, 25550, 25563, 25577, 25591, 25604, 25618, 25632, 25645, 25659,
+	25673, 25686, 25700, 25714, 25727, 25741, 25755, 25768, 25782, 25796, 25809, 25823,
+	25837, 25850, 25864, 25878, 25891, 25905, 25918, 25932, 25946, 25959, 25973, 25987,
+	26000, 26014, 26027, 26041, 26055, 26068, 26082, 26095, 26109, 26123, 26136, 26150,
+	26163, 26177, 26190, 26204, 26218, 26231, 26245, 26258, 26272, 26285, 26299, 26313,
+	26326, 26340, 26353, 26367, 26380, 26394, 26407, 26421, 26435, 26448, 26462, 26475,
+	26489, 26502, 26516, 26529, 26543, 26556, 26570, 26583, 26597, 26610, 26624, 26637,
+	26651, 26664, 26678, 26691, 26705, 26718, 26732, 26745, 26759, 26772, 26786, 26799,
+	26813, 26826, 26839, 26853, 26866, 26880, 26893, 26907, 26920, 26934, 26947, 26961,
+	26974, 26987, 27001, 27014, 27028, 27041, 27055, 27068, 27081, 27095, 27108, 27122,
+	27135, 27148, 27162, 27175, 27189, 27202, 27216, 27229, 27242, 27256, 27269, 27282,
+	27296, 27309, 27323, 27336, 27349, 27363, 27376, 27389, 27403, 27416, 27430, 27443,
+	27456, 27470, 27483, 27496, 27510, 27523, 27536, 27550, 27563, 27576, 27590, 27603,
+	27616, 27630, 27643, 27656, 27670, 27683, 27696, 27709, 27723, 27736, 27749, 27763,
+	27776, 27789, 27803, 27816, 27829, 27842, 27856, 27869, 27882, 27896, 27909, 27922,
+	27935, 27949, 27962, 27975, 27988, 28002, 28015, 28028, 28041, 28055, 28068, 28081,
+	28094, 28108, 28121, 28134, 28147, 28160, 28174, 28187, 28200, 28213, 28227, 28240,
+	28253, 28266, 28279, 28293, 28306, 28319, 28332, 28345, 28359, 28372, 28385, 28398,
+	28411, 28424, 28438, 28451, 28464, 28477, 28490, 28503, 28517, 28530, 28543, 28556,
+	28569, 28582, 28596, 28609, 28622, 28635, 28648, 28661, 28674, 28687, 28701, 28714,
+	28727, 28740, 28753, 28766, 28779, 28792, 28805, 28819, 28832, 28845, 28858, 28871,
+	28884, 28897, 28910, 28923, 28936, 28949, 28963, 28976, 28989, 29002, 29015, 29028,
+	29041, 29054, 29067, 29080, 29093, 29106, 29119, 29132, 29145, 29158, 29171, 29184,
+	29197, 29210, 29224, 29237, 29250, 29263, 29276, 29289, 29302, 29315, 29328, 29341,
+	29354, 29367, 29380, 29393, 29406, 29419, 29432, 29445, 29458, 29471, 29483, 29496,
+	29509, 29522, 29535, 29548, 29561, 29574, 29587, 29600, 29613, 29626, 29639, 29652,
+	29665, 29678, 29691, 29704, 29717, 29730, 29742, 29755, 29768, 29781, 29794, 29807,
+	29820, 29833, 29846, 29859, 29872, 29885, 29897, 29910, 29923, 29936, 29949, 29962,
+	29975, 29988, 30000, 30013, 30026, 30039, 30052, 30065, 30078, 30091, 30103, 30116,
+	30129, 30142, 30155, 30168, 30180, 30193, 30206, 30219, 30232, 30245, 30257, 30270,
+	30283, 30296, 30309, 30322, 30334, 30347, 30360, 30373, 30386, 30398, 30411, 30424,
+	30437, 30450, 30462, 30475, 30488, 30501, 30513, 30526, 30539, 30552, 30565, 30577,
+	30590, 30603, 30616, 30628, 30641, 30654, 30667, 30679, 30692, 30705, 30718, 30730,
+	30743, 30756, 30768, 30781, 30794, 30807, 30819, 30832, 30845, 30857, 30870, 30883,
+	30896, 30908, 30921, 30934, 30946, 30959, 30972, 30984, 30997, 31010, 31022, 31035,
+	31048, 31060, 31073, 31086, 31098, 31111, 31124, 31136, 31149, 31162, 31174, 31187,
+	31200, 31212, 31225, 31238, 31250, 31263, 31275, 31288, 31301, 31313, 31326, 31339,
+	31351, 31364, 31376, 31389, 31402, 31414, 31427, 31439, 31452, 31465, 31477, 31490,
+	31502, 31515, 31527, 31540, 31553, 31565, 31578, 31590, 31603, 31615, 31628, 31641,
+	31653, 31666, 31678, 31691, 31703, 31716, 31728, 31741, 31753, 31766, 31778, 31791,
+	31803, 31816, 31829, 31841, 31854, 31866, 31879, 31891, 31904, 31916, 31929, 31941,
+	31954, 31966, 31978, 31991, 32003, 32016, 32028, 32041, 32053, 32066, 32078, 32091,
+	32103, 32116, 32128, 32141, 32153, 32165, 32178, 32190, 32203, 32215, 32228, 32240,
+	32253, 32265, 32277, 32290, 32302, 32315, 32327, 32339, 32352, 32364, 32377, 32389,
+	32401, 32414, 32426, 32439, 32451, 32463, 32476, 32488, 32501, 32513, 32525, 32538,
+	32550, 32562, 32575, 32587, 32600, 32612, 32624, 32637, 32649, 32661, 32674, 32686,
+	32698, 32711, 32723, 32735, 32748, 32760, 32772, 32785, 32797, 32809, 32822, 32834,
+	32846, 32858, 32871, 32883, 32895, 32908, 32920, 32932, 32945, 32957, 32969, 32981,
+	32994, 33006, 33018, 33030, 33043, 33055, 33067, 33079, 33092, 33104, 33116, 33129,
+	33141, 33153, 33165, 33177, 33190, 33202, 33214, 33226, 33239, 33251, 33263, 33275,
+	33288, 33300, 33312, 33324, 33336, 33349, 33361, 33373, 33385, 33397, 33410, 33422,
+	33434, 33446, 33458, 33470, 33483, 33495, 33507, 33519, 33531, 33543, 33556, 33568,
+	33580, 33592, 33604, 33616, 33629, 33641, 33653, 33665, 33677, 33689, 33701, 33713,
+	33726, 33738, 33750, 33762, 33774, 33786, 33798, 33810, 33823, 33835, 33847, 33859,
+	33871, 33883, 33895, 33907, 33919, 33931, 33943, 33956, 33968, 33980, 33992, 34004,
+	34016, 34028, 34040, 34052, 34064, 34076, 34088, 34100, 34112, 34124, 34136, 34148,
+	34160, 34172, 34185, 34197, 34209, 34221, 34233, 34245, 34257, 34269, 34281, 34293,
+	34305, 34317, 34329, 34341, 34353, 34365, 34377, 34389, 34401, 34413, 34425, 34437,
+	34448, 34460, 34472, 34484, 34496, 34508, 34520, 34532, 34544, 34556, 34568, 34580,
+	34592, 34604, 34616, 34628, 34640, 34652, 34664, 34675, 34687, 34699, 34711, 34723,
+	34735, 34747, 34759, 34771, 34783, 34795, 34806, 34818, 34830, 34842, 34854, 34866,
+	34878, 34890, 34902, 34913, 34925, 34937, 34949, 34961, 34973, 34985, 34997, 35008,
+	35020, 35032, 35044, 35056, 35068, 35079, 35091, 35103, 35115, 35127, 35139, 35150,
+	35162, 35174, 35186, 35198, 35209, 35221, 35233, 35245, 35257, 35268, 35280, 35292,
+	35304, 35316, 35327, 35339, 35351, 35363, 35375, 35386, 35398, 35410, 35422, 35433,
+	35445, 35457, 35469, 35480, 35492, 35504, 35516, 35527, 35539, 35551, 35563, 35574,
+	35586, 35598, 35610, 35621, 35633, 35645, 35656, 35668, 35680, 35692, 35703, 35715,
+	35727, 35738, 35750, 35762, 35773, 35785, 35797, 35808, 35820, 35832, 35843, 35855,
+	35867, 35878, 35890, 35902, 35913, 35925, 35937, 35948, 35960, 35972, 35983, 35995,
+	36007, 36018, 36030, 36042, 36053, 36065, 36076, 36088, 36100, 36111, 36123, 36135,
+	36146, 36158, 36169, 36181, 36193, 36204, 36216, 36227, 36239, 36250, 36262, 36274,
+	36285, 36297, 36308, 36320, 36332, 36343, 36355, 36366, 36378, 36389, 36401, 36412,
+	36424, 36435, 36447, 36459, 36470, 36482, 36493, 36505, 36516, 36528, 36539, 36551,
+	36562, 36574, 36585, 36597, 36608, 36620, 36631, 36643, 36654, 36666, 36677, 36689,
+	36700, 36712, 36723, 36735, 36746, 36758, 36769, 36781, 36792, 36804, 36815, 36827,
+	36838, 36849, 36861, 36872, 36884, 36895, 36907, 36918, 36930, 36941, 36952, 36964,
+	36975, 36987, 36998, 37010, 37021, 37032, 37044, 37055, 37067, 37078, 37089, 37101,
+	37112, 37124, 37135, 37146, 37158, 37169, 37180, 37192, 37203, 37215, 37226, 37237,
+	37249, 37260, 37271, 37283, 37294, 37306, 37317, 37328, 37340, 37351, 37362, 37374,
+	37385, 37396, 37408, 37419, 37430, 37442, 37453, 37464, 37476, 37487, 37498, 37509,
+	37521, 37532, 37543, 37555, 37566, 37577, 37589, 37600, 37611, 37622, 37634, 37645,
+	37656, 37667, 37679, 37690, 37701, 37713, 37724, 37735, 37746, 37758, 37769, 37780,
+	37791, 37803, 37814, 37825, 37836, 37848, 37859, 37870, 37881, 37892, 37904, 37915,
+	37926, 37937, 37948, 37960, 37971, 37982, 37993, 38004, 38016, 38027, 38038, 38049,
+	38060, 38072, 38083, 38094, 38105, 38116, 38128, 38139, 38150, 38161, 38172, 38183,
+	38194, 38206, 38217, 38228, 38239, 38250, 38261, 38272, 38284, 38295, 38306, 38317,
+	38328, 38339, 38350, 38361, 38373, 38384, 38395, 38406, 38417, 38428, 38439, 38450,
+	38461, 38473, 38484, 38495, 38506, 38517, 38528, 38539, 38550, 38561, 38572, 38583,
+	38594, 38605, 38617, 38628, 38639, 38650, 38661, 38672, 38683, 38694, 38705, 38716,
+	38727, 38738, 38749, 38760, 38771, 38782, 38793, 38804, 38815, 38826, 38837, 38848,
+	38859, 38870, 38881, 38892, 38903, 38914, 38925, 38936, 38947, 38958, 38969, 38980,
+	38991, 39002, 39013, 39024, 39035, 39046, 39057, 39068, 39079, 39090, 39101, 39112,
+	39123, 39134, 39144, 39155, 39166, 39177, 39188, 39199, 39210, 39221, 39232, 39243,
+	39254, 39265, 39276, 39286, 39297, 39308, 39319, 39330, 39341, 39352, 39363, 39374,
+	39385, 39395, 39406, 39417, 39428, 39439, 39450, 39461, 39472, 39482, 39493, 39504,
+	39515, 39526, 39537, 39547, 39558, 39569, 39580, 39591, 39602, 39613, 39623, 39634,
+	39645, 39656, 39667, 39677, 39688, 39699, 39710, 39721, 39732, 39742, 39753, 39764,
+	39775, 39786, 39796, 39807, 39818, 39829, 39839, 39850, 39861, 39872, 39883, 39893,
+	39904, 39915, 39926, 39936, 39947, 39958, 39969, 39979, 39990, 40001, 40012, 40022,
+	40033, 40044, 40055, 40065, 40076, 40087, 40097, 40108, 40119, 40130, 40140, 40151,
+	40162, 40172, 40183, 40194, 40205, 40215, 40226, 40237, 40247, 40258, 40269, 40279,
+	40290, 40301, 40311, 40322, 40333, 40343, 40354, 40365, 40375, 40386, 40397, 40407,
+	40418, 40429, 40439, 40450, 40461, 40471, 40482, 40493, 40503, 40514, 40524, 40535,
+	40546, 40556, 40567, 40577, 40588, 40599, 40609, 40620, 40631, 40641, 40652, 40662,
+	40673, 40683, 40694, 40705, 40715, 40726, 40736, 40747, 40758, 40768, 40779, 40789,
+	40800, 40810, 40821, 40831, 40842, 40853, 40863, 40874, 40884, 40895, 40905, 40916,
+	40926, 40937, 40947, 40958, 40968, 40979, 40989, 41000, 41010, 41021, 41031, 41042,
+	41053, 41063, 41073, 41084, 41094, 41105, 41115, 41126, 41136, 41147, 41157, 41168,
+	41178, 41189, 41199, 41210, 41220, 41231, 41241, 41252, 41262, 41272, 41283, 41293,
+	41304, 41314, 41325, 41335, 41346, 41356, 41366, 41377, 41387, 41398, 41408, 41419,
+	41429, 41439, 41450, 41460, 41471, 41481, 41491, 41502, 41512, 41523, 41533, 41543,
+	41554, 41564, 41575, 41585, 41595, 41606, 41616, 41626, 41637, 41647, 41657, 41668,
+	41678, 41689, 41699, 41709, 41720, 41730, 41740, 41751, 41761, 41771, 41782, 41792,
+	41802, 41813, 41823, 41833, 41844, 41854, 41864, 41875, 41885, 41895, 41905, 41916,
+	41926, 41936, 41947, 41957, 41967, 41977, 41988, 41998, 42008, 42019, 42029, 42039,
+	42049, 42060, 42070, 42080, 42090, 42101, 42111, 42121, 42132, 42142, 42152, 42162,
+	42172, 42183, 42193, 42203, 42213, 42224, 42234, 42244, 42254, 42265, 42275, 42285,
+	42295, 42305, 42316, 42326, 42336, 42346, 42356, 42367, 42377, 42387, 42397, 42407,
+	42418, 42428, 42438, 42448, 42458, 42468, 42479, 42489, 42499, 42509, 42519, 42529,
+	42540, 42550, 42560, 42570, 42580, 42590, 42600, 42611, 42621, 42631, 42641, 42651,
+	42661, 42671, 42681, 42692, 42702, 42712, 42722, 42732, 42742, 42752, 42762, 42772,
+	42783, 42793, 42803, 42813, 42823, 42833, 42843, 42853, 42863, 42873, 42883, 42894,
+	42904, 42914, 42924, 42934, 42944, 42954, 42964, 42974, 42984, 42994, 43004, 43014,
+	43024, 43034, 43044, 43054, 43064, 43074, 43084, 43094, 43104, 43114, 43124, 43135,
+	43145, 43155, 43165, 43175, 43185, 43195, 43205, 43215, 43225, 43235, 43245, 43255,
+	43264, 43274, 43284, 43294, 43304, 43314, 43324, 43334, 43344, 43354, 43364, 43374,
+	43384, 43394, 43404, 43414, 43424, 43434, 43444, 43454, 43464, 43474, 43484, 43493,
+	43503, 43513, 43523, 43533, 43543, 43553, 43563, 43573, 43583, 43593, 43603, 43612,
+	43622, 43632, 43642, 43652, 43662, 43672, 43682, 43692, 43701, 43711, 43721, 43731,
+	43741, 43751, 43761, 43771, 43780, 43790, 43800, 43810, 43820, 43830, 43840, 43849,
+	43859, 43869, 43879, 43889, 43899, 43908, 43918, 43928, 43938, 43948, 43958, 43967,
+	43977, 43987, 43997, 44007, 44016, 44026, 44036, 44046, 44056, 44065, 44075, 44085,
+	44095, 44105, 44114, 44124, 44134, 44144, 44153, 44163, 44173, 44183, 44192, 44202,
+	44212, 44222, 44232, 44241, 44251, 44261, 44271, 44280, 44290, 44300, 44309, 44319,
+	44329, 44339, 44348, 44358, 44368, 44378, 44387, 44397, 44407, 44416, 44426, 44436,
+	44446, 44455, 44465, 44475, 44484, 44494, 44504, 44513, 44523, 44533, 44542, 44552,
+	44562, 44571, 44581, 44591, 44600, 44610, 44620, 44629, 44639, 44649, 44658, 44668,
+	44678, 44687, 44697, 44707, 44716, 44726, 44736, 44745, 44755, 44764, 44774, 44784,
+	44793, 44803, 44813, 44822, 44832, 44841, 44851, 44861, 44870, 44880, 44889, 44899,
+	44909, 44918, 44928, 44937, 44947, 44957, 44966, 44976, 44985, 44995, 45004, 45014,
+	45024, 45033, 45043, 45052, 45062, 45071, 45081, 45090, 45100, 45110, 45119, 45129,
+	45138, 45148, 45157, 45167, 45176, 45186, 45195, 45205, 45214, 45224, 45233, 45243,
+	45252, 45262, 45271, 45281, 45290, 45300, 45309, 45319, 45328, 45338, 45347, 45357,
+	45366, 45376, 45385, 45395, 45404, 45414, 45423, 45433, 45442, 45452, 45461, 45471,
+	45480, 45489, 45499, 45508, 45518, 45527, 45537, 45546, 45556, 45565, 45574, 45584,
+	45593, 45603, 45612, 45622, 45631, 45640, 45650, 45659, 45669, 45678, 45687, 45697,
+	45706, 45716, 45725, 45734, 45744, 45753, 45763, 45772, 45781, 45791, 45800, 45810,
+	45819, 45828, 45838, 45847, 45856, 45866, 45875, 45884, 45894, 45903, 45912, 45922,
+	45931, 45941, 45950, 45959, 45969, 45978, 45987, 45997, 46006, 46015, 46025, 46034,
+	46043, 46053, 46062, 46071, 46080, 46090, 46099, 46108, 46118, 46127, 46136, 46146,
+	46155, 46164, 46173, 46183, 46192, 46201, 46211, 46220, 46229, 46238, 46248, 46257,
+	46266, 46275, 46285, 46294, 46303, 46313, 46322, 46331, 46340, 46350, 46359, 46368,
+	46377, 46386, 46396, 46405, 46414, 46423, 46433, 46442, 46451, 46460, 46470, 46479,
+	46488, 46497, 46506, 46516, 46525, 46534, 46543, 46552, 46562, 46571, 46580, 46589,
+	46598, 46608, 46617, 46626, 46635, 46644, 46653, 46663, 46672, 46681, 46690, 46699,
+	46708, 46718, 46727, 46736, 46745, 46754, 46763, 46772, 46782, 46791, 46800, 46809,
+	46818, 46827, 46836, 46846, 46855, 46864, 46873, 46882, 46891, 46900, 46909, 46918,
+	46928, 46937, 46946, 46955, 46964, 46973, 46982, 46991, 47000, 47009, 47019, 47028,
+	47037, 47046, 47055, 47064, 47073, 47082, 47091, 47100, 47109, 47118, 47127, 47136,
+	47145, 47155, 47164, 47173, 47182, 47191, 47200, 47209, 47218, 47227, 47236, 47245,
+	47254, 47263, 47272, 47281, 47290, 47299, 47308, 47317, 47326, 47335, 47344, 47353,
+	47362, 47371, 47380, 47389, 47398, 47407, 47416, 47425, 47434, 47443, 47452, 47461,
+	47470, 47479, 47488, 47497, 47506, 47515, 47524, 47533, 47542, 47551, 47560, 47569,
+	47578, 47586, 47595, 47604, 47613, 47622, 47631, 47640, 47649, 47658, 47667, 47676,
+	47685, 47694, 47703, 47711, 47720, 47729, 47738, 47747, 47756, 47765, 47774, 47783,
+	47792, 47801, 47809, 47818, 47827, 47836, 47845, 47854, 47863, 47872, 47881, 47889,
+	47898, 47907, 47916, 47925, 47934, 47943, 47951, 47960, 47969, 47978, 47987, 47996,
+	48005, 48013, 48022, 48031, 48040, 48049, 48058, 48066, 48075, 48084, 48093, 48102,
+	48111, 48119, 48128, 48137, 48146, 48155, 48163, 48172, 48181, 48190, 48199, 48207,
+	48216, 48225, 48234, 48243, 48251, 48260, 48269, 48278, 48286, 48295, 48304, 48313,
+	48322, 48330, 48339, 48348, 48357, 48365, 48374, 48383, 48392, 48400, 48409, 48418,
+	48427, 48435, 48444, 48453, 48462, 48470, 48479, 48488, 48497, 48505, 48514, 48523,
+	48531, 48540, 48549, 48558, 48566, 48575, 48584, 48592, 48601, 48610, 48618, 48627,
+	48636, 48645, 48653, 48662, 48671, 48679, 48688, 48697, 48705, 48714, 48723, 48731,
+	48740, 48749, 48757, 48766, 48775, 48783, 48792, 48801, 48809, 48818, 48827, 48835,
+	48844, 48852, 48861, 48870, 48878, 48887, 48896, 48904, 48913, 48922, 48930, 48939,
+	48947, 48956, 48965, 48973, 48982, 48990, 48999, 49008, 49016, 49025, 49033, 49042,
+	49051, 49059, 49068, 49076, 49085, 49094, 49102, 49111, 49119, 49128, 49136, 49145,
+	49154, 49162, 49171, 49179, 49188, 49196, 49205, 49213, 49222, 49231, 49239, 49248,
+	49256, 49265, 49273, 49282, 49290, 49299, 49307, 49316, 49324, 49333, 49341, 49350,
+	49359, 49367, 49376, 49384, 49393, 49401, 49410, 49418, 49427, 49435, 49444, 49452,
+	49461, 49469, 49478, 49486, 49495, 49503, 49511, 49520, 49528, 49537, 49545, 49554,
+	49562, 49571, 49579, 49588, 49596, 49605, 49613, 49622, 49630, 49638, 49647, 49655,
+	49664, 49672, 49681, 49689, 49697, 49706, 49714, 49723, 49731, 49740, 49748, 49756,
+	49765, 49773, 49782, 49790, 49799, 49807, 49815, 49824, 49832, 49841, 49849, 49857,
+	49866, 49874, 49883, 49891, 49899, 49908, 49916, 49924, 49933, 49941, 49950, 49958,
+	49966, 49975, 49983, 49991, 50000, 50008, 50016, 50025, 50033, 50042, 50050, 50058,
+	50067, 50075, 50083, 50092, 50100, 50108, 50117, 50125, 50133, 50142, 50150, 50158,
+	50167, 50175, 50183, 50191, 50200, 50208, 50216, 50225, 50233, 50241, 50250, 50258,
+	50266, 50274, 50283, 50291, 50299, 50308, 50316, 50324, 50332, 50341, 50349, 50357,
+	50366, 50374, 50382, 50390, 50399, 50407, 50415, 50423, 50432, 50440, 50448, 50456,
+	50465, 50473, 50481, 50489, 50498, 50506, 50514, 50522, 50531, 50539, 50547, 50555,
+	50563, 50572, 50580, 50588, 50596, 50605, 50613, 50621, 50629, 50637, 50646, 50654,
+	50662, 50670, 50678, 50687, 50695, 50703, 50711, 50719, 50728, 50736, 50744, 50752,
+	50760, 50768, 50777, 50785, 50793, 50801, 50809, 50817, 50826, 50834, 50842, 50850,
+	50858, 50866, 50874, 50883, 50891, 50899, 50907, 50915, 50923, 50931, 50940, 50948,
+	50956, 50964, 50972, 50980, 50988, 50996, 51005, 51013, 51021, 51029, 51037, 51045,
+	51053, 51061, 51069, 51077, 51086, 51094, 51102, 51110, 51118, 51126, 51134, 51142,
+	51150, 51158, 51166, 51175, 51183, 51191, 51199, 51207, 51215, 51223, 51231, 51239,
+	51247, 51255, 51263, 51271, 51279, 51287, 51295, 51303, 51311, 51320, 51328, 51336,
+	51344, 51352, 51360, 51368, 51376, 51384, 51392, 51400, 51408, 51416, 51424, 51432,
+	51440, 51448, 51456, 51464, 51472
+};
+
+// 2^60 divided by the length of the even quadrants (102943) and the odd ones
+// (102944), which scales an angle within a quadrant to the range of the table.
+static const int64_t sg_quadrant_reciprocals[2] = {
+	(INT64_C(1) << 60) / 102943,
+	(INT64_C(1) << 60) / 102944,
+};
+
+// Looks up p_t (which is from 0 to 1, with 28 fractional bits) in one of the
+// tables above, interpolating linearly between its entries.
+static _FORCE_INLINE_ int64_t sg_trig_table_lookup(const int32_t *p_table, int64_t p_t) {
+	int64_t index = p_t >> 16;
+	if (index >= 4096) {
+		return p_table[4096];
+	}
+	int64_t frac = p_t & 0xFFFF;
+	return p_table[index] + (((p_table[index + 1] - p_table[index]) * frac + 0x8000) >> 16);
+}
+
+void fixed::sincos(fixed &r_sin, fixed &r_cos) const {
+	// Most angles are within one turn, so avoid dividing when we can.
+	int64_t x = value;
+	if (x < 0) {
+		x += fixed::TAU.value;
+	}
+	if (x < 0 || x >= fixed::TAU.value) {
+		x = value % fixed::TAU.value;
+		if (x < 0) {
+			x += fixed::TAU.value;
+		}
+	}
+
+	// The quadrants start exactly on the constants, so that angles like
+	// fixed::PI_DIV_2 give exact results, even though their lengths differ
+	// by one. This avoids branching, since the quadrant is hard to predict.
+	const int64_t starts[4] = { 0, fixed::PI_DIV_2.value, fixed::PI.value, fixed::PI.value + fixed::PI_DIV_2.value };
+	int quadrant = (x >= starts[1]) + (x >= starts[2]) + (x >= starts[3]);
+
+	// Multiplying by the reciprocal is much cheaper than dividing.
+	int64_t t = ((x - starts[quadrant]) * sg_quadrant_reciprocals[quadrant & 1]) >> 32;
+	int64_t rising = sg_trig_table_lookup(sg_sin_table, t);
+	int64_t falling = sg_trig_table_lookup(sg_sin_table, (INT64_C(1) << 28) - t);
+
+	int64_t s = (quadrant & 1) ? falling : rising;
+	int64_t c = (quadrant & 1) ? -rising : falling;
+	if (quadrant & 2) {
+		s = -s;
+		c = -c;
+	}
+	r_sin = fixed(s);
+	r_cos = fixed(c);
+}
+
+fixed fixed::sin() const {
+	fixed s, c;
+	sincos(s, c);
+	return s;
+}
+
+fixed fixed::cos() const {
+	fixed s, c;
+	sincos(s, c);
+	return c;
+}
+
+#else
+
 // Adapted from the fpm library: https://github.com/MikeLankamp/fpm
 // Copyright 2019 Mike Lankamp
 // License: MIT
@@ -112,6 +1014,13 @@ fixed fixed::cos() const {
 	return (*this + fixed::PI_DIV_2).sin();
 }
 
+void fixed::sincos(fixed &r_sin, fixed &r_cos) const {
+	r_sin = sin();
+	r_cos = cos();
+}
+
+#endif
+
 fixed fixed::tan() const {
 	fixed cx = cos();
 	ERR_FAIL_COND_V_MSG(cx == fixed::ZERO, fixed::ZERO, "tan() of 90 degree angles is undefined");
@@ -150,6 +1059,14 @@ fixed fixed::acos() const {
 	return fixed::TWO * atan_div(yy.sqrt(), fixed::ONE + *this);
 }
 
+#ifdef SG_FIXED_TRIG_TABLES
+
+fixed fixed::atan() const {
+	return atan_div(*this, fixed::ONE);
+}
+
+#else
+
 // Adapted from the fpm library: https://github.com/MikeLankamp/fpm
 // Copyright 2019 Mike Lankamp
 // License: MIT
@@ -165,6 +1082,8 @@ fixed fixed::atan() const {
 	return atan_sanitized(*this);
 }
 
+#endif
+
 // Adapted from the fpm library: https://github.com/MikeLankamp/fpm
 // Copyright 2019 Mike Lankamp
 // License: MIT
@@ -198,6 +1117,37 @@ fixed fixed::atan_sanitized(const fixed &p_x) {
 	return ((a * xx + b) * xx + c) * p_x;
 }
 
+#ifdef SG_FIXED_TRIG_TABLES
+
+fixed fixed::atan_div(const fixed &p_y, const fixed &p_x) {
+	ERR_FAIL_COND_V(p_x == fixed::ZERO, fixed::ZERO);
+
+	uint64_t y = p_y.value < 0 ? (uint64_t)0 - (uint64_t)p_y.value : (uint64_t)p_y.value;
+	uint64_t x = p_x.value < 0 ? (uint64_t)0 - (uint64_t)p_x.value : (uint64_t)p_x.value;
+
+	// Look up the smaller over the larger, which is from 0 to 1.
+	bool steep = y > x;
+	uint64_t num = steep ? x : y;
+	uint64_t den = steep ? y : x;
+
+	// The ratio only needs 28 bits, so drop low bits until the numerator
+	// can be shifted up without overflowing.
+	if (den >= (UINT64_C(1) << 35)) {
+		int shift = sg_highest_bit_64(den) - 34;
+		num >>= shift;
+		den >>= shift;
+	}
+
+	int64_t angle = sg_trig_table_lookup(sg_atan_table, (int64_t)((num << 28) / den));
+	if (steep) {
+		angle = fixed::PI_DIV_2.value - angle;
+	}
+
+	return ((p_y.value < 0) != (p_x.value < 0)) ? fixed(-angle) : fixed(angle);
+}
+
+#else
+
 // Adapted from the fpm library: https://github.com/MikeLankamp/fpm
 // Copyright 2019 Mike Lankamp
 // License: MIT
@@ -220,6 +1170,8 @@ fixed fixed::atan_div(const fixed &p_y, const fixed &p_x) {
 	return atan_sanitized(p_y / p_x);
 }
 
+#endif
+
 // Adapted from libfixmath: https://github.com/PetteriAimonen/libfixmath
 // Copyright 2011-2021 Flatmush <Flatmush@gmail.com>
 // License: MIT
@@ -264,7 +1216,13 @@ fixed fixed::log() const {
 }
 
 fixed fixed::div_rounded(const fixed &p_other) const {
-	int64_t temp = (value << 17) / p_other.value;
+	int64_t temp;
+	if (value > -(INT64_C(1) << 46) && value < (INT64_C(1) << 46)) {
+		temp = (value << 17) / p_other.value;
+	}
+	else {
+		temp = sg_div_128_64(value >> 47, (uint64_t)value << 17, p_other.value);
+	}
 	return fixed((temp / 2) + (temp % 2));
 }
 
@@ -24,7 +24,9 @@
 #ifndef SG_FIXED_NUMBER_INTERNAL_H
 #define SG_FIXED_NUMBER_INTERNAL_H
 
-#ifdef USE_GDEXTENSION
+#if defined(SG_BENCHMARK)
+#include "../benchmark/sg_benchmark_error_macros.h"
+#elif defined(USE_GDEXTENSION)
 #include <godot_cpp/core/error_macros.hpp>
 #else
 #include <core/error_macros.h>
@@ -42,8 +44,46 @@
 #define CLAMP(m_a, m_min, m_max) (((m_a) < (m_min)) ? (m_min) : (((m_a) > (m_max)) ? m_max : m_a))
 #endif
 
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 int64_t sg_sqrt_64(int64_t num);
 
+// Multiplies two 64-bit numbers into a 128-bit number, given as its high and
+// low halves.
+static _FORCE_INLINE_ void sg_mul_64_128(int64_t p_a, int64_t p_b, int64_t &r_high, uint64_t &r_low) {
+#if defined(__SIZEOF_INT128__)
+	__int128 product = (__int128)p_a * p_b;
+	r_high = (int64_t)(product >> 64);
+	r_low = (uint64_t)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	r_low = (uint64_t)_mul128(p_a, p_b, &r_high);
+#else
+	uint64_t a = (uint64_t)p_a;
+	uint64_t b = (uint64_t)p_b;
+	uint64_t low_low = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+	uint64_t high_low = (a >> 32) * (b & 0xFFFFFFFF);
+	uint64_t low_high = (a & 0xFFFFFFFF) * (b >> 32);
+	uint64_t cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+	uint64_t high = (a >> 32) * (b >> 32) + (high_low >> 32) + (cross >> 32);
+	// The unsigned product is too big by b * 2^64 when a is negative, and
+	// a * 2^64 when b is negative.
+	if (p_a < 0) {
+		high -= b;
+	}
+	if (p_b < 0) {
+		high -= a;
+	}
+	r_high = (int64_t)high;
+	r_low = (cross << 32) | (low_low & 0xFFFFFFFF);
+#endif
+}
+
+// Divides a 128-bit number, given as its high and low halves, by a 64-bit
+// number, rounding towards zero. The result must fit in 64 bits.
+int64_t sg_div_128_64(int64_t p_high, uint64_t p_low, int64_t p_divisor);
+
 // To avoid overflow related to flipping the sign on twos-complement
 // representation of of the minimum integer, we effectively limit values to
 // 1 above the minimum.
@@ -53,6 +93,11 @@ int64_t sg_sqrt_64(int64_t num);
 #define SG_FIXED_MATH_CHECKS
 #endif
 
+// Defining SG_FIXED_TRIG_TABLES (via `scons sg_trig_tables=yes`) switches sin(),
+// cos() and the arc tangents from polynomial approximations to interpolated
+// lookup tables, which are faster and more precise. Both are deterministic,
+// but they give different results, so every peer in a game must use the same.
+
 #define FIXED_SGN(m_v) (((m_v) < fixed::ZERO) ? fixed::NEG_ONE : fixed::ONE)
 
 struct fixed {
@@ -164,18 +209,18 @@ struct fixed {
 	}
 
 	_FORCE_INLINE_ fixed operator*(const fixed& p_other) const {
+		int64_t high;
+		uint64_t low;
+		sg_mul_64_128(value, p_other.value, high, low);
+		int64_t result = (int64_t)((low >> 16) | ((uint64_t)high << 48));
+
 		#ifdef SG_FIXED_MATH_CHECKS
-		ERR_FAIL_COND_V_MSG(value == -1 && p_other.value == INT64_MAX,
-			fixed::ARITHMETIC_OVERFLOW, "Fixed-point multiplication overflow");
-		ERR_FAIL_COND_V_MSG(p_other.value == -1 && value == INT64_MIN,
-			fixed::ARITHMETIC_OVERFLOW, "Fixed-point multiplication overflow");
-		ERR_FAIL_COND_V_MSG(p_other.value > 0 && (value > (INT64_MAX / p_other.value) || value < (INT64_EFFECTIVE_MIN / p_other.value)),
-			fixed::ARITHMETIC_OVERFLOW, "Fixed-point multiplication overflow");
-		ERR_FAIL_COND_V_MSG(p_other.value < 0 && (value < (INT64_MAX / p_other.value) || value > (INT64_EFFECTIVE_MIN / p_other.value)),
+		// Every bit above the result has to match its sign bit.
+		ERR_FAIL_COND_V_MSG((high >> 15) != (result >> 63),
 			fixed::ARITHMETIC_OVERFLOW, "Fixed-point multiplication overflow");
 		#endif
 
-		return fixed((value * p_other.value) >> 16);
+		return fixed(result);
 	}
 
 	_FORCE_INLINE_ fixed& operator*=(const fixed& p_other) {
@@ -185,15 +230,16 @@ struct fixed {
 
 	_FORCE_INLINE_ fixed operator/(const fixed& p_other) const {
 		#ifdef SG_FIXED_MATH_CHECKS
-		ERR_FAIL_COND_V_MSG(value == -1 && p_other.value == INT64_MAX,
-			fixed::ARITHMETIC_OVERFLOW, "Fixed-point division overflow");
-		ERR_FAIL_COND_V_MSG(p_other.value == -1 && value == INT64_MIN,
-			fixed::ARITHMETIC_OVERFLOW, "Fixed-point division overflow");
 		ERR_FAIL_COND_V_MSG(p_other.value == 0,
 			fixed::ARITHMETIC_OVERFLOW, "Fixed-point division by zero");
 		#endif
 
-		return fixed((value << 16) / p_other.value);
+		// Most values can be shifted without overflowing, which is much faster
+		// than dividing a 128-bit number.
+		if (value > -(INT64_C(1) << 47) && value < (INT64_C(1) << 47)) {
+			return fixed((value << 16) / p_other.value);
+		}
+		return fixed(sg_div_128_64(value >> 48, (uint64_t)value << 16, p_other.value));
 	}
 
 	_FORCE_INLINE_ fixed& operator/=(const fixed& p_other) {
@@ -233,6 +279,9 @@ struct fixed {
 	fixed pow_integer(const fixed &exp) const;
 	fixed  sin() const;
 	fixed  cos() const;
+	// Calculates both sin() and cos(), which is cheaper than calling them
+	// separately when using the lookup tables.
+	void sincos(fixed &r_sin, fixed &r_cos) const;
 	fixed  tan() const;
 	fixed asin() const;
 	fixed acos() const;
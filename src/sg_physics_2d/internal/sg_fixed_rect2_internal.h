@@ -67,6 +67,12 @@ struct SGFixedRect2Internal {
 			(min_two.y <= max_one.y) && (min_one.y <= max_two.y);
 	}
 
+	inline bool encloses(const SGFixedRect2Internal &p_other) const {
+		return (p_other.position.x >= position.x) && (p_other.position.y >= position.y) && \
+			((p_other.position.x + p_other.size.x) <= (position.x + size.x)) && \
+			((p_other.position.y + p_other.size.y) <= (position.y + size.y));
+	}
+
 	inline SGFixedRect2Internal merge(const SGFixedRect2Internal &p_rect) const {
 		SGFixedRect2Internal new_rect;
 
@@ -115,8 +115,7 @@ struct SGFixedVector2Internal {
 	fixed angle() const;
 
 	void set_rotation(fixed p_radians) {
-		x = p_radians.cos();
-		y = p_radians.sin();
+		p_radians.sincos(y, x);
 	}
 
 	_FORCE_INLINE_ SGFixedVector2Internal abs() const {
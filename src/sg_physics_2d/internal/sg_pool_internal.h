@@ -0,0 +1,114 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SG_POOL_INTERNAL_H
+#define SG_POOL_INTERNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Hands out blocks of one size, carved out of large chunks, and keeps freed
+// blocks for reuse. Each pooled class has its own, so objects of the same
+// type end up packed together in memory instead of scattered across the
+// heap, which matters when the world loops over thousands of them.
+//
+// Like the rest of the internal layer, it isn't thread-safe.
+class SGPoolAllocatorInternal {
+	static const std::size_t BLOCKS_PER_CHUNK = 64;
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	// The size of the pooled class, and that rounded up to keep the blocks
+	// aligned as well as operator new would.
+	std::size_t object_size;
+	std::size_t block_size;
+	std::vector<void *> chunks;
+	FreeBlock *free_list;
+
+	void _add_chunk() {
+		char *chunk = (char *)::operator new(block_size * BLOCKS_PER_CHUNK);
+		chunks.push_back(chunk);
+
+		// Thread the new blocks onto the free list in address order, so
+		// they're handed out front to back.
+		for (std::size_t i = BLOCKS_PER_CHUNK; i > 0; i--) {
+			FreeBlock *block = (FreeBlock *)(chunk + (i - 1) * block_size);
+			block->next = free_list;
+			free_list = block;
+		}
+	}
+
+public:
+	void *allocate(std::size_t p_size) {
+		// Subclasses without a pool of their own end up here too.
+		if (p_size != object_size) {
+			return ::operator new(p_size);
+		}
+		if (free_list == nullptr) {
+			_add_chunk();
+		}
+		FreeBlock *block = free_list;
+		free_list = block->next;
+		return block;
+	}
+
+	void free(void *p_ptr, std::size_t p_size) {
+		if (p_size != object_size) {
+			::operator delete(p_ptr);
+			return;
+		}
+		FreeBlock *block = (FreeBlock *)p_ptr;
+		block->next = free_list;
+		free_list = block;
+	}
+
+	SGPoolAllocatorInternal(std::size_t p_object_size) {
+		const std::size_t alignment = alignof(std::max_align_t);
+		object_size = p_object_size;
+		block_size = (p_object_size + alignment - 1) & ~(alignment - 1);
+		free_list = nullptr;
+	}
+};
+
+// Makes the class allocate its instances from a pool of its own. The pool is
+// never destroyed, since objects can still be freed while static variables
+// are being destroyed at exit.
+#define SG_POOL_ALLOCATED(m_class)                                              \
+public:                                                                         \
+	static SGPoolAllocatorInternal &get_pool() {                                \
+		static SGPoolAllocatorInternal *pool = new SGPoolAllocatorInternal(sizeof(m_class)); \
+		return *pool;                                                           \
+	}                                                                           \
+	static void *operator new(std::size_t p_size) {                             \
+		return get_pool().allocate(p_size);                                     \
+	}                                                                           \
+	static void operator delete(void *p_ptr, std::size_t p_size) {              \
+		get_pool().free(p_ptr, p_size);                                         \
+	}
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef SG_RESULT_HANDLER_INTERNAL_H
 #define SG_RESULT_HANDLER_INTERNAL_H
 
+#include "sg_fixed_vector2_internal.h"
+
 class SGCollisionObject2DInternal;
 class SGShape2DInternal;
 
@@ -34,4 +36,14 @@ public:
 
 };
 
+// For queries along a ray, which can stop early once nothing left could be
+// closer than what's been hit already.
+class SGRayResultHandlerInternal : public SGResultHandlerInternal {
+public:
+
+	// Returns false if nothing has been hit yet.
+	virtual bool get_closest_hit(SGFixedVector2Internal &r_point) const = 0;
+
+};
+
 #endif
@@ -23,7 +23,24 @@
 
 #include "sg_shapes_2d_internal.h"
 
+#include <algorithm>
+
 #include "sg_bodies_2d_internal.h"
+#include "sg_result_handler_internal.h"
+#include "sg_utils_internal.h"
+
+// Enough for a hierarchy over 2^30 parts.
+#define SG_POLYGON_PART_STACK_SIZE 64
+#define SG_POLYGON_PARTS_PER_LEAF 2
+
+void SGShape2DInternal::notify_owner() {
+	global_vertices_dirty = true;
+	global_axes_dirty = true;
+	global_bounds_dirty = true;
+	if (owner) {
+		owner->shape_changed(this);
+	}
+}
 
 SGFixedTransform2DInternal SGShape2DInternal::get_global_transform() const {
 	if (!owner) {
@@ -36,16 +53,23 @@ SGFixedTransform2DInternal SGShape2DInternal::get_global_transform() const {
 	return global_transform;
 }
 
-std::vector<SGFixedVector2Internal> SGShape2DInternal::get_global_vertices() const {
+const std::vector<SGFixedVector2Internal> &SGShape2DInternal::get_global_vertices() const {
 	return global_vertices;
 }
 
-std::vector<SGFixedVector2Internal> SGShape2DInternal::get_global_axes() const {
+const std::vector<SGFixedVector2Internal> &SGShape2DInternal::get_global_axes() const {
 	return global_axes;
 }
 
-SGFixedRect2Internal SGShape2DInternal::get_bounds() const {
-	std::vector<SGFixedVector2Internal> points = get_global_vertices();
+void SGShape2DInternal::update_global_cache() const {
+	get_global_transform();
+	get_global_vertices();
+	get_global_axes();
+	get_bounds();
+}
+
+SGFixedRect2Internal SGShape2DInternal::compute_bounds() const {
+	const std::vector<SGFixedVector2Internal> &points = get_global_vertices();
 	if (points.size() == 0) {
 		return SGFixedRect2Internal(global_transform.get_origin(), SGFixedVector2Internal());
 	}
@@ -58,7 +82,22 @@ SGFixedRect2Internal SGShape2DInternal::get_bounds() const {
 	return bounds;
 }
 
-std::vector<SGFixedVector2Internal> SGRectangle2DInternal::get_global_vertices() const {
+uint64_t SGShape2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = sg_hash_combine(p_hash, shape_type);
+	for (int i = 0; i < 3; i++) {
+		p_hash = sg_hash_combine(p_hash, transform.elements[i].x.value);
+		p_hash = sg_hash_combine(p_hash, transform.elements[i].y.value);
+	}
+	return p_hash;
+}
+
+uint64_t SGRectangle2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = SGShape2DInternal::hash_state(p_hash);
+	p_hash = sg_hash_combine(p_hash, extents.x.value);
+	return sg_hash_combine(p_hash, extents.y.value);
+}
+
+const std::vector<SGFixedVector2Internal> &SGRectangle2DInternal::get_global_vertices() const {
 	if (global_vertices_dirty) {
 		SGFixedTransform2DInternal t = get_global_transform();
 		global_vertices[0] = t.xform(SGFixedVector2Internal(-extents.x, -extents.y));
@@ -71,7 +110,7 @@ std::vector<SGFixedVector2Internal> SGRectangle2DInternal::get_global_vertices()
 	return global_vertices;
 }
 
-std::vector<SGFixedVector2Internal> SGRectangle2DInternal::get_global_axes() const {
+const std::vector<SGFixedVector2Internal> &SGRectangle2DInternal::get_global_axes() const {
 	if (global_axes_dirty) {
 		SGFixedTransform2DInternal t = get_global_transform();
 		t.set_origin(SGFixedVector2Internal::ZERO);
@@ -95,7 +134,17 @@ SGFixedVector2Internal SGRectangle2DInternal::get_closest_vertex(const SGFixedVe
 	return t.xform(vertex);
 }
 
-std::vector<SGFixedVector2Internal> SGPolygon2DInternal::get_global_vertices() const {
+uint64_t SGPolygon2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = SGShape2DInternal::hash_state(p_hash);
+	p_hash = sg_hash_combine(p_hash, points.size());
+	for (const SGFixedVector2Internal &point : points) {
+		p_hash = sg_hash_combine(p_hash, point.x.value);
+		p_hash = sg_hash_combine(p_hash, point.y.value);
+	}
+	return p_hash;
+}
+
+const std::vector<SGFixedVector2Internal> &SGPolygon2DInternal::get_global_vertices() const {
 	if (global_vertices_dirty) {
 		SGFixedTransform2DInternal t = get_global_transform();
 
@@ -111,7 +160,7 @@ std::vector<SGFixedVector2Internal> SGPolygon2DInternal::get_global_vertices() c
 	return global_vertices;
 }
 
-std::vector<SGFixedVector2Internal> SGPolygon2DInternal::get_global_axes() const {
+const std::vector<SGFixedVector2Internal> &SGPolygon2DInternal::get_global_axes() const {
 	if (global_axes_dirty) {
 		SGFixedTransform2DInternal t = get_global_transform();
 		t.set_origin(SGFixedVector2Internal::ZERO);
@@ -131,14 +180,446 @@ std::vector<SGFixedVector2Internal> SGPolygon2DInternal::get_global_axes() const
 	return global_axes;
 }
 
-SGFixedRect2Internal SGCircle2DInternal::get_bounds() const {
+void SGPolygon2DInternal::update_global_cache() const {
+	SGShape2DInternal::update_global_cache();
+	for (const SGPolygon2DInternal *part : get_parts()) {
+		part->update_global_cache();
+	}
+}
+
+void SGPolygon2DInternal::set_points(const std::vector<SGFixedVector2Internal> &p_points) {
+	points = p_points;
+	global_vertices.clear();
+	global_axes.clear();
+
+	clear_parts();
+	concave = points.size() > 3 && !is_convex(points);
+	if (concave) {
+		// If it can't be split, it's left without any parts, and so doesn't
+		// collide with anything, like polygons with less than 3 points.
+		std::vector<std::vector<SGFixedVector2Internal>> part_points;
+		if (decompose(points, part_points)) {
+			std::vector<SGFixedRect2Internal> part_bounds;
+			for (const std::vector<SGFixedVector2Internal> &part_point_list : part_points) {
+				SGPolygon2DInternal *part = new SGPolygon2DInternal();
+				part->points = part_point_list;
+				parts.push_back(part);
+
+				SGFixedRect2Internal bounds(part_point_list[0], SGFixedVector2Internal());
+				for (std::size_t i = 1; i < part_point_list.size(); i++) {
+					bounds.expand_to(part_point_list[i]);
+				}
+				part_bounds.push_back(bounds);
+				part_order.push_back(part_order.size());
+			}
+			build_part_nodes(part_bounds, 0, parts.size());
+		}
+	}
+
+	notify_owner();
+}
+
+void SGPolygon2DInternal::clear_parts() {
+	for (SGPolygon2DInternal *part : parts) {
+		delete part;
+	}
+	parts.clear();
+	part_order.clear();
+	part_nodes.clear();
+	parts_dirty = true;
+}
+
+int SGPolygon2DInternal::build_part_nodes(const std::vector<SGFixedRect2Internal> &p_part_bounds, int p_first, int p_count) {
+	int index = part_nodes.size();
+	part_nodes.push_back(PartNode());
+
+	SGFixedRect2Internal bounds = p_part_bounds[part_order[p_first]];
+	for (int i = 1; i < p_count; i++) {
+		bounds = bounds.merge(p_part_bounds[part_order[p_first + i]]);
+	}
+	part_nodes[index].bounds = bounds;
+
+	if (p_count <= SG_POLYGON_PARTS_PER_LEAF) {
+		part_nodes[index].first = p_first;
+		part_nodes[index].count = p_count;
+		return index;
+	}
+
+	// Split the parts in half, by their centers along the longest axis. Ties
+	// are broken by index, so the result doesn't depend on the sort.
+	int axis = bounds.size.x >= bounds.size.y ? 0 : 1;
+	std::sort(part_order.begin() + p_first, part_order.begin() + p_first + p_count, [&](int a, int b) {
+		fixed center_a = p_part_bounds[a].position[axis] * fixed::TWO + p_part_bounds[a].size[axis];
+		fixed center_b = p_part_bounds[b].position[axis] * fixed::TWO + p_part_bounds[b].size[axis];
+		return center_a < center_b || (center_a == center_b && a < b);
+	});
+
+	int half = p_count / 2;
+	build_part_nodes(p_part_bounds, p_first, half);
+	int second = build_part_nodes(p_part_bounds, p_first + half, p_count - half);
+	part_nodes[index].first = second;
+	part_nodes[index].count = 0;
+	return index;
+}
+
+void SGPolygon2DInternal::update_parts() const {
+	if (parts.size() == 0) {
+		return;
+	}
+	SGFixedTransform2DInternal t = get_global_transform();
+	if (parts_dirty || !(parts_transform == t)) {
+		for (SGPolygon2DInternal *part : parts) {
+			part->set_transform(t);
+		}
+		parts_transform = t;
+		parts_dirty = false;
+	}
+}
+
+void SGPolygon2DInternal::find_parts(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler) const {
+	if (part_nodes.size() == 0) {
+		return;
+	}
+	update_parts();
+
+	int stack[SG_POLYGON_PART_STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		int index = stack[--stack_size];
+		const PartNode &node = part_nodes[index];
+
+		// Move the node's bounds into global space, with the same transform
+		// as the parts' vertices, and then grow them a tiny bit to cover
+		// any difference in rounding.
+		SGFixedVector2Internal corners[4] = {
+			parts_transform.xform(node.bounds.position),
+			parts_transform.xform(SGFixedVector2Internal(node.bounds.position.x + node.bounds.size.x, node.bounds.position.y)),
+			parts_transform.xform(SGFixedVector2Internal(node.bounds.position.x, node.bounds.position.y + node.bounds.size.y)),
+			parts_transform.xform(node.bounds.position + node.bounds.size),
+		};
+		SGFixedRect2Internal bounds(corners[0], SGFixedVector2Internal());
+		for (int i = 1; i < 4; i++) {
+			bounds.expand_to(corners[i]);
+		}
+		bounds.grow_by(fixed(4));
+		if (!bounds.intersects(p_bounds)) {
+			continue;
+		}
+
+		if (node.count > 0) {
+			for (int i = 0; i < node.count; i++) {
+				p_result_handler->handle_result(owner, parts[part_order[node.first + i]]);
+			}
+		}
+		else {
+			stack[stack_size++] = node.first;
+			stack[stack_size++] = index + 1;
+		}
+	}
+}
+
+SGPolygon2DInternal::~SGPolygon2DInternal() {
+	clear_parts();
+}
+
+// Algorithm from https://math.stackexchange.com/a/1745427/969278
+//
+// License: CC BY-SA 3.0
+// Author: Nominal Animal
+//
+bool SGPolygon2DInternal::is_convex(const std::vector<SGFixedVector2Internal> &p_points) {
+	if (p_points.size() < 3) {
+		return false;
+	}
+
+	fixed w_sign = fixed::ZERO;
+
+	int x_sign = 0;
+	int x_first_sign = 0;
+	int x_flips = 0;
+
+	int y_sign = 0;
+	int y_first_sign = 0;
+	int y_flips = 0;
+
+	SGFixedVector2Internal prev;
+	SGFixedVector2Internal cur = p_points[p_points.size() - 2];
+	SGFixedVector2Internal next = p_points[p_points.size() - 1];
+
+	for (std::size_t i = 0; i < p_points.size(); i++) {
+		prev = cur;
+		cur = next;
+		next = p_points[i];
+
+		SGFixedVector2Internal previous_edge = cur - prev;
+		SGFixedVector2Internal next_edge = next - cur;
+
+		if (next_edge.x > fixed::ZERO) {
+			if (x_sign == 0) {
+				x_first_sign = +1;
+			}
+			else if (x_sign < 0) {
+				x_flips++;
+			}
+			x_sign = +1;
+		}
+		else if (next_edge.x < fixed::ZERO) {
+			if (x_sign == 0) {
+				x_first_sign = -1;
+			}
+			else if (x_sign > 0) {
+				x_flips++;
+			}
+			x_sign = -1;
+		}
+
+		if (x_flips > 2) {
+			return false;
+		}
+
+		if (next_edge.y > fixed::ZERO) {
+			if (y_sign == 0) {
+				y_first_sign = +1;
+			}
+			else if (y_sign < 0) {
+				y_flips++;
+			}
+			y_sign = +1;
+		}
+		else if (next_edge.y < fixed::ZERO) {
+			if (y_sign == 0) {
+				y_first_sign = -1;
+			}
+			else if (y_sign > 0) {
+				y_flips++;
+			}
+			y_sign = -1;
+		}
+
+		if (y_flips > 2) {
+			return false;
+		}
+
+		// Find out the orientation of this pair of edges and ensure it doesn't
+		// differ from previous ones.
+		fixed w = previous_edge.x * next_edge.y - next_edge.x * previous_edge.y;
+		if (w_sign == fixed::ZERO && w != fixed::ZERO) {
+			w_sign = w;
+		}
+		else if (w_sign > fixed::ZERO && w < fixed::ZERO) {
+			return false;
+		}
+		else if (w_sign < fixed::ZERO && w > fixed::ZERO) {
+			return false;
+		}
+	}
+
+	// Final wrap-around sign flips.
+	if (x_sign != 0 && x_first_sign != 0 && x_sign != x_first_sign) {
+		x_flips++;
+	}
+	if (y_sign != 0 && y_first_sign != 0 && y_sign != y_first_sign) {
+		y_flips++;
+	}
+
+	// Convex polygons have two sign flips along each axis.
+	return x_flips == 2 && y_flips == 2;
+}
+
+// Positive when the corner at p_cur turns the same way as a polygon whose
+// signed area is positive, zero when the points are in a line.
+_FORCE_INLINE_ static fixed sg_polygon_turn(const SGFixedVector2Internal &p_prev, const SGFixedVector2Internal &p_cur, const SGFixedVector2Internal &p_next) {
+	return (p_cur - p_prev).cross(p_next - p_cur);
+}
+
+// Inside, or on the edge of, a triangle with a positive turn at each corner.
+_FORCE_INLINE_ static bool sg_triangle_has_point(const SGFixedVector2Internal &p_a, const SGFixedVector2Internal &p_b, const SGFixedVector2Internal &p_c, const SGFixedVector2Internal &p_point) {
+	return (p_b - p_a).cross(p_point - p_a) >= fixed::ZERO &&
+			(p_c - p_b).cross(p_point - p_b) >= fixed::ZERO &&
+			(p_a - p_c).cross(p_point - p_c) >= fixed::ZERO;
+}
+
+// True if the segments cross at a single point that isn't at the end of
+// either one.
+static bool sg_segments_cross(const SGFixedVector2Internal &p_a1, const SGFixedVector2Internal &p_a2, const SGFixedVector2Internal &p_b1, const SGFixedVector2Internal &p_b2) {
+	fixed d1 = (p_a2 - p_a1).cross(p_b1 - p_a1);
+	fixed d2 = (p_a2 - p_a1).cross(p_b2 - p_a1);
+	fixed d3 = (p_b2 - p_b1).cross(p_a1 - p_b1);
+	fixed d4 = (p_b2 - p_b1).cross(p_a2 - p_b1);
+	return ((d1 > fixed::ZERO && d2 < fixed::ZERO) || (d1 < fixed::ZERO && d2 > fixed::ZERO)) &&
+			((d3 > fixed::ZERO && d4 < fixed::ZERO) || (d3 < fixed::ZERO && d4 > fixed::ZERO));
+}
+
+// Merges p_other into p_polygon if they share an edge, and the result is
+// still convex. Both are lists of point indices, with positive turns.
+static bool sg_polygon_try_merge(const std::vector<SGFixedVector2Internal> &p_points, std::vector<int> &p_polygon, const std::vector<int> &p_other) {
+	int count = p_polygon.size();
+	int other_count = p_other.size();
+	for (int i = 0; i < count; i++) {
+		int u = p_polygon[i];
+		int v = p_polygon[(i + 1) % count];
+		for (int j = 0; j < other_count; j++) {
+			if (p_other[j] != v || p_other[(j + 1) % other_count] != u) {
+				continue;
+			}
+
+			// The corners at each end of the shared edge are the only ones
+			// that change.
+			const SGFixedVector2Internal &before_u = p_points[p_polygon[(i + count - 1) % count]];
+			const SGFixedVector2Internal &after_u = p_points[p_other[(j + 2) % other_count]];
+			const SGFixedVector2Internal &before_v = p_points[p_other[(j + other_count - 1) % other_count]];
+			const SGFixedVector2Internal &after_v = p_points[p_polygon[(i + 2) % count]];
+			if (sg_polygon_turn(before_u, p_points[u], after_u) < fixed::ZERO || sg_polygon_turn(before_v, p_points[v], after_v) < fixed::ZERO) {
+				return false;
+			}
+
+			// Go around p_polygon from v to u, and then around p_other from
+			// just after u to just before v.
+			std::vector<int> merged;
+			for (int k = 0; k < count; k++) {
+				merged.push_back(p_polygon[(i + 1 + k) % count]);
+			}
+			for (int k = 2; k < other_count; k++) {
+				merged.push_back(p_other[(j + k) % other_count]);
+			}
+			p_polygon = merged;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SGPolygon2DInternal::decompose(const std::vector<SGFixedVector2Internal> &p_points, std::vector<std::vector<SGFixedVector2Internal>> &r_parts) {
+	r_parts.clear();
+
+	int count = p_points.size();
+	if (count < 3) {
+		return false;
+	}
+
+	// Ear clipping can't tell when a polygon crosses itself, and would give
+	// overlapping parts.
+	for (int i = 0; i < count; i++) {
+		for (int j = i + 2; j < count; j++) {
+			if (i == 0 && j == count - 1) {
+				continue;
+			}
+			if (sg_segments_cross(p_points[i], p_points[i + 1], p_points[j], p_points[(j + 1) % count])) {
+				return false;
+			}
+		}
+	}
+
+	fixed area;
+	for (int i = 0; i < count; i++) {
+		area += p_points[i].cross(p_points[(i + 1) % count]);
+	}
+	if (area == fixed::ZERO) {
+		return false;
+	}
+
+	// Work with indices, in the order that gives every convex corner a
+	// positive turn.
+	std::vector<int> remaining;
+	for (int i = 0; i < count; i++) {
+		remaining.push_back(area > fixed::ZERO ? i : count - 1 - i);
+	}
+
+	std::vector<std::vector<int>> polygons;
+	int start = 0;
+	while (remaining.size() > 3) {
+		int remaining_count = remaining.size();
+		bool clipped = false;
+		for (int n = 0; n < remaining_count; n++) {
+			int i = (start + n) % remaining_count;
+			int prev = remaining[(i + remaining_count - 1) % remaining_count];
+			int cur = remaining[i];
+			int next = remaining[(i + 1) % remaining_count];
+
+			fixed turn = sg_polygon_turn(p_points[prev], p_points[cur], p_points[next]);
+			if (turn < fixed::ZERO) {
+				continue;
+			}
+
+			// Points in a line (or repeated) don't add anything to the shape.
+			bool ear = turn > fixed::ZERO;
+			for (int j = 0; ear && j < remaining_count; j++) {
+				const SGFixedVector2Internal &point = p_points[remaining[j]];
+				if (point == p_points[prev] || point == p_points[cur] || point == p_points[next]) {
+					continue;
+				}
+				if (sg_triangle_has_point(p_points[prev], p_points[cur], p_points[next], point)) {
+					ear = false;
+				}
+			}
+			if (turn == fixed::ZERO || ear) {
+				if (ear) {
+					polygons.push_back({ prev, cur, next });
+				}
+				remaining.erase(remaining.begin() + i);
+				start = i;
+				clipped = true;
+				break;
+			}
+		}
+
+		if (!clipped) {
+			return false;
+		}
+	}
+	if (sg_polygon_turn(p_points[remaining[0]], p_points[remaining[1]], p_points[remaining[2]]) > fixed::ZERO) {
+		polygons.push_back(remaining);
+	}
+	if (polygons.size() == 0) {
+		return false;
+	}
+
+	// Merge triangles back together (Hertel-Mehlhorn), where the result
+	// stays convex.
+	for (std::size_t i = 0; i < polygons.size(); i++) {
+		for (std::size_t j = i + 1; j < polygons.size();) {
+			if (sg_polygon_try_merge(p_points, polygons[i], polygons[j])) {
+				polygons.erase(polygons.begin() + j);
+				// Polygon i has changed shape, so check the others again.
+				j = i + 1;
+			}
+			else {
+				j++;
+			}
+		}
+	}
+
+	for (const std::vector<int> &polygon : polygons) {
+		std::vector<SGFixedVector2Internal> part;
+		for (int index : polygon) {
+			part.push_back(p_points[index]);
+		}
+		r_parts.push_back(part);
+	}
+	return true;
+}
+
+uint64_t SGCircle2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = SGShape2DInternal::hash_state(p_hash);
+	return sg_hash_combine(p_hash, radius.value);
+}
+
+SGFixedRect2Internal SGCircle2DInternal::compute_bounds() const {
 	SGFixedTransform2DInternal t = get_global_transform();
 	fixed radius_scaled = radius * t.get_scale().x;
 	fixed diameter(radius_scaled.value << 1);
 	return SGFixedRect2Internal(t.get_origin() - radius_scaled, SGFixedVector2Internal(diameter, diameter));
 }
 
-std::vector<SGFixedVector2Internal> SGCapsule2DInternal::get_global_vertices() const {
+uint64_t SGCapsule2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = SGShape2DInternal::hash_state(p_hash);
+	p_hash = sg_hash_combine(p_hash, radius.value);
+	return sg_hash_combine(p_hash, height.value);
+}
+
+const std::vector<SGFixedVector2Internal> &SGCapsule2DInternal::get_global_vertices() const {
 	if (global_vertices_dirty) {
 		SGFixedTransform2DInternal t = get_global_transform();
 		const fixed half_height = fixed(height.value / 2);
@@ -150,10 +631,10 @@ std::vector<SGFixedVector2Internal> SGCapsule2DInternal::get_global_vertices() c
 	return global_vertices;
 }
 
-SGFixedRect2Internal SGCapsule2DInternal::get_bounds() const {
+SGFixedRect2Internal SGCapsule2DInternal::compute_bounds() const {
 	SGFixedTransform2DInternal t = get_global_transform();
 	fixed radius_scaled = radius * t.get_scale().x;
-	const std::vector<SGFixedVector2Internal> global_vertices = get_global_vertices();
+	const std::vector<SGFixedVector2Internal> &global_vertices = get_global_vertices();
 	SGFixedRect2Internal bounds(global_vertices[0], SGFixedVector2Internal());
 	bounds.expand_to(global_vertices[1]);
 	bounds.position -= SGFixedVector2Internal(radius_scaled, radius_scaled);
@@ -161,3 +642,113 @@ SGFixedRect2Internal SGCapsule2DInternal::get_bounds() const {
 	bounds.size += SGFixedVector2Internal(diameter_scaled, diameter_scaled);
 	return bounds;
 }
+
+_FORCE_INLINE_ static int64_t sg_floor_div(int64_t p_a, int64_t p_b) {
+	int64_t q = p_a / p_b;
+	return (p_a % p_b != 0 && (p_a < 0) != (p_b < 0)) ? q - 1 : q;
+}
+
+void SGGrid2DInternal::set_size(int p_width, int p_height) {
+	ERR_FAIL_COND(p_width < 0 || p_height < 0);
+
+	std::vector<uint64_t> old_cells;
+	old_cells.swap(cells);
+	int old_width = width;
+	int old_height = height;
+
+	width = p_width;
+	height = p_height;
+	cells.assign(((int64_t)width * height + 31) >> 5, 0);
+
+	int copy_width = MIN(width, old_width);
+	int copy_height = MIN(height, old_height);
+	for (int y = 0; y < copy_height; y++) {
+		for (int x = 0; x < copy_width; x++) {
+			int old_index = y * old_width + x;
+			uint64_t type = (old_cells[old_index >> 5] >> ((old_index & 31) << 1)) & 3;
+			int index = y * width + x;
+			cells[index >> 5] |= type << ((index & 31) << 1);
+		}
+	}
+
+	notify_owner();
+}
+
+void SGGrid2DInternal::set_cell(int p_x, int p_y, CellType p_type) {
+	ERR_FAIL_INDEX(p_x, width);
+	ERR_FAIL_INDEX(p_y, height);
+	int index = p_y * width + p_x;
+	int shift = (index & 31) << 1;
+	uint64_t &word = cells[index >> 5];
+	word = (word & ~(3ULL << shift)) | ((uint64_t)p_type << shift);
+	notify_owner();
+}
+
+void SGGrid2DInternal::set_cells(const uint8_t *p_types) {
+	std::fill(cells.begin(), cells.end(), 0);
+	int count = width * height;
+	for (int index = 0; index < count; index++) {
+		uint64_t type = p_types[index] <= (uint8_t)CELL_ONE_WAY ? p_types[index] : (uint8_t)CELL_EMPTY;
+		cells[index >> 5] |= type << ((index & 31) << 1);
+	}
+	notify_owner();
+}
+
+bool SGGrid2DInternal::get_cell_range(const SGFixedRect2Internal &p_bounds, int &r_min_x, int &r_min_y, int &r_max_x, int &r_max_y) const {
+	if (width == 0 || height == 0 || cell_size.x <= fixed::ZERO || cell_size.y <= fixed::ZERO) {
+		return false;
+	}
+
+	SGFixedTransform2DInternal inverse = get_global_transform().affine_inverse();
+	SGFixedVector2Internal corners[4] = {
+		p_bounds.position,
+		SGFixedVector2Internal(p_bounds.position.x + p_bounds.size.x, p_bounds.position.y),
+		SGFixedVector2Internal(p_bounds.position.x, p_bounds.position.y + p_bounds.size.y),
+		p_bounds.position + p_bounds.size,
+	};
+	SGFixedRect2Internal local_bounds(inverse.xform(corners[0]), SGFixedVector2Internal());
+	for (int i = 1; i < 4; i++) {
+		local_bounds.expand_to(inverse.xform(corners[i]));
+	}
+	// Allow for rounding in the inverse transform.
+	local_bounds.grow_by(fixed(4));
+
+	SGFixedVector2Internal local_max = local_bounds.position + local_bounds.size;
+	r_min_x = (int)MAX(sg_floor_div(local_bounds.position.x.value, cell_size.x.value), (int64_t)0);
+	r_min_y = (int)MAX(sg_floor_div(local_bounds.position.y.value, cell_size.y.value), (int64_t)0);
+	r_max_x = (int)MIN(sg_floor_div(local_max.x.value, cell_size.x.value), (int64_t)width - 1);
+	r_max_y = (int)MIN(sg_floor_div(local_max.y.value, cell_size.y.value), (int64_t)height - 1);
+	return r_min_x <= r_max_x && r_min_y <= r_max_y;
+}
+
+SGFixedTransform2DInternal SGGrid2DInternal::get_cell_transform(int p_x, int p_y) const {
+	SGFixedTransform2DInternal t = get_global_transform();
+	SGFixedVector2Internal center(
+			fixed(cell_size.x.value * p_x + cell_size.x.value / 2),
+			fixed(cell_size.y.value * p_y + cell_size.y.value / 2));
+	t.set_origin(t.xform(center));
+	return t;
+}
+
+uint64_t SGGrid2DInternal::hash_state(uint64_t p_hash) const {
+	p_hash = SGShape2DInternal::hash_state(p_hash);
+	p_hash = sg_hash_combine(p_hash, cell_size.x.value);
+	p_hash = sg_hash_combine(p_hash, cell_size.y.value);
+	p_hash = sg_hash_combine(p_hash, width);
+	p_hash = sg_hash_combine(p_hash, height);
+	for (uint64_t word : cells) {
+		p_hash = sg_hash_combine(p_hash, word);
+	}
+	return p_hash;
+}
+
+SGFixedRect2Internal SGGrid2DInternal::compute_bounds() const {
+	SGFixedTransform2DInternal t = get_global_transform();
+	SGFixedRect2Internal bounds(t.get_origin(), SGFixedVector2Internal());
+	fixed grid_width(cell_size.x.value * width);
+	fixed grid_height(cell_size.y.value * height);
+	bounds.expand_to(t.xform(SGFixedVector2Internal(grid_width, fixed::ZERO)));
+	bounds.expand_to(t.xform(SGFixedVector2Internal(fixed::ZERO, grid_height)));
+	bounds.expand_to(t.xform(SGFixedVector2Internal(grid_width, grid_height)));
+	return bounds;
+}
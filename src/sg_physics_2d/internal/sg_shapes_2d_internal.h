@@ -28,8 +28,10 @@
 
 #include "sg_fixed_transform_2d_internal.h"
 #include "sg_fixed_rect2_internal.h"
+#include "sg_pool_internal.h"
 
 class SGCollisionObject2DInternal;
+class SGResultHandlerInternal;
 
 class SGShape2DInternal {
 public:
@@ -39,6 +41,8 @@ public:
 		SHAPE_CIRCLE,
 		SHAPE_POLYGON,
 		SHAPE_CAPSULE,
+		SHAPE_GRID,
+		SHAPE_MAX,
 	};
 
 protected:
@@ -50,15 +54,18 @@ protected:
 	mutable bool global_xform_dirty;
 	mutable bool global_vertices_dirty;
 	mutable bool global_axes_dirty;
+	mutable bool global_bounds_dirty;
 	SGCollisionObject2DInternal *owner;
 	mutable std::vector<SGFixedVector2Internal> global_vertices;
 	mutable std::vector<SGFixedVector2Internal> global_axes;
+	mutable SGFixedRect2Internal global_bounds;
 	void *data;
 
 	_FORCE_INLINE_ void mark_global_xform_dirty() const {
 		global_xform_dirty = true;
 		global_vertices_dirty = true;
 		global_axes_dirty = true;
+		global_bounds_dirty = true;
 	}
 
 	_FORCE_INLINE_ void set_owner(SGCollisionObject2DInternal *p_owner) {
@@ -66,21 +73,43 @@ protected:
 		mark_global_xform_dirty();
 	}
 
+	// Marks everything computed from the shape's parameters as dirty, and
+	// lets the owner know its bounds may have changed.
+	void notify_owner();
+
+	virtual SGFixedRect2Internal compute_bounds() const;
+
 public:
 	_FORCE_INLINE_ ShapeType get_shape_type() const { return shape_type; }
 
 	_FORCE_INLINE_ void set_transform(const SGFixedTransform2DInternal &p_transform) {
 		transform = p_transform;
 		mark_global_xform_dirty();
+		notify_owner();
 	}
 	_FORCE_INLINE_ SGFixedTransform2DInternal get_transform() const { return transform; }
 	SGFixedTransform2DInternal get_global_transform() const;
 
 	_FORCE_INLINE_ SGCollisionObject2DInternal *get_owner() const { return owner; }
 
-	virtual std::vector<SGFixedVector2Internal> get_global_vertices() const;
-	virtual std::vector<SGFixedVector2Internal> get_global_axes() const;
-	virtual SGFixedRect2Internal get_bounds() const;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_vertices() const;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_axes() const;
+
+	// Cached, since it's checked before every narrowphase test.
+	_FORCE_INLINE_ const SGFixedRect2Internal &get_bounds() const {
+		if (global_bounds_dirty) {
+			global_bounds = compute_bounds();
+			global_bounds_dirty = false;
+		}
+		return global_bounds;
+	}
+
+	// Computes the global transform, vertices, axes and bounds, if they're
+	// out of date, so that getting them afterwards doesn't write anything.
+	virtual void update_global_cache() const;
+
+	// Mixes the shape's type, transform and parameters into p_hash.
+	virtual uint64_t hash_state(uint64_t p_hash) const;
 
 	_FORCE_INLINE_ void set_data(void *p_data) { data = p_data; }
 	_FORCE_INLINE_ void *get_data() const { return data; }
@@ -90,6 +119,7 @@ public:
 		global_xform_dirty = false;
 		global_vertices_dirty = true;
 		global_axes_dirty = true;
+		global_bounds_dirty = true;
 		owner = nullptr;
 		data = nullptr;
 	}
@@ -97,6 +127,8 @@ public:
 };
 
 class SGRectangle2DInternal : public SGShape2DInternal {
+	SG_POOL_ALLOCATED(SGRectangle2DInternal);
+
 protected:
 
 	SGFixedVector2Internal extents;
@@ -105,12 +137,13 @@ public:
 	_FORCE_INLINE_ SGFixedVector2Internal get_extents() const { return extents; }
 	_FORCE_INLINE_ void set_extents(const SGFixedVector2Internal &p_extents) {
 		extents = p_extents;
-		global_vertices_dirty = true;
+		notify_owner();
 	}
 
 	SGFixedVector2Internal get_closest_vertex(const SGFixedVector2Internal& point) const;
-	virtual std::vector<SGFixedVector2Internal> get_global_vertices() const override;
-	virtual std::vector<SGFixedVector2Internal> get_global_axes() const override;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_vertices() const override;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_axes() const override;
+	virtual uint64_t hash_state(uint64_t p_hash) const override;
 
 	SGRectangle2DInternal(SGFixedVector2Internal p_extents)
 		: SGShape2DInternal(SHAPE_RECTANGLE)
@@ -124,15 +157,22 @@ public:
 };
 
 class SGCircle2DInternal : public SGShape2DInternal {
+	SG_POOL_ALLOCATED(SGCircle2DInternal);
+
 protected:
 
 	fixed radius;
 
+	virtual SGFixedRect2Internal compute_bounds() const override;
+
 public:
 	_FORCE_INLINE_ fixed get_radius() const { return radius; }
-	_FORCE_INLINE_ void set_radius(const fixed &p_radius) { radius = p_radius; }
+	_FORCE_INLINE_ void set_radius(const fixed &p_radius) {
+		radius = p_radius;
+		notify_owner();
+	}
 
-	virtual SGFixedRect2Internal get_bounds() const override;
+	virtual uint64_t hash_state(uint64_t p_hash) const override;
 
 	SGCircle2DInternal(fixed p_radius)
 		: SGShape2DInternal(SHAPE_CIRCLE)
@@ -142,39 +182,93 @@ public:
 };
 
 class SGPolygon2DInternal : public SGShape2DInternal {
+	SG_POOL_ALLOCATED(SGPolygon2DInternal);
+
 protected:
 
+	// A node in the bounding volume hierarchy over the convex parts, in the
+	// polygon's local space. Leaves have a count, and hold the parts from
+	// 'first' in part_order. Branches have their first child right after
+	// them, and their second child at 'first'.
+	struct PartNode {
+		SGFixedRect2Internal bounds;
+		int first;
+		int count;
+	};
+
 	std::vector<SGFixedVector2Internal> points;
 
-public:
-	_FORCE_INLINE_ std::vector<SGFixedVector2Internal> get_points() const { return points; }
-	_FORCE_INLINE_ void set_points(const std::vector<SGFixedVector2Internal> &p_points) {
-		points = p_points;
-		global_vertices.clear();
-		global_axes.clear();
-	}
+	// Concave polygons are split into convex parts when their points are set,
+	// which are used in their place for collision tests. The parts always
+	// have the polygon's global transform.
+	bool concave;
+	std::vector<SGPolygon2DInternal *> parts;
+	std::vector<int> part_order;
+	std::vector<PartNode> part_nodes;
+	mutable SGFixedTransform2DInternal parts_transform;
+	mutable bool parts_dirty;
+
+	void clear_parts();
+	int build_part_nodes(const std::vector<SGFixedRect2Internal> &p_part_bounds, int p_first, int p_count);
+	void update_parts() const;
 
-	virtual std::vector<SGFixedVector2Internal> get_global_vertices() const override;
-	virtual std::vector<SGFixedVector2Internal> get_global_axes() const override;
+public:
+	_FORCE_INLINE_ const std::vector<SGFixedVector2Internal> &get_points() const { return points; }
+	void set_points(const std::vector<SGFixedVector2Internal> &p_points);
 
-	SGPolygon2DInternal() : SGShape2DInternal(SHAPE_POLYGON) { }
+	_FORCE_INLINE_ bool is_concave() const { return concave; }
+	_FORCE_INLINE_ const std::vector<SGPolygon2DInternal *> &get_parts() const {
+		update_parts();
+		return parts;
+	}
+	// Passes every convex part whose bounds intersect p_bounds (in global
+	// space) to the result handler, along with the polygon's owner.
+	void find_parts(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler) const;
+
+	virtual const std::vector<SGFixedVector2Internal> &get_global_vertices() const override;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_axes() const override;
+	virtual void update_global_cache() const override;
+	virtual uint64_t hash_state(uint64_t p_hash) const override;
+
+	static bool is_convex(const std::vector<SGFixedVector2Internal> &p_points);
+	// Splits a simple polygon (one that doesn't cross itself) into convex
+	// parts, by ear clipping and then merging triangles back together where
+	// the result stays convex. Only uses fixed-point math, so the parts are
+	// the same on every platform. Returns false if it can't be split.
+	static bool decompose(const std::vector<SGFixedVector2Internal> &p_points, std::vector<std::vector<SGFixedVector2Internal>> &r_parts);
+
+	SGPolygon2DInternal() : SGShape2DInternal(SHAPE_POLYGON) {
+		concave = false;
+		parts_dirty = false;
+	}
+	virtual ~SGPolygon2DInternal();
 };
 
 class SGCapsule2DInternal : public SGShape2DInternal {
+	SG_POOL_ALLOCATED(SGCapsule2DInternal);
+
 protected:
 
 	fixed radius;
 	fixed height;
 
+	virtual SGFixedRect2Internal compute_bounds() const override;
+
 public:
 	_FORCE_INLINE_ fixed get_radius() const { return radius; }
-	_FORCE_INLINE_ void set_radius(const fixed& p_radius) { radius = p_radius; }
+	_FORCE_INLINE_ void set_radius(const fixed& p_radius) {
+		radius = p_radius;
+		notify_owner();
+	}
 
 	_FORCE_INLINE_ fixed get_height() const { return height; }
-	_FORCE_INLINE_ void set_height(const fixed& p_height) { height = p_height; }
+	_FORCE_INLINE_ void set_height(const fixed& p_height) {
+		height = p_height;
+		notify_owner();
+	}
 
-	virtual std::vector<SGFixedVector2Internal> get_global_vertices() const override;
-	virtual SGFixedRect2Internal get_bounds() const override;
+	virtual const std::vector<SGFixedVector2Internal> &get_global_vertices() const override;
+	virtual uint64_t hash_state(uint64_t p_hash) const override;
 
 	SGCapsule2DInternal(fixed p_radius, fixed p_height)
 		: SGShape2DInternal(SHAPE_CAPSULE)
@@ -185,4 +279,68 @@ public:
 	}
 };
 
+class SGGrid2DInternal : public SGShape2DInternal {
+	SG_POOL_ALLOCATED(SGGrid2DInternal);
+
+public:
+
+	enum CellType {
+		CELL_EMPTY,
+		CELL_SOLID,
+		// Only pushes shapes out through the top of the cell.
+		CELL_ONE_WAY,
+	};
+
+protected:
+
+	// Two bits per cell, row by row, so a 512x512 grid takes 64KB.
+	SGFixedVector2Internal cell_size;
+	int width;
+	int height;
+	std::vector<uint64_t> cells;
+
+	virtual SGFixedRect2Internal compute_bounds() const override;
+
+public:
+	_FORCE_INLINE_ SGFixedVector2Internal get_cell_size() const { return cell_size; }
+	_FORCE_INLINE_ void set_cell_size(const SGFixedVector2Internal &p_cell_size) {
+		cell_size = p_cell_size;
+		notify_owner();
+	}
+
+	_FORCE_INLINE_ int get_width() const { return width; }
+	_FORCE_INLINE_ int get_height() const { return height; }
+	// Keeps the cells that are still inside the grid.
+	void set_size(int p_width, int p_height);
+
+	// Cells outside of the grid are empty.
+	_FORCE_INLINE_ CellType get_cell(int p_x, int p_y) const {
+		if (p_x < 0 || p_y < 0 || p_x >= width || p_y >= height) {
+			return CELL_EMPTY;
+		}
+		int index = p_y * width + p_x;
+		return (CellType)((cells[index >> 5] >> ((index & 31) << 1)) & 3);
+	}
+	void set_cell(int p_x, int p_y, CellType p_type);
+	// Sets every cell from one CellType per byte, row by row, and only lets
+	// the owner know once. Unknown types are treated as empty.
+	void set_cells(const uint8_t *p_types);
+
+	// Finds the cells that could touch p_bounds (in global space), clamped to
+	// the grid. Returns false if there aren't any.
+	bool get_cell_range(const SGFixedRect2Internal &p_bounds, int &r_min_x, int &r_min_y, int &r_max_x, int &r_max_y) const;
+	// The global transform of the center of a cell.
+	SGFixedTransform2DInternal get_cell_transform(int p_x, int p_y) const;
+
+	virtual uint64_t hash_state(uint64_t p_hash) const override;
+
+	SGGrid2DInternal(const SGFixedVector2Internal &p_cell_size)
+		: SGShape2DInternal(SHAPE_GRID)
+	{
+		cell_size = p_cell_size;
+		width = 0;
+		height = 0;
+	}
+};
+
 #endif
@@ -0,0 +1,286 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "sg_static_broadphase_2d_internal.h"
+
+#include <algorithm>
+
+#include "sg_bodies_2d_internal.h"
+
+// Orders elements by the center of their bounds along one axis, falling
+// back on the handle, so the order never depends on the sorting algorithm.
+struct SGStaticBroadphaseElementCompare {
+	const std::vector<SGFixedRect2Internal> *bounds;
+	bool x_axis;
+
+	_FORCE_INLINE_ int64_t get_key(int32_t p_element) const {
+		// Really twice the center, to avoid rounding.
+		const SGFixedRect2Internal &element_bounds = (*bounds)[p_element];
+		if (x_axis) {
+			return element_bounds.position.x.value + element_bounds.position.x.value + element_bounds.size.x.value;
+		}
+		return element_bounds.position.y.value + element_bounds.position.y.value + element_bounds.size.y.value;
+	}
+
+	_FORCE_INLINE_ bool operator()(int32_t p_a, int32_t p_b) const {
+		int64_t key_a = get_key(p_a);
+		int64_t key_b = get_key(p_b);
+		if (key_a != key_b) {
+			return key_a < key_b;
+		}
+		return p_a < p_b;
+	}
+};
+
+void SGStaticBroadphase2DInternal::_add_pending(int32_t p_element) {
+	element_pending_positions[p_element] = pending_elements.size();
+	pending_elements.push_back(p_element);
+}
+
+void SGStaticBroadphase2DInternal::_remove_pending(int32_t p_element) {
+	int32_t position = element_pending_positions[p_element];
+	int32_t last = pending_elements.back();
+	pending_elements[position] = last;
+	element_pending_positions[last] = position;
+	pending_elements.pop_back();
+	element_pending_positions[p_element] = NULL_SLOT;
+}
+
+int32_t SGStaticBroadphase2DInternal::_build_node(int32_t p_begin, int32_t p_end) const {
+	int32_t index = nodes.size();
+	nodes.push_back(Node());
+
+	SGFixedRect2Internal bounds = element_bounds[leaf_elements[p_begin]];
+	for (int32_t i = p_begin + 1; i < p_end; i++) {
+		bounds = bounds.merge(element_bounds[leaf_elements[i]]);
+	}
+
+	if (p_end - p_begin <= LEAF_SIZE) {
+		Node &node = nodes[index];
+		node.bounds = bounds;
+		node.first = p_begin;
+		node.count = p_end - p_begin;
+		node.skip = index + 1;
+		return index;
+	}
+
+	// Split in half along the axis where the bounds are the longest.
+	SGStaticBroadphaseElementCompare compare;
+	compare.bounds = &element_bounds;
+	compare.x_axis = bounds.size.x >= bounds.size.y;
+	std::sort(leaf_elements.begin() + p_begin, leaf_elements.begin() + p_end, compare);
+
+	int32_t middle = p_begin + (p_end - p_begin) / 2;
+	_build_node(p_begin, middle);
+	_build_node(middle, p_end);
+
+	// The children may have moved the nodes, so no references until now.
+	Node &node = nodes[index];
+	node.bounds = bounds;
+	node.first = p_begin;
+	node.count = 0;
+	node.skip = nodes.size();
+	return index;
+}
+
+void SGStaticBroadphase2DInternal::_build() const {
+	for (int32_t element : pending_elements) {
+		element_pending_positions[element] = NULL_SLOT;
+	}
+	pending_elements.clear();
+	deleted_count = 0;
+
+	leaf_elements.assign(element_list.begin(), element_list.end());
+	nodes.clear();
+	if (leaf_elements.size() == 0) {
+		return;
+	}
+
+	nodes.reserve(2 * (leaf_elements.size() / LEAF_SIZE + 1));
+	_build_node(0, leaf_elements.size());
+
+	for (std::size_t i = 0; i < leaf_elements.size(); i++) {
+		element_slots[leaf_elements[i]] = i;
+	}
+}
+
+int32_t SGStaticBroadphase2DInternal::create_element(SGCollisionObject2DInternal *p_object) {
+	int32_t element = _allocate_element(p_object);
+	if (element == (int32_t)element_slots.size()) {
+		element_slots.push_back(0);
+		element_pending_positions.push_back(0);
+	}
+
+	element_slots[element] = NULL_SLOT;
+	_add_pending(element);
+
+	return element;
+}
+
+void SGStaticBroadphase2DInternal::update_element(int32_t p_element) {
+	SGFixedRect2Internal bounds = element_objects[p_element]->get_bounds();
+	const SGFixedRect2Internal &old_bounds = element_bounds[p_element];
+	if (bounds.position == old_bounds.position && bounds.size == old_bounds.size) {
+		return;
+	}
+
+	element_bounds[p_element] = bounds;
+	element_fat_bounds[p_element] = bounds;
+
+	// Take it out of the tree, and check it separately until the next build.
+	int32_t slot = element_slots[p_element];
+	if (slot != NULL_SLOT) {
+		leaf_elements[slot] = NULL_ELEMENT;
+		element_slots[p_element] = NULL_SLOT;
+		deleted_count++;
+		_add_pending(p_element);
+	}
+}
+
+void SGStaticBroadphase2DInternal::delete_element(int32_t p_element) {
+	int32_t slot = element_slots[p_element];
+	if (slot != NULL_SLOT) {
+		leaf_elements[slot] = NULL_ELEMENT;
+		element_slots[p_element] = NULL_SLOT;
+		deleted_count++;
+	}
+	else {
+		_remove_pending(p_element);
+	}
+	_free_element(p_element);
+}
+
+void SGStaticBroadphase2DInternal::find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	if (_needs_build()) {
+		_build();
+	}
+
+	uint64_t candidates = pending_elements.size();
+	int32_t node_count = nodes.size();
+	int32_t index = 0;
+	while (index < node_count) {
+		const Node &node = nodes[index];
+		if (!p_bounds.intersects(node.bounds)) {
+			index = node.skip;
+			continue;
+		}
+
+		candidates += node.count;
+		for (int32_t i = node.first; i < node.first + node.count; i++) {
+			int32_t element = leaf_elements[i];
+			if (element == NULL_ELEMENT || !element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+				continue;
+			}
+			if (p_bounds.intersects(element_bounds[element])) {
+				p_result_handler->handle_result(element_objects[element], nullptr);
+			}
+		}
+
+		index++;
+	}
+
+	for (int32_t element : pending_elements) {
+		if (!element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+			continue;
+		}
+		if (p_bounds.intersects(element_bounds[element])) {
+			p_result_handler->handle_result(element_objects[element], nullptr);
+		}
+	}
+
+	_count_query(candidates);
+}
+
+void SGStaticBroadphase2DInternal::find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	if (_needs_build()) {
+		_build();
+	}
+
+	uint64_t candidates = pending_elements.size();
+	SGFixedRect2Internal segment_bounds(p_start, SGFixedVector2Internal());
+	segment_bounds.expand_to(p_start + p_cast_to);
+
+	// Only changes after reporting a result.
+	SGFixedVector2Internal hit;
+	bool has_hit = p_result_handler->get_closest_hit(hit);
+
+	// Check the pending elements first, since they may give a hit that lets
+	// us skip most of the tree.
+	for (int32_t element : pending_elements) {
+		if (!element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+			continue;
+		}
+		if (_segment_may_touch(p_start, p_cast_to, segment_bounds, element_bounds[element])) {
+			p_result_handler->handle_result(element_objects[element], nullptr);
+			has_hit = p_result_handler->get_closest_hit(hit);
+		}
+	}
+
+	int32_t node_count = nodes.size();
+	int32_t index = 0;
+	while (index < node_count) {
+		const Node &node = nodes[index];
+		if (!_segment_may_touch(p_start, p_cast_to, segment_bounds, node.bounds) || (has_hit && _is_past_point(p_start, p_cast_to, node.bounds, hit))) {
+			index = node.skip;
+			continue;
+		}
+
+		candidates += node.count;
+		for (int32_t i = node.first; i < node.first + node.count; i++) {
+			int32_t element = leaf_elements[i];
+			if (element == NULL_ELEMENT || !element_filters[element].passes(p_type, p_collision_layer, p_collision_mask)) {
+				continue;
+			}
+			if (_segment_may_touch(p_start, p_cast_to, segment_bounds, element_bounds[element])) {
+				p_result_handler->handle_result(element_objects[element], nullptr);
+				has_hit = p_result_handler->get_closest_hit(hit);
+			}
+		}
+
+		index++;
+	}
+
+	_count_query(candidates);
+}
+
+void SGStaticBroadphase2DInternal::rebuild() {
+	for (int32_t element : element_list) {
+		element_bounds[element] = element_objects[element]->get_bounds();
+		_reset_fat_bounds(element);
+	}
+	_build();
+}
+
+void SGStaticBroadphase2DInternal::prepare_for_queries() {
+	if (_needs_build()) {
+		_build();
+	}
+}
+
+SGStaticBroadphase2DInternal::SGStaticBroadphase2DInternal() {
+	deleted_count = 0;
+}
+
+SGStaticBroadphase2DInternal::~SGStaticBroadphase2DInternal() {
+}
@@ -0,0 +1,113 @@
+/*************************************************************************/
+/* Copyright (c) 2021-2022 David Snopek                                  */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef SG_STATIC_BROADPHASE_2D_INTERNAL_H
+#define SG_STATIC_BROADPHASE_2D_INTERNAL_H
+
+#include <vector>
+
+#include "sg_broadphase_2d_internal.h"
+
+// A bounding volume hierarchy for objects that (almost) never move, which
+// is bulk loaded in one go rather than built up one insertion at a time.
+//
+// The nodes are laid out in depth-first order, each with the index to skip
+// to when a query doesn't touch its bounds, so queries walk forward through
+// one flat array without a stack. Elements created or moved since the last
+// build are kept in a short list that's checked one by one, and deleted ones
+// are simply blanked out, until there are enough of either to be worth
+// building again. That happens on the next query, so loading a level full of
+// static bodies only builds the tree once.
+//
+// Building sorts on the element bounds with the handle as a tie-breaker, so
+// the tree (and the order of results) only depends on the order of
+// operations, like the other broadphases.
+class SGStaticBroadphase2DInternal : public SGBroadphase2DInternal {
+public:
+
+	static const int32_t NULL_SLOT = -1;
+	static const int32_t LEAF_SIZE = 4;
+	static const int32_t MIN_PENDING_ELEMENTS = 16;
+
+	struct Node {
+		SGFixedRect2Internal bounds;
+		// The range of leaf_elements in a leaf. Branches have a count of 0,
+		// and their first child straight after them.
+		int32_t first;
+		int32_t count;
+		// The node after this one and all of its descendants.
+		int32_t skip;
+	};
+
+private:
+	// Everything below is only ever rebuilt as a whole, which happens lazily
+	// in find_nearby().
+	mutable std::vector<Node> nodes;
+	// The elements in the tree, grouped by leaf. Deleted ones are replaced
+	// with NULL_ELEMENT.
+	mutable std::vector<int32_t> leaf_elements;
+	mutable int32_t deleted_count;
+	mutable std::vector<int32_t> pending_elements;
+
+	// Where each element is in leaf_elements and pending_elements, indexed
+	// by its handle.
+	mutable std::vector<int32_t> element_slots;
+	mutable std::vector<int32_t> element_pending_positions;
+
+	void _add_pending(int32_t p_element);
+	void _remove_pending(int32_t p_element);
+
+	_FORCE_INLINE_ bool _needs_build() const {
+		int32_t limit = MAX(MIN_PENDING_ELEMENTS, (int32_t)(leaf_elements.size() / 8));
+		return (int32_t)pending_elements.size() > limit || deleted_count > limit;
+	}
+
+	int32_t _build_node(int32_t p_begin, int32_t p_end) const;
+	void _build() const;
+
+public:
+	virtual BroadphaseType get_broadphase_type() const override { return BROADPHASE_STATIC; }
+
+	virtual int32_t create_element(SGCollisionObject2DInternal *p_object) override;
+	virtual void update_element(int32_t p_element) override;
+	virtual void delete_element(int32_t p_element) override;
+
+	virtual void find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+	virtual void find_along_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGRayResultHandlerInternal *p_result_handler, int p_type = 3, uint32_t p_collision_layer = 0xFFFFFFFF, uint32_t p_collision_mask = 0xFFFFFFFF) const override;
+
+	// Static objects don't move, so there's no use for a margin.
+	virtual void set_margin(fixed p_margin) override { }
+	virtual void rebuild() override;
+
+	// Does any pending build up front, so that find_nearby() won't change
+	// anything and can be called from several threads at once.
+	void prepare_for_queries();
+
+	_FORCE_INLINE_ int get_node_count() const { return nodes.size(); }
+
+	SGStaticBroadphase2DInternal();
+	~SGStaticBroadphase2DInternal();
+};
+
+#endif
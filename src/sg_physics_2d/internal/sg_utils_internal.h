@@ -24,6 +24,7 @@
 #ifndef SG_UTILS_INTERNAL_H
 #define SG_UTILS_INTERNAL_H
 
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 
@@ -36,4 +37,18 @@ inline void sg_remove_by_value(std::vector<T> &p_vector, const T &p_value){
 	}
 }
 
+inline uint64_t sg_hash_mix(uint64_t p_hash) {
+	// MurmurHash3's 64-bit finalizer.
+	p_hash ^= p_hash >> 33;
+	p_hash *= 0xff51afd7ed558ccdULL;
+	p_hash ^= p_hash >> 33;
+	p_hash *= 0xc4ceb9fe1a85ec53ULL;
+	p_hash ^= p_hash >> 33;
+	return p_hash;
+}
+
+inline uint64_t sg_hash_combine(uint64_t p_hash, uint64_t p_value) {
+	return sg_hash_mix(p_hash ^ (p_value + 0x9e3779b97f4a7c15ULL + (p_hash << 6) + (p_hash >> 2)));
+}
+
 #endif
\ No newline at end of file
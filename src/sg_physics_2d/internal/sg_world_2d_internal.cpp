@@ -29,13 +29,24 @@
 #include "sg_collision_detector_2d_internal.h"
 #include "sg_utils_internal.h"
 
+void SGWorld2DInternal::_find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const {
+	if (p_type & SGCollisionObject2DInternal::OBJECT_BODY) {
+		static_broadphase->find_nearby(p_bounds, p_result_handler, p_type, p_collision_layer, p_collision_mask);
+	}
+	broadphase->find_nearby(p_bounds, p_result_handler, p_type, p_collision_layer, p_collision_mask);
+}
+
 void SGWorld2DInternal::add_area(SGArea2DInternal *p_area) {
 	areas.push_back(p_area);
 	p_area->add_to_broadphase(broadphase);
 	p_area->set_world(this);
+	mark_overlaps_dirty(p_area);
+	mark_state_hash_dirty(p_area);
 }
 
 void SGWorld2DInternal::remove_area(SGArea2DInternal *p_area) {
+	_remove_from_overlaps(p_area);
+	_remove_from_state_hash(p_area);
 	sg_remove_by_value(areas, p_area);
 	p_area->remove_from_broadphase();
 	p_area->set_world(nullptr);
@@ -43,14 +54,18 @@ void SGWorld2DInternal::remove_area(SGArea2DInternal *p_area) {
 
 void SGWorld2DInternal::add_body(SGBody2DInternal *p_body) {
 	bodies.push_back(p_body);
-	p_body->add_to_broadphase(broadphase);
+	p_body->add_to_broadphase(_get_broadphase_for(p_body));
 	p_body->set_world(this);
+	mark_overlaps_dirty(p_body);
+	mark_state_hash_dirty(p_body);
 }
 
 void SGWorld2DInternal::remove_body(SGBody2DInternal *p_body) {
+	_remove_from_overlaps(p_body);
+	_remove_from_state_hash(p_body);
 	sg_remove_by_value(bodies, p_body);
 	p_body->remove_from_broadphase();
-	p_body->set_world(this);
+	p_body->set_world(nullptr);
 }
 
 bool SGWorld2DInternal::overlaps(SGCollisionObject2DInternal *p_object1, SGCollisionObject2DInternal *p_object2, fixed p_margin, SGWorld2DInternal::BodyOverlapInfo *p_info) const {
@@ -83,77 +98,311 @@ bool SGWorld2DInternal::overlaps(SGCollisionObject2DInternal *p_object1, SGColli
 	return overlapping;
 }
 
-bool SGWorld2DInternal::overlaps(SGShape2DInternal *p_shape1, SGShape2DInternal *p_shape2, fixed p_margin, SGWorld2DInternal::ShapeOverlapInfo *p_info) const {
-	using ShapeType = SGShape2DInternal::ShapeType;
+typedef bool (*SGShapeOverlapFunction)(const SGShape2DInternal &p_shape1, const SGShape2DInternal &p_shape2, fixed p_margin, SGCollisionDetector2DInternal::OverlapInfo *p_info);
 
-	ShapeType shape1_type = p_shape1->get_shape_type();
-	ShapeType shape2_type = p_shape2->get_shape_type();
-
-	SGCollisionDetector2DInternal::OverlapInfo overlap_info;
-	SGCollisionDetector2DInternal::OverlapInfo *overlap_info_ptr = p_info ? &overlap_info : nullptr;
+struct SGShapeOverlapDispatch {
+	SGShapeOverlapFunction function;
+	// The detector takes the shapes in the opposite order, so they need to
+	// be swapped going in, and the result flipped coming out.
+	bool swap;
+};
 
-	bool overlapping = false;
-	bool swap = false;
+template <class T1, class T2, bool (*F)(const T1 &, const T2 &, fixed, SGCollisionDetector2DInternal::OverlapInfo *)>
+static bool sg_shape_overlap(const SGShape2DInternal &p_shape1, const SGShape2DInternal &p_shape2, fixed p_margin, SGCollisionDetector2DInternal::OverlapInfo *p_info) {
+	return F(static_cast<const T1 &>(p_shape1), static_cast<const T2 &>(p_shape2), p_margin, p_info);
+}
 
-	if (shape1_type == ShapeType::SHAPE_RECTANGLE && shape2_type == ShapeType::SHAPE_RECTANGLE) {
-		overlapping = SGCollisionDetector2DInternal::Rectangle_overlaps_Rectangle(*((SGRectangle2DInternal *)p_shape1), *((SGRectangle2DInternal *)p_shape2), p_margin, overlap_info_ptr);
-	}
-	else if (shape1_type == ShapeType::SHAPE_CIRCLE && shape2_type == ShapeType::SHAPE_CIRCLE) {
-		overlapping = SGCollisionDetector2DInternal::Circle_overlaps_Circle(*((SGCircle2DInternal *)p_shape1), *((SGCircle2DInternal *)p_shape2), p_margin, overlap_info_ptr);
-	}
-	else if (shape1_type == ShapeType::SHAPE_CIRCLE && shape2_type == ShapeType::SHAPE_RECTANGLE) {
-		overlapping = SGCollisionDetector2DInternal::Circle_overlaps_Rectangle(*((SGCircle2DInternal *)p_shape1), *((SGRectangle2DInternal *)p_shape2), p_margin, overlap_info_ptr);
-	}
-	else if (shape1_type == ShapeType::SHAPE_RECTANGLE && shape2_type == ShapeType::SHAPE_CIRCLE) {
-		overlapping = SGCollisionDetector2DInternal::Circle_overlaps_Rectangle(*((SGCircle2DInternal *)p_shape2), *((SGRectangle2DInternal *)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
-	}
-	else if (shape1_type == ShapeType::SHAPE_POLYGON && shape2_type == ShapeType::SHAPE_POLYGON) {
-		overlapping = SGCollisionDetector2DInternal::Polygon_overlaps_Polygon(*((SGPolygon2DInternal *)p_shape1), *((SGPolygon2DInternal *)p_shape2), p_margin, overlap_info_ptr);
-	}
-	else if (shape1_type == ShapeType::SHAPE_POLYGON && shape2_type == ShapeType::SHAPE_CIRCLE) {
-		overlapping = SGCollisionDetector2DInternal::Polygon_overlaps_Circle(*((SGPolygon2DInternal *)p_shape1), *((SGCircle2DInternal *)p_shape2), p_margin, overlap_info_ptr);
-	}
-	else if (shape1_type == ShapeType::SHAPE_CIRCLE && shape2_type == ShapeType::SHAPE_POLYGON) {
-		overlapping = SGCollisionDetector2DInternal::Polygon_overlaps_Circle(*((SGPolygon2DInternal *)p_shape2), *((SGCircle2DInternal *)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
-	}
-	else if (shape1_type == ShapeType::SHAPE_POLYGON && shape2_type == ShapeType::SHAPE_RECTANGLE) {
-		overlapping = SGCollisionDetector2DInternal::Polygon_overlaps_Rectangle(*((SGPolygon2DInternal *)p_shape1), *((SGRectangle2DInternal *)p_shape2), p_margin, overlap_info_ptr);
+static bool sg_shape_overlap_gjk(const SGShape2DInternal &p_shape1, const SGShape2DInternal &p_shape2, fixed p_margin, SGCollisionDetector2DInternal::OverlapInfo *p_info) {
+	// Like with SAT, polygons need at least 3 points to collide with anything.
+	if ((p_shape1.get_shape_type() == SGShape2DInternal::SHAPE_POLYGON && static_cast<const SGPolygon2DInternal &>(p_shape1).get_points().size() < 3) ||
+			(p_shape2.get_shape_type() == SGShape2DInternal::SHAPE_POLYGON && static_cast<const SGPolygon2DInternal &>(p_shape2).get_points().size() < 3)) {
+		return false;
 	}
-	else if (shape1_type == ShapeType::SHAPE_RECTANGLE && shape2_type == ShapeType::SHAPE_POLYGON) {
-		overlapping = SGCollisionDetector2DInternal::Polygon_overlaps_Rectangle(*((SGPolygon2DInternal *)p_shape2), *((SGRectangle2DInternal *)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
+	return SGCollisionDetector2DInternal::GJK_overlaps(p_shape1, p_shape2, p_margin, p_info);
+}
+
+#define SG_SAT(m_type1, m_type2, m_function) \
+	{ &sg_shape_overlap<m_type1, m_type2, &SGCollisionDetector2DInternal::m_function>, false }
+#define SG_SAT_SWAPPED(m_type1, m_type2, m_function) \
+	{ &sg_shape_overlap<m_type1, m_type2, &SGCollisionDetector2DInternal::m_function>, true }
+#define SG_GJK \
+	{ &sg_shape_overlap_gjk, false }
+#define SG_NONE \
+	{ nullptr, false }
+
+// Indexed by [shape1_type][shape2_type]. Adding a shape type means adding a
+// row and a column to both tables. Grids are split into cells before they
+// get here, so they don't have any entries.
+static_assert(SGShape2DInternal::SHAPE_MAX == 5, "The shape overlap tables need updating for the new shape type");
+
+static const SGShapeOverlapDispatch sg_sat_overlap_table[SGShape2DInternal::SHAPE_MAX][SGShape2DInternal::SHAPE_MAX] = {
+	// SHAPE_RECTANGLE
+	{
+		SG_SAT(SGRectangle2DInternal, SGRectangle2DInternal, Rectangle_overlaps_Rectangle),
+		SG_SAT_SWAPPED(SGCircle2DInternal, SGRectangle2DInternal, Circle_overlaps_Rectangle),
+		SG_SAT_SWAPPED(SGPolygon2DInternal, SGRectangle2DInternal, Polygon_overlaps_Rectangle),
+		SG_SAT_SWAPPED(SGCapsule2DInternal, SGRectangle2DInternal, Capsule_overlaps_Rectangle),
+		SG_NONE,
+	},
+	// SHAPE_CIRCLE
+	{
+		SG_SAT(SGCircle2DInternal, SGRectangle2DInternal, Circle_overlaps_Rectangle),
+		SG_SAT(SGCircle2DInternal, SGCircle2DInternal, Circle_overlaps_Circle),
+		SG_SAT_SWAPPED(SGPolygon2DInternal, SGCircle2DInternal, Polygon_overlaps_Circle),
+		SG_SAT_SWAPPED(SGCapsule2DInternal, SGCircle2DInternal, Capsule_overlaps_Circle),
+		SG_NONE,
+	},
+	// SHAPE_POLYGON
+	{
+		SG_SAT(SGPolygon2DInternal, SGRectangle2DInternal, Polygon_overlaps_Rectangle),
+		SG_SAT(SGPolygon2DInternal, SGCircle2DInternal, Polygon_overlaps_Circle),
+		SG_SAT(SGPolygon2DInternal, SGPolygon2DInternal, Polygon_overlaps_Polygon),
+		SG_SAT_SWAPPED(SGCapsule2DInternal, SGPolygon2DInternal, Capsule_overlaps_Polygon),
+		SG_NONE,
+	},
+	// SHAPE_CAPSULE
+	{
+		SG_SAT(SGCapsule2DInternal, SGRectangle2DInternal, Capsule_overlaps_Rectangle),
+		SG_SAT(SGCapsule2DInternal, SGCircle2DInternal, Capsule_overlaps_Circle),
+		SG_SAT(SGCapsule2DInternal, SGPolygon2DInternal, Capsule_overlaps_Polygon),
+		SG_SAT(SGCapsule2DInternal, SGCapsule2DInternal, Capsule_overlaps_Capsule),
+		SG_NONE,
+	},
+	// SHAPE_GRID
+	{ SG_NONE, SG_NONE, SG_NONE, SG_NONE, SG_NONE },
+};
+
+// Circle-circle keeps its closed-form test, which is exact and cheaper.
+static const SGShapeOverlapDispatch sg_gjk_overlap_table[SGShape2DInternal::SHAPE_MAX][SGShape2DInternal::SHAPE_MAX] = {
+	{ SG_GJK, SG_GJK, SG_GJK, SG_GJK, SG_NONE },
+	{ SG_GJK, SG_SAT(SGCircle2DInternal, SGCircle2DInternal, Circle_overlaps_Circle), SG_GJK, SG_GJK, SG_NONE },
+	{ SG_GJK, SG_GJK, SG_GJK, SG_GJK, SG_NONE },
+	{ SG_GJK, SG_GJK, SG_GJK, SG_GJK, SG_NONE },
+	{ SG_NONE, SG_NONE, SG_NONE, SG_NONE, SG_NONE },
+};
+
+#undef SG_SAT
+#undef SG_SAT_SWAPPED
+#undef SG_GJK
+#undef SG_NONE
+
+_FORCE_INLINE_ static bool sg_is_concave_shape(const SGShape2DInternal *p_shape) {
+	return p_shape->get_shape_type() == SGShape2DInternal::SHAPE_POLYGON && static_cast<const SGPolygon2DInternal *>(p_shape)->is_concave();
+}
+
+_FORCE_INLINE_ static bool sg_is_grid_shape(const SGShape2DInternal *p_shape) {
+	return p_shape->get_shape_type() == SGShape2DInternal::SHAPE_GRID;
+}
+
+// Finds the lowest point of the other shape's bounds in the grid's space, at
+// the start of the motion its object is being tested with (if any).
+static fixed sg_get_grid_start_bottom(const SGGrid2DInternal *p_grid, const SGShape2DInternal *p_other) {
+	SGFixedRect2Internal bounds = p_other->get_bounds();
+	const SGCollisionObject2DInternal *owner = p_other->get_owner();
+	if (owner) {
+		bounds.position += owner->get_motion_origin() - owner->get_transform().get_origin();
 	}
-	else if (shape1_type == ShapeType::SHAPE_CAPSULE && shape2_type == ShapeType::SHAPE_CIRCLE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Circle(*((SGCapsule2DInternal*)p_shape1), *((SGCircle2DInternal*)p_shape2), p_margin, overlap_info_ptr);
+
+	SGFixedTransform2DInternal inverse = p_grid->get_global_transform().affine_inverse();
+	fixed bottom = inverse.xform(bounds.position).y;
+	bottom = MAX(bottom, inverse.xform(SGFixedVector2Internal(bounds.position.x + bounds.size.x, bounds.position.y)).y);
+	bottom = MAX(bottom, inverse.xform(SGFixedVector2Internal(bounds.position.x, bounds.position.y + bounds.size.y)).y);
+	bottom = MAX(bottom, inverse.xform(bounds.position + bounds.size).y);
+	return bottom;
+}
+
+// The rectangle used to test a grid's cells against other shapes. There's one
+// per thread, since queries can run on several threads at once, so that
+// testing a cell doesn't allocate a new shape.
+static SGRectangle2DInternal &sg_get_grid_cell_shape(const SGGrid2DInternal &p_grid) {
+	static thread_local SGRectangle2DInternal cell(fixed::ZERO, fixed::ZERO);
+	SGFixedVector2Internal cell_size = p_grid.get_cell_size();
+	cell.set_extents(SGFixedVector2Internal(fixed(cell_size.x.value / 2), fixed(cell_size.y.value / 2)));
+	return cell;
+}
+
+// Tests each solid cell of a grid that the other shape could touch as a
+// rectangle, keeping the overlap with the longest separation. A cell only
+// pushes the shape out towards an open neighbor, so that shapes don't catch
+// on the seams between cells, unless the shape is buried where there is no
+// open neighbor. One-way cells only collide with shapes that were above them
+// when the motion being tested started.
+static bool sg_grid_overlaps(const SGWorld2DInternal *p_world, const SGGrid2DInternal *p_grid, SGShape2DInternal *p_other, bool p_grid_first, const SGFixedRect2Internal &p_other_bounds, fixed p_margin, SGWorld2DInternal::ShapeOverlapInfo *p_info) {
+	int min_x, min_y, max_x, max_y;
+	if (!p_grid->get_cell_range(p_other_bounds, min_x, min_y, max_x, max_y)) {
+		return false;
 	}
-	else if (shape1_type == ShapeType::SHAPE_CIRCLE && shape2_type == ShapeType::SHAPE_CAPSULE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Circle(*((SGCapsule2DInternal*)p_shape2), *((SGCircle2DInternal*)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
+
+	SGFixedTransform2DInternal grid_transform = p_grid->get_global_transform();
+	SGFixedVector2Internal cell_size = p_grid->get_cell_size();
+	SGRectangle2DInternal &cell = sg_get_grid_cell_shape(*p_grid);
+
+	// The bottom of the other shape, in the grid's space, where it started.
+	bool have_start_bottom = false;
+	fixed start_bottom;
+
+	bool overlapping = false;
+	// Whether the best overlap so far pushes towards an open neighbor.
+	bool open = false;
+	fixed longest_separation;
+	SGWorld2DInternal::ShapeOverlapInfo best_info;
+
+	for (int y = min_y; y <= max_y; y++) {
+		for (int x = min_x; x <= max_x; x++) {
+			SGGrid2DInternal::CellType type = p_grid->get_cell(x, y);
+			if (type == SGGrid2DInternal::CELL_EMPTY) {
+				continue;
+			}
+
+			cell.set_transform(p_grid->get_cell_transform(x, y));
+			SGWorld2DInternal::ShapeOverlapInfo cell_info;
+			bool cell_overlapping = p_grid_first
+				? p_world->overlaps(&cell, p_other, p_margin, &cell_info)
+				: p_world->overlaps(p_other, &cell, p_margin, &cell_info);
+			if (!cell_overlapping) {
+				continue;
+			}
+
+			if (type == SGGrid2DInternal::CELL_ONE_WAY) {
+				if (!have_start_bottom) {
+					start_bottom = sg_get_grid_start_bottom(p_grid, p_other);
+					have_start_bottom = true;
+				}
+				// Allow for rounding in the inverse transform.
+				if (start_bottom > fixed(cell_size.y.value * y + 4)) {
+					continue;
+				}
+			}
+
+			// The direction the other shape would be pushed out of the cell.
+			SGFixedVector2Internal push = p_grid_first ? -cell_info.collision_normal : cell_info.collision_normal;
+
+			SGFixedVector2Internal local_push = grid_transform.basis_xform_inv(push);
+			bool blocked = local_push.x.abs() > local_push.y.abs()
+				? p_grid->get_cell(local_push.x > fixed::ZERO ? x + 1 : x - 1, y) == SGGrid2DInternal::CELL_SOLID
+				: p_grid->get_cell(x, local_push.y > fixed::ZERO ? y + 1 : y - 1) == SGGrid2DInternal::CELL_SOLID;
+			if (blocked && open) {
+				continue;
+			}
+			if (!blocked && !p_info) {
+				return true;
+			}
+
+			fixed separation_length = cell_info.separation.length();
+			if (!overlapping || (!blocked && !open) || separation_length > longest_separation) {
+				longest_separation = separation_length;
+				best_info = cell_info;
+			}
+			overlapping = true;
+			open = open || !blocked;
+		}
 	}
-	else if (shape1_type == ShapeType::SHAPE_CAPSULE && shape2_type == ShapeType::SHAPE_RECTANGLE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Rectangle(*((SGCapsule2DInternal*)p_shape1), *((SGRectangle2DInternal*)p_shape2), p_margin, overlap_info_ptr);
+
+	if (overlapping && p_info) {
+		*p_info = best_info;
 	}
-	else if (shape1_type == ShapeType::SHAPE_RECTANGLE && shape2_type == ShapeType::SHAPE_CAPSULE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Rectangle(*((SGCapsule2DInternal*)p_shape2), *((SGRectangle2DInternal*)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
+	return overlapping;
+}
+
+// Tests each convex part of a concave polygon against the other shape,
+// keeping the overlap with the longest separation, like with the shapes of
+// two objects.
+class SGConcavePartOverlapResultHandler : public SGResultHandlerInternal {
+private:
+
+	const SGWorld2DInternal *world;
+	SGShape2DInternal *other;
+	bool concave_first;
+	fixed margin;
+	SGWorld2DInternal::ShapeOverlapInfo *info;
+	bool overlapping;
+	fixed longest_separation;
+
+public:
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_part) {
+		if (overlapping && !info) {
+			return;
+		}
+
+		SGWorld2DInternal::ShapeOverlapInfo part_info;
+		bool part_overlapping = concave_first
+			? world->overlaps(p_part, other, margin, info ? &part_info : nullptr)
+			: world->overlaps(other, p_part, margin, info ? &part_info : nullptr);
+		if (!part_overlapping) {
+			return;
+		}
+
+		if (info) {
+			fixed separation_length = part_info.separation.length();
+			if (!overlapping || separation_length > longest_separation) {
+				longest_separation = separation_length;
+				*info = part_info;
+			}
+		}
+		overlapping = true;
 	}
-	else if (shape1_type == ShapeType::SHAPE_CAPSULE && shape2_type == ShapeType::SHAPE_POLYGON) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Polygon(*((SGCapsule2DInternal*)p_shape1), *((SGPolygon2DInternal*)p_shape2), p_margin, overlap_info_ptr);
+
+	_FORCE_INLINE_ bool is_overlapping() const { return overlapping; }
+
+	_FORCE_INLINE_ SGConcavePartOverlapResultHandler(const SGWorld2DInternal *p_world, SGShape2DInternal *p_other, bool p_concave_first, fixed p_margin, SGWorld2DInternal::ShapeOverlapInfo *p_info)
+		: world(p_world), other(p_other), concave_first(p_concave_first), margin(p_margin), info(p_info), overlapping(false) { }
+};
+
+bool SGWorld2DInternal::overlaps(SGShape2DInternal *p_shape1, SGShape2DInternal *p_shape2, fixed p_margin, SGWorld2DInternal::ShapeOverlapInfo *p_info) const {
+	// Skip the narrowphase for shapes whose bounds are apart. The margin grows
+	// both shapes, the same as in the narrowphase.
+	SGFixedRect2Internal bounds1 = p_shape1->get_bounds();
+	SGFixedRect2Internal bounds2 = p_shape2->get_bounds();
+	if (p_margin > fixed::ZERO) {
+		bounds1.grow_by(p_margin);
+		bounds2.grow_by(p_margin);
 	}
-	else if (shape1_type == ShapeType::SHAPE_POLYGON && shape2_type == ShapeType::SHAPE_CAPSULE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Polygon(*((SGCapsule2DInternal*)p_shape2), *((SGPolygon2DInternal*)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
+	if (!bounds1.intersects(bounds2)) {
+		return false;
 	}
-	else if (shape1_type == ShapeType::SHAPE_CAPSULE && shape2_type == ShapeType::SHAPE_CAPSULE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Capsule(*((SGCapsule2DInternal*)p_shape1), *((SGCapsule2DInternal*)p_shape2), p_margin, overlap_info_ptr);
+
+	// Concave polygons are tested one convex part at a time.
+	if (sg_is_concave_shape(p_shape1) || sg_is_concave_shape(p_shape2)) {
+		bool concave_first = sg_is_concave_shape(p_shape1);
+		SGPolygon2DInternal *concave = static_cast<SGPolygon2DInternal *>(concave_first ? p_shape1 : p_shape2);
+		SGFixedRect2Internal other_bounds = concave_first ? bounds2 : bounds1;
+		other_bounds.grow_by(p_margin);
+
+		SGConcavePartOverlapResultHandler result_handler(this, concave_first ? p_shape2 : p_shape1, concave_first, p_margin, p_info);
+		concave->find_parts(other_bounds, &result_handler);
+		if (result_handler.is_overlapping() && p_info) {
+			p_info->shape = p_shape2;
+		}
+		return result_handler.is_overlapping();
 	}
-	else if (shape1_type == ShapeType::SHAPE_CAPSULE && shape2_type == ShapeType::SHAPE_CAPSULE) {
-		overlapping = SGCollisionDetector2DInternal::Capsule_overlaps_Capsule(*((SGCapsule2DInternal*)p_shape2), *((SGCapsule2DInternal*)p_shape1), p_margin, overlap_info_ptr);
-		swap = true;
+
+	// Grids are tested one cell at a time, and don't collide with each other.
+	if (sg_is_grid_shape(p_shape1) || sg_is_grid_shape(p_shape2)) {
+		if (sg_is_grid_shape(p_shape1) && sg_is_grid_shape(p_shape2)) {
+			return false;
+		}
+		bool grid_first = sg_is_grid_shape(p_shape1);
+		SGFixedRect2Internal other_bounds = grid_first ? bounds2 : bounds1;
+		other_bounds.grow_by(p_margin);
+
+		bool overlapping = sg_grid_overlaps(this, static_cast<SGGrid2DInternal *>(grid_first ? p_shape1 : p_shape2), grid_first ? p_shape2 : p_shape1, grid_first, other_bounds, p_margin, p_info);
+		if (overlapping && p_info) {
+			p_info->shape = p_shape2;
+		}
+		return overlapping;
 	}
 
+	const SGShapeOverlapDispatch &dispatch = (narrowphase_type == NARROWPHASE_GJK ? sg_gjk_overlap_table : sg_sat_overlap_table)[p_shape1->get_shape_type()][p_shape2->get_shape_type()];
+
+	SGCollisionDetector2DInternal::OverlapInfo overlap_info;
+	SGCollisionDetector2DInternal::OverlapInfo *overlap_info_ptr = p_info ? &overlap_info : nullptr;
+
+	bool swap = dispatch.swap;
+	bool overlapping = swap
+		? dispatch.function(*p_shape2, *p_shape1, p_margin, overlap_info_ptr)
+		: dispatch.function(*p_shape1, *p_shape2, p_margin, overlap_info_ptr);
+
 	if (overlapping && p_info) {
 		// Make sure the info is from the perspective of the first shape.
 		p_info->shape = p_shape2;
@@ -178,10 +427,7 @@ public:
 			return;
 		}
 
-		if (!object->test_collision_layers(p_object)) {
-			return;
-		}
-
+		// The broadphase has already checked the collision layers.
 		SGWorld2DInternal::BodyOverlapInfo overlap_info;
 
 		if (world->overlaps(object, p_object, fixed::ZERO, &overlap_info)) {
@@ -196,12 +442,494 @@ public:
 
 void SGWorld2DInternal::get_overlapping_areas(SGCollisionObject2DInternal *p_object, SGResultHandlerInternal *p_result_handler) const {
 	SGOverlappingResultHandler overlapping_handler(this, p_object, p_result_handler);
-	broadphase->find_nearby(p_object->get_bounds(), &overlapping_handler, SGCollisionObject2DInternal::OBJECT_AREA);
+	_find_nearby(p_object->get_bounds(), &overlapping_handler, SGCollisionObject2DInternal::OBJECT_AREA, p_object->get_collision_layer(), p_object->get_collision_mask());
 }
 
 void SGWorld2DInternal::get_overlapping_bodies(SGCollisionObject2DInternal *p_object, SGResultHandlerInternal *p_result_handler) const {
 	SGOverlappingResultHandler overlapping_handler(this, p_object, p_result_handler);
-	broadphase->find_nearby(p_object->get_bounds(), &overlapping_handler, SGCollisionObject2DInternal::OBJECT_BODY);
+	_find_nearby(p_object->get_bounds(), &overlapping_handler, SGCollisionObject2DInternal::OBJECT_BODY, p_object->get_collision_layer(), p_object->get_collision_mask());
+}
+
+int SGWorld2DInternal::tune_broadphase_cell_size() {
+	if (broadphase->get_broadphase_type() != SGBroadphase2DInternal::BROADPHASE_SPATIAL_HASH) {
+		return broadphase->get_cell_size();
+	}
+	int cell_size = ((SGSpatialHashBroadphase2DInternal *)broadphase)->find_best_cell_size();
+	broadphase->set_cell_size(cell_size);
+	return cell_size;
+}
+
+void SGWorld2DInternal::reset_broadphase_statistics() {
+	broadphase->reset_query_statistics();
+	static_broadphase->reset_query_statistics();
+}
+
+void SGWorld2DInternal::prepare_for_concurrent_queries() {
+	update_overlaps();
+	static_broadphase->prepare_for_queries();
+	for (SGBody2DInternal *body : bodies) {
+		for (SGShape2DInternal *shape : body->get_shapes()) {
+			shape->update_global_cache();
+		}
+	}
+	for (SGArea2DInternal *area : areas) {
+		for (SGShape2DInternal *shape : area->get_shapes()) {
+			shape->update_global_cache();
+		}
+	}
+	concurrent_queries_prepared = true;
+}
+
+class SGCachedOverlapResultHandler : public SGResultHandlerInternal {
+private:
+
+	std::vector<SGArea2DInternal::CachedOverlap> &result;
+
+public:
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_shape) {
+		result.push_back(SGArea2DInternal::CachedOverlap(p_object, p_shape));
+	}
+
+	_FORCE_INLINE_ SGCachedOverlapResultHandler(std::vector<SGArea2DInternal::CachedOverlap> &p_result)
+		: result(p_result) { }
+
+};
+
+// Finds the tracked areas that overlap an object. This is the same test as
+// SGOverlappingResultHandler, just from the other side, so that the area is
+// always the first object passed to overlaps().
+class SGTrackedAreaResultHandler : public SGResultHandlerInternal {
+private:
+
+	const SGWorld2DInternal *world;
+	SGCollisionObject2DInternal *object;
+	std::vector<SGArea2DInternal::CachedOverlap> &result;
+
+public:
+
+	void handle_result(SGCollisionObject2DInternal *p_area, SGShape2DInternal *p_shape) {
+		SGArea2DInternal *area = (SGArea2DInternal *)p_area;
+		if (area == object || !area->is_tracking_overlaps() || area->is_overlaps_dirty()) {
+			return;
+		}
+
+		if (!area->test_collision_layers(object)) {
+			return;
+		}
+
+		SGWorld2DInternal::BodyOverlapInfo overlap_info;
+
+		if (world->overlaps(area, object, fixed::ZERO, &overlap_info)) {
+			result.push_back(SGArea2DInternal::CachedOverlap(area, overlap_info.collider_shape));
+		}
+	}
+
+	_FORCE_INLINE_ SGTrackedAreaResultHandler(const SGWorld2DInternal *p_world, SGCollisionObject2DInternal *p_object, std::vector<SGArea2DInternal::CachedOverlap> &p_result)
+		: world(p_world), object(p_object), result(p_result) { }
+
+};
+
+static int sg_find_cached_overlap(const std::vector<SGArea2DInternal::CachedOverlap> &p_overlaps, const SGCollisionObject2DInternal *p_object) {
+	for (std::size_t i = 0; i < p_overlaps.size(); i++) {
+		if (p_overlaps[i].object == p_object) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void sg_remove_cached_overlap(std::vector<SGArea2DInternal::CachedOverlap> &p_overlaps, const SGCollisionObject2DInternal *p_object) {
+	int index = sg_find_cached_overlap(p_overlaps, p_object);
+	if (index != -1) {
+		p_overlaps[index] = p_overlaps.back();
+		p_overlaps.pop_back();
+	}
+}
+
+void SGWorld2DInternal::set_narrowphase_type(NarrowphaseType p_narrowphase_type) {
+	if (narrowphase_type == p_narrowphase_type) {
+		return;
+	}
+	narrowphase_type = p_narrowphase_type;
+
+	// The cached overlaps may not be the same anymore.
+	for (SGArea2DInternal *area : areas) {
+		mark_overlaps_dirty(area);
+	}
+	for (SGBody2DInternal *body : bodies) {
+		mark_overlaps_dirty(body);
+	}
+}
+
+void SGWorld2DInternal::mark_overlaps_dirty(SGCollisionObject2DInternal *p_object) {
+	concurrent_queries_prepared = false;
+	// Nothing is cached, so there's nothing to keep up-to-date.
+	if (tracked_areas.size() == 0 || p_object->overlaps_dirty) {
+		return;
+	}
+	p_object->overlaps_dirty = true;
+	overlaps_dirty_objects.push_back(p_object);
+}
+
+void SGWorld2DInternal::_track_overlaps(SGArea2DInternal *p_area) {
+	if (p_area->overlaps_tracked) {
+		return;
+	}
+	p_area->overlaps_tracked = true;
+	tracked_areas.push_back(p_area);
+
+	// This will compute its overlaps from scratch.
+	mark_overlaps_dirty(p_area);
+}
+
+void SGWorld2DInternal::_remove_from_overlaps(SGCollisionObject2DInternal *p_object) {
+	concurrent_queries_prepared = false;
+	if (p_object->overlaps_dirty) {
+		sg_remove_by_value(overlaps_dirty_objects, p_object);
+		p_object->overlaps_dirty = false;
+	}
+
+	for (SGArea2DInternal *area : p_object->overlap_monitors) {
+		sg_remove_cached_overlap(area->cached_overlaps, p_object);
+	}
+	p_object->overlap_monitors.clear();
+
+	if (p_object->get_object_type() == SGCollisionObject2DInternal::OBJECT_AREA) {
+		SGArea2DInternal *area = (SGArea2DInternal *)p_object;
+		if (area->overlaps_tracked) {
+			for (const SGArea2DInternal::CachedOverlap &overlap : area->cached_overlaps) {
+				sg_remove_by_value(overlap.object->overlap_monitors, area);
+			}
+			area->cached_overlaps.clear();
+			area->overlaps_tracked = false;
+			sg_remove_by_value(tracked_areas, area);
+		}
+	}
+
+	for (std::size_t i = 0; i < overlap_events.size(); ) {
+		if (overlap_events[i].area == p_object || overlap_events[i].object == p_object) {
+			overlap_events.erase(overlap_events.begin() + i);
+		}
+		else {
+			i++;
+		}
+	}
+
+	if (tracked_areas.size() == 0) {
+		for (SGCollisionObject2DInternal *object : overlaps_dirty_objects) {
+			object->overlaps_dirty = false;
+		}
+		overlaps_dirty_objects.clear();
+	}
+}
+
+void SGWorld2DInternal::_update_object_overlaps(SGCollisionObject2DInternal *p_object) {
+	// Update this object's overlaps with tracked areas that haven't changed.
+	// Those that have changed get recomputed from scratch in _update_area_overlaps().
+	std::vector<SGArea2DInternal::CachedOverlap> &new_overlaps = overlaps_scratch;
+	new_overlaps.clear();
+
+	// Objects outside of the broadphase can't be found by any queries.
+	if (p_object->broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
+		SGTrackedAreaResultHandler result_handler(this, p_object, new_overlaps);
+		_find_nearby(p_object->get_bounds(), &result_handler, SGCollisionObject2DInternal::OBJECT_AREA, p_object->get_collision_layer(), p_object->get_collision_mask());
+
+		if (unindexed_areas_scratch.size() > 0) {
+			SGFixedRect2Internal bounds = p_object->get_bounds();
+			for (SGArea2DInternal *area : unindexed_areas_scratch) {
+				if (area->get_bounds().intersects(bounds)) {
+					result_handler.handle_result(area, nullptr);
+				}
+			}
+		}
+	}
+
+	std::vector<SGArea2DInternal *> &monitors = p_object->overlap_monitors;
+	for (std::size_t i = 0; i < monitors.size(); ) {
+		SGArea2DInternal *area = monitors[i];
+		if (area->overlaps_dirty || sg_find_cached_overlap(new_overlaps, area) != -1) {
+			i++;
+			continue;
+		}
+		sg_remove_cached_overlap(area->cached_overlaps, p_object);
+		monitors[i] = monitors.back();
+		monitors.pop_back();
+		_push_overlap_event(area, p_object, false);
+	}
+
+	for (const SGArea2DInternal::CachedOverlap &overlap : new_overlaps) {
+		SGArea2DInternal *area = (SGArea2DInternal *)overlap.object;
+		int index = sg_find_cached_overlap(area->cached_overlaps, p_object);
+		if (index != -1) {
+			area->cached_overlaps[index].shape = overlap.shape;
+		}
+		else {
+			area->cached_overlaps.push_back(SGArea2DInternal::CachedOverlap(p_object, overlap.shape));
+			monitors.push_back(area);
+			_push_overlap_event(area, p_object, true);
+		}
+	}
+}
+
+void SGWorld2DInternal::_update_area_overlaps(SGArea2DInternal *p_area) {
+	std::vector<SGArea2DInternal::CachedOverlap> &new_overlaps = overlaps_scratch;
+	new_overlaps.clear();
+
+	SGCachedOverlapResultHandler cached_handler(new_overlaps);
+	SGOverlappingResultHandler overlapping_handler(this, p_area, &cached_handler);
+	_find_nearby(p_area->get_bounds(), &overlapping_handler, SGCollisionObject2DInternal::OBJECT_BOTH, p_area->get_collision_layer(), p_area->get_collision_mask());
+
+	for (const SGArea2DInternal::CachedOverlap &overlap : p_area->cached_overlaps) {
+		if (sg_find_cached_overlap(new_overlaps, overlap.object) == -1) {
+			sg_remove_by_value(overlap.object->overlap_monitors, p_area);
+			_push_overlap_event(p_area, overlap.object, false);
+		}
+	}
+
+	for (const SGArea2DInternal::CachedOverlap &overlap : new_overlaps) {
+		if (sg_find_cached_overlap(p_area->cached_overlaps, overlap.object) == -1) {
+			overlap.object->overlap_monitors.push_back(p_area);
+			_push_overlap_event(p_area, overlap.object, true);
+		}
+	}
+
+	// Swap rather than copy, so both vectors keep their capacity.
+	p_area->cached_overlaps.swap(new_overlaps);
+}
+
+void SGWorld2DInternal::update_overlaps() {
+	if (overlaps_dirty_objects.size() == 0) {
+		return;
+	}
+
+	// Tracked areas that aren't in the broadphase (for example, because
+	// they aren't monitorable) need to be checked by brute force.
+	unindexed_areas_scratch.clear();
+	for (SGArea2DInternal *area : tracked_areas) {
+		if (area->broadphase_element == SGBroadphase2DInternal::NULL_ELEMENT && !area->overlaps_dirty) {
+			unindexed_areas_scratch.push_back(area);
+		}
+	}
+
+	for (SGCollisionObject2DInternal *object : overlaps_dirty_objects) {
+		_update_object_overlaps(object);
+	}
+
+	for (SGCollisionObject2DInternal *object : overlaps_dirty_objects) {
+		if (object->get_object_type() == SGCollisionObject2DInternal::OBJECT_AREA && ((SGArea2DInternal *)object)->overlaps_tracked) {
+			_update_area_overlaps((SGArea2DInternal *)object);
+		}
+	}
+
+	for (SGCollisionObject2DInternal *object : overlaps_dirty_objects) {
+		object->overlaps_dirty = false;
+	}
+	overlaps_dirty_objects.clear();
+}
+
+void SGWorld2DInternal::get_cached_overlapping_areas(SGArea2DInternal *p_area, SGResultHandlerInternal *p_result_handler) {
+	if (concurrent_queries_prepared && !p_area->overlaps_tracked) {
+		// Starting to track the area would change the world, which other
+		// threads may be querying.
+		get_overlapping_areas(p_area, p_result_handler);
+		return;
+	}
+	_track_overlaps(p_area);
+	update_overlaps();
+
+	for (const SGArea2DInternal::CachedOverlap &overlap : p_area->cached_overlaps) {
+		if (overlap.object->get_object_type() == SGCollisionObject2DInternal::OBJECT_AREA) {
+			p_result_handler->handle_result(overlap.object, overlap.shape);
+		}
+	}
+}
+
+void SGWorld2DInternal::get_cached_overlapping_bodies(SGArea2DInternal *p_area, SGResultHandlerInternal *p_result_handler) {
+	if (concurrent_queries_prepared && !p_area->overlaps_tracked) {
+		// Starting to track the area would change the world, which other
+		// threads may be querying.
+		get_overlapping_bodies(p_area, p_result_handler);
+		return;
+	}
+	_track_overlaps(p_area);
+	update_overlaps();
+
+	for (const SGArea2DInternal::CachedOverlap &overlap : p_area->cached_overlaps) {
+		if (overlap.object->get_object_type() == SGCollisionObject2DInternal::OBJECT_BODY) {
+			p_result_handler->handle_result(overlap.object, overlap.shape);
+		}
+	}
+}
+
+void SGWorld2DInternal::take_overlap_events(std::vector<OverlapEvent> &r_events) {
+	overlap_events_enabled = true;
+	update_overlaps();
+
+	r_events.clear();
+	r_events.swap(overlap_events);
+}
+
+void SGWorld2DInternal::mark_state_hash_dirty(SGCollisionObject2DInternal *p_object) {
+	if (p_object->state_hash_dirty) {
+		return;
+	}
+	p_object->state_hash_dirty = true;
+	state_hash_dirty_objects.push_back(p_object);
+}
+
+void SGWorld2DInternal::_remove_from_state_hash(SGCollisionObject2DInternal *p_object) {
+	if (p_object->state_hash_dirty) {
+		sg_remove_by_value(state_hash_dirty_objects, p_object);
+		p_object->state_hash_dirty = false;
+	}
+	state_hash -= p_object->state_hash;
+	p_object->state_hash = 0;
+}
+
+uint64_t SGWorld2DInternal::get_state_hash() {
+	for (SGCollisionObject2DInternal *object : state_hash_dirty_objects) {
+		uint64_t hash = object->_compute_state_hash();
+		state_hash += hash - object->state_hash;
+		object->state_hash = hash;
+		object->state_hash_dirty = false;
+	}
+	state_hash_dirty_objects.clear();
+	// The cell size changes the order queries find objects in, so peers
+	// need to agree on it too.
+	return state_hash + sg_hash_mix((uint64_t)broadphase->get_cell_size());
+}
+
+// The snapshot starts with the number of areas, the number of bodies and the
+// broadphase's cell size. Then each object is stored as its transform,
+// collision layer, collision mask, whether it's in the broadphase, number of
+// shapes and then the transform of each shape.
+static const int SG_SNAPSHOT_TRANSFORM_SIZE = 6;
+static const int SG_SNAPSHOT_OBJECT_SIZE = SG_SNAPSHOT_TRANSFORM_SIZE + 4;
+static const int SG_SNAPSHOT_HEADER_SIZE = 3;
+
+static void sg_save_transform(std::vector<int64_t> &r_snapshot, const SGFixedTransform2DInternal &p_transform) {
+	for (int i = 0; i < 3; i++) {
+		r_snapshot.push_back(p_transform.elements[i].x.value);
+		r_snapshot.push_back(p_transform.elements[i].y.value);
+	}
+}
+
+static SGFixedTransform2DInternal sg_load_transform(const int64_t *p_snapshot) {
+	SGFixedTransform2DInternal transform;
+	for (int i = 0; i < 3; i++) {
+		transform.elements[i].x = fixed(p_snapshot[i * 2]);
+		transform.elements[i].y = fixed(p_snapshot[i * 2 + 1]);
+	}
+	return transform;
+}
+
+// Returns the size of the object's data, or 0 if it doesn't match the object.
+static std::size_t sg_check_object(const int64_t *p_snapshot, std::size_t p_size, const SGCollisionObject2DInternal *p_object) {
+	if (p_size < SG_SNAPSHOT_OBJECT_SIZE) {
+		return 0;
+	}
+	int64_t shape_count = p_snapshot[SG_SNAPSHOT_OBJECT_SIZE - 1];
+	if (shape_count != (int64_t)p_object->get_shapes().size()) {
+		return 0;
+	}
+	std::size_t size = SG_SNAPSHOT_OBJECT_SIZE + shape_count * SG_SNAPSHOT_TRANSFORM_SIZE;
+	return size <= p_size ? size : 0;
+}
+
+void SGWorld2DInternal::_save_object_snapshot(std::vector<int64_t> &r_snapshot, const SGCollisionObject2DInternal *p_object) const {
+	sg_save_transform(r_snapshot, p_object->transform);
+	r_snapshot.push_back(p_object->collision_layer);
+	r_snapshot.push_back(p_object->collision_mask);
+	r_snapshot.push_back(p_object->broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT);
+	r_snapshot.push_back(p_object->shapes.size());
+	for (const SGShape2DInternal *shape : p_object->shapes) {
+		sg_save_transform(r_snapshot, shape->get_transform());
+	}
+}
+
+void SGWorld2DInternal::save_snapshot(std::vector<int64_t> &r_snapshot) const {
+	r_snapshot.clear();
+	r_snapshot.push_back(areas.size());
+	r_snapshot.push_back(bodies.size());
+	r_snapshot.push_back(broadphase->get_cell_size());
+	for (const SGArea2DInternal *area : areas) {
+		_save_object_snapshot(r_snapshot, area);
+	}
+	for (const SGBody2DInternal *body : bodies) {
+		_save_object_snapshot(r_snapshot, body);
+	}
+}
+
+bool SGWorld2DInternal::load_snapshot(const int64_t *p_snapshot, std::size_t p_size) {
+	if (p_size < SG_SNAPSHOT_HEADER_SIZE || p_snapshot[0] != (int64_t)areas.size() || p_snapshot[1] != (int64_t)bodies.size()) {
+		return false;
+	}
+	// Broadphases without cells save a cell size of 0.
+	int64_t cell_size = p_snapshot[2];
+	if (cell_size != broadphase->get_cell_size() && (cell_size <= 0 || cell_size > INT32_MAX || broadphase->get_cell_size() == 0)) {
+		return false;
+	}
+
+	std::vector<SGCollisionObject2DInternal *> objects;
+	objects.reserve(areas.size() + bodies.size());
+	objects.insert(objects.end(), areas.begin(), areas.end());
+	objects.insert(objects.end(), bodies.begin(), bodies.end());
+
+	// Make sure the whole snapshot matches before changing anything.
+	std::size_t offset = SG_SNAPSHOT_HEADER_SIZE;
+	for (SGCollisionObject2DInternal *object : objects) {
+		std::size_t size = sg_check_object(p_snapshot + offset, p_size - offset, object);
+		if (size == 0) {
+			return false;
+		}
+		offset += size;
+	}
+	if (offset != p_size) {
+		return false;
+	}
+
+	offset = SG_SNAPSHOT_HEADER_SIZE;
+	for (SGCollisionObject2DInternal *object : objects) {
+		const int64_t *data = p_snapshot + offset;
+		std::size_t shape_count = object->get_shapes().size();
+
+		shape_transforms_scratch.resize(shape_count);
+		for (std::size_t i = 0; i < shape_count; i++) {
+			shape_transforms_scratch[i] = sg_load_transform(data + SG_SNAPSHOT_OBJECT_SIZE + i * SG_SNAPSHOT_TRANSFORM_SIZE);
+		}
+		object->_restore_transforms(sg_load_transform(data), shape_transforms_scratch.data());
+		object->collision_layer = (uint32_t)data[SG_SNAPSHOT_TRANSFORM_SIZE];
+		object->collision_mask = (uint32_t)data[SG_SNAPSHOT_TRANSFORM_SIZE + 1];
+
+		// Objects only get a broadphase element once they're first moved, so
+		// this can differ too.
+		bool has_element = data[SG_SNAPSHOT_TRANSFORM_SIZE + 2] != 0 && object->monitorable;
+		if (has_element && object->broadphase_element == SGBroadphase2DInternal::NULL_ELEMENT) {
+			object->broadphase_element = object->broadphase->create_element(object);
+		}
+		else if (!has_element && object->broadphase_element != SGBroadphase2DInternal::NULL_ELEMENT) {
+			object->broadphase->delete_element(object->broadphase_element);
+			object->broadphase_element = SGBroadphase2DInternal::NULL_ELEMENT;
+		}
+		else if (has_element) {
+			object->broadphase->update_element_filter(object->broadphase_element);
+			// Static bodies are left where they are, unless they've moved.
+			if (object->broadphase == static_broadphase) {
+				static_broadphase->update_element(object->broadphase_element);
+			}
+		}
+
+		object->_mark_changed();
+		offset += SG_SNAPSHOT_OBJECT_SIZE + shape_count * SG_SNAPSHOT_TRANSFORM_SIZE;
+	}
+
+	if (cell_size != broadphase->get_cell_size()) {
+		broadphase->set_cell_size(cell_size);
+	}
+	broadphase->rebuild();
+
+	return true;
 }
 
 class SGBestOverlappingResultHandler : public SGResultHandlerInternal {
@@ -225,10 +953,6 @@ public:
 		}
 
 		SGBody2DInternal *other = (SGBody2DInternal *)p_object;
-		if (!object->test_collision_layers(other)) {
-			return;
-		}
-
 		if (world->overlaps(object, other, margin, &test_overlap_info)) {
 			overlapping = true;
 
@@ -261,7 +985,7 @@ bool SGWorld2DInternal::get_best_overlapping_body(SGBody2DInternal *p_body, bool
 	bounds.grow_by(safe_margin);
 
 	SGBestOverlappingResultHandler result_handler(this, p_body, safe_margin, p_info, compare_callback);
-	broadphase->find_nearby(bounds, &result_handler, SGCollisionObject2DInternal::OBJECT_BODY);
+	_find_nearby(bounds, &result_handler, SGCollisionObject2DInternal::OBJECT_BODY, p_body->get_collision_layer(), p_body->get_collision_mask());
 	return result_handler.is_overlapping();
 }
 
@@ -291,6 +1015,324 @@ bool SGWorld2DInternal::unstuck_body(SGBody2DInternal *p_body, int p_max_attempt
 	return stuck;
 }
 
+class SGSweepCandidatesResultHandler : public SGResultHandlerInternal {
+private:
+
+	SGCollisionObject2DInternal *object;
+	std::vector<SGCollisionObject2DInternal *> &result;
+
+public:
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_shape) {
+		if (object != p_object) {
+			result.push_back(p_object);
+		}
+	}
+
+	_FORCE_INLINE_ SGSweepCandidatesResultHandler(SGCollisionObject2DInternal *p_object, std::vector<SGCollisionObject2DInternal *> &p_result)
+		: object(p_object), result(p_result) { }
+
+};
+
+struct SGCollisionObjectCompare {
+	SGWorld2DInternal::CompareCallback compare;
+
+	_FORCE_INLINE_ bool operator()(const SGCollisionObject2DInternal *p_a, const SGCollisionObject2DInternal *p_b) const {
+		return compare(p_a, p_b);
+	}
+};
+
+bool SGWorld2DInternal::_overlaps_at(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedTransform2DInternal &p_from, const SGFixedVector2Internal &p_linear_velocity, fixed p_time) const {
+	SGFixedTransform2DInternal test_transform = p_from;
+	test_transform.set_origin(p_from.get_origin() + (p_linear_velocity * p_time));
+	p_body->_set_transform_silently(test_transform);
+	return overlaps(p_body, p_other, fixed::ZERO);
+}
+
+_FORCE_INLINE_ static bool sg_is_curved_shape(const SGShape2DInternal &p_shape) {
+	return p_shape.get_shape_type() == SGShape2DInternal::SHAPE_CIRCLE || p_shape.get_shape_type() == SGShape2DInternal::SHAPE_CAPSULE;
+}
+
+// For circles this is the center, for capsules the ends of the segment, and
+// for everything else, the vertices.
+_FORCE_INLINE_ static const SGFixedVector2Internal *sg_get_shape_points(const SGShape2DInternal &p_shape, SGFixedVector2Internal &r_center, std::size_t &r_count) {
+	if (p_shape.get_shape_type() == SGShape2DInternal::SHAPE_CIRCLE) {
+		r_center = p_shape.get_global_transform().get_origin();
+		r_count = 1;
+		return &r_center;
+	}
+	const std::vector<SGFixedVector2Internal> &vertices = p_shape.get_global_vertices();
+	r_count = vertices.size();
+	return vertices.data();
+}
+
+static SGFixedVector2Internal sg_get_closest_shape_point(const SGShape2DInternal &p_shape, const SGFixedVector2Internal *p_points, std::size_t p_count, const SGFixedVector2Internal &p_to) {
+	if (p_shape.get_shape_type() == SGShape2DInternal::SHAPE_CAPSULE) {
+		return SGFixedVector2Internal::get_closest_point_to_segment_2d(p_to, p_points);
+	}
+	SGFixedVector2Internal closest = p_points[0];
+	fixed closest_distance = (closest - p_to).length_squared();
+	for (std::size_t i = 1; i < p_count; i++) {
+		fixed distance = (p_points[i] - p_to).length_squared();
+		if (distance < closest_distance) {
+			closest = p_points[i];
+			closest_distance = distance;
+		}
+	}
+	return closest;
+}
+
+// Narrows down [r_enter, r_exit] to the times when the projections of the
+// shapes (where they are at p_time) onto p_axis would overlap, while moving
+// along p_linear_velocity. Returns false if they never would.
+static bool sg_sweep_on_axis(const SGShape2DInternal &p_shape, const SGShape2DInternal &p_other, const SGFixedVector2Internal &p_axis, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed &r_enter, fixed &r_exit) {
+	SGCollisionDetector2DInternal::Interval interval = SGCollisionDetector2DInternal::get_interval(p_shape, p_axis, fixed::ZERO);
+	SGCollisionDetector2DInternal::Interval other_interval = SGCollisionDetector2DInternal::get_interval(p_other, p_axis, fixed::ZERO);
+	fixed speed = p_axis.dot(p_linear_velocity);
+	if (speed == fixed::ZERO) {
+		return interval.min < other_interval.max && interval.max > other_interval.min;
+	}
+
+	fixed axis_enter;
+	fixed axis_exit;
+	if (speed > fixed::ZERO) {
+		axis_enter = p_time + (other_interval.min - interval.max) / speed;
+		axis_exit = p_time + (other_interval.max - interval.min) / speed;
+	}
+	else {
+		axis_enter = p_time + (other_interval.max - interval.min) / speed;
+		axis_exit = p_time + (other_interval.min - interval.max) / speed;
+	}
+	r_enter = MAX(r_enter, axis_enter);
+	r_exit = MIN(r_exit, axis_exit);
+	return r_enter < r_exit;
+}
+
+// Curves can separate along the axes between the closest points of the two
+// shapes, which change as they move, so sweep those like the SAT tests do.
+static bool sg_sweep_on_closest_point_axes(const SGShape2DInternal &p_curved, const SGShape2DInternal &p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed &r_enter, fixed &r_exit) {
+	if (p_curved.get_shape_type() == SGShape2DInternal::SHAPE_CAPSULE) {
+		// Capsule width axis
+		if (!sg_sweep_on_axis(p_curved, p_other, p_curved.get_global_transform().elements[0].normalized(), p_linear_velocity, p_time, r_enter, r_exit)) {
+			return false;
+		}
+	}
+
+	SGFixedVector2Internal center;
+	SGFixedVector2Internal other_center;
+	std::size_t count;
+	std::size_t other_count;
+	const SGFixedVector2Internal *points = sg_get_shape_points(p_curved, center, count);
+	const SGFixedVector2Internal *other_points = sg_get_shape_points(p_other, other_center, other_count);
+	if (count == 0 || other_count == 0) {
+		return true;
+	}
+	for (std::size_t i = 0; i < count; i++) {
+		SGFixedVector2Internal axis = points[i] - sg_get_closest_shape_point(p_other, other_points, other_count, points[i]);
+		if (axis != SGFixedVector2Internal::ZERO && !sg_sweep_on_axis(p_curved, p_other, axis.normalized(), p_linear_velocity, p_time, r_enter, r_exit)) {
+			return false;
+		}
+	}
+	for (std::size_t i = 0; i < other_count; i++) {
+		SGFixedVector2Internal axis = sg_get_closest_shape_point(p_curved, points, count, other_points[i]) - other_points[i];
+		if (axis != SGFixedVector2Internal::ZERO && !sg_sweep_on_axis(p_curved, p_other, axis.normalized(), p_linear_velocity, p_time, r_enter, r_exit)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Uses the separating axes of both shapes, where they are at p_time, to find
+// the earliest time that their projections would all overlap, while moving
+// along p_linear_velocity. With only straight edges this is the time of
+// impact (apart from rounding), and with curves it gets closer to it the
+// closer p_time is. Returns p_hi if they wouldn't overlap before then.
+static fixed sg_estimate_time_of_impact(const SGShape2DInternal &p_shape, const SGShape2DInternal &p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi) {
+	fixed enter = fixed::ZERO;
+	fixed exit = p_hi;
+	for (const SGFixedVector2Internal &axis : p_shape.get_global_axes()) {
+		if (!sg_sweep_on_axis(p_shape, p_other, axis, p_linear_velocity, p_time, enter, exit)) {
+			return p_hi;
+		}
+	}
+	for (const SGFixedVector2Internal &axis : p_other.get_global_axes()) {
+		if (!sg_sweep_on_axis(p_shape, p_other, axis, p_linear_velocity, p_time, enter, exit)) {
+			return p_hi;
+		}
+	}
+	if (sg_is_curved_shape(p_shape) && !sg_sweep_on_closest_point_axes(p_shape, p_other, p_linear_velocity, p_time, enter, exit)) {
+		return p_hi;
+	}
+	if (sg_is_curved_shape(p_other)) {
+		// Sweeping p_shape against p_other backwards gives the same times.
+		if (!sg_sweep_on_closest_point_axes(p_other, p_shape, -p_linear_velocity, p_time, enter, exit)) {
+			return p_hi;
+		}
+	}
+	return enter;
+}
+
+static fixed sg_estimate_time_of_impact_with_parts(const SGShape2DInternal &p_shape, const SGShape2DInternal &p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi);
+
+// Estimates against the convex parts of a concave polygon that the other
+// shape could reach (or that could reach it) before p_hi.
+class SGConcavePartTimeOfImpactResultHandler : public SGResultHandlerInternal {
+private:
+
+	const SGShape2DInternal &other;
+	bool concave_first;
+	const SGFixedVector2Internal &linear_velocity;
+	fixed time;
+	fixed hi;
+	fixed estimate;
+
+public:
+
+	void handle_result(SGCollisionObject2DInternal *p_object, SGShape2DInternal *p_part) {
+		fixed part_estimate = concave_first
+			? sg_estimate_time_of_impact_with_parts(*p_part, other, linear_velocity, time, hi)
+			: sg_estimate_time_of_impact_with_parts(other, *p_part, linear_velocity, time, hi);
+		estimate = MIN(estimate, part_estimate);
+	}
+
+	_FORCE_INLINE_ fixed get_estimate() const { return estimate; }
+
+	_FORCE_INLINE_ SGConcavePartTimeOfImpactResultHandler(const SGShape2DInternal &p_other, bool p_concave_first, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi)
+		: other(p_other), concave_first(p_concave_first), linear_velocity(p_linear_velocity), time(p_time), hi(p_hi), estimate(p_hi) { }
+};
+
+// Estimates against the solid cells of a grid that the other shape could
+// reach (or that could reach it) before p_hi. One-way cells only count when
+// the other shape is moving down towards them.
+static fixed sg_estimate_time_of_impact_with_cells(const SGGrid2DInternal &p_grid, const SGShape2DInternal &p_other, bool p_grid_first, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi) {
+	SGFixedVector2Internal motion = p_linear_velocity * (p_hi - p_time);
+	SGFixedRect2Internal sweep_bounds = p_other.get_bounds();
+	SGFixedRect2Internal end_bounds = sweep_bounds;
+	end_bounds.position += p_grid_first ? -motion : motion;
+	sweep_bounds = sweep_bounds.merge(end_bounds);
+
+	int min_x, min_y, max_x, max_y;
+	if (!p_grid.get_cell_range(sweep_bounds, min_x, min_y, max_x, max_y)) {
+		return p_hi;
+	}
+
+	SGFixedVector2Internal up = p_grid.get_global_transform().basis_xform(SGFixedVector2Internal(fixed::ZERO, fixed::NEG_ONE));
+	bool falling = (p_grid_first ? -p_linear_velocity : p_linear_velocity).dot(up) < fixed::ZERO;
+	SGRectangle2DInternal &cell = sg_get_grid_cell_shape(p_grid);
+
+	fixed estimate = p_hi;
+	for (int y = min_y; y <= max_y; y++) {
+		for (int x = min_x; x <= max_x; x++) {
+			SGGrid2DInternal::CellType type = p_grid.get_cell(x, y);
+			if (type == SGGrid2DInternal::CELL_EMPTY || (type == SGGrid2DInternal::CELL_ONE_WAY && !falling)) {
+				continue;
+			}
+			cell.set_transform(p_grid.get_cell_transform(x, y));
+			fixed cell_estimate = p_grid_first
+				? sg_estimate_time_of_impact_with_parts(cell, p_other, p_linear_velocity, p_time, p_hi)
+				: sg_estimate_time_of_impact_with_parts(p_other, cell, p_linear_velocity, p_time, p_hi);
+			estimate = MIN(estimate, cell_estimate);
+		}
+	}
+	return estimate;
+}
+
+static fixed sg_estimate_time_of_impact_with_parts(const SGShape2DInternal &p_shape, const SGShape2DInternal &p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi) {
+	if (sg_is_grid_shape(&p_shape) || sg_is_grid_shape(&p_other)) {
+		if (sg_is_grid_shape(&p_shape) && sg_is_grid_shape(&p_other)) {
+			return p_hi;
+		}
+		bool grid_first = sg_is_grid_shape(&p_shape);
+		return sg_estimate_time_of_impact_with_cells(static_cast<const SGGrid2DInternal &>(grid_first ? p_shape : p_other), grid_first ? p_other : p_shape, grid_first, p_linear_velocity, p_time, p_hi);
+	}
+
+	if (!sg_is_concave_shape(&p_shape) && !sg_is_concave_shape(&p_other)) {
+		return sg_estimate_time_of_impact(p_shape, p_other, p_linear_velocity, p_time, p_hi);
+	}
+
+	// Sweep the bounds of the other shape over the rest of the motion
+	// (backwards, if it's the one standing still).
+	bool concave_first = sg_is_concave_shape(&p_shape);
+	const SGShape2DInternal &other = concave_first ? p_other : p_shape;
+	SGFixedVector2Internal motion = p_linear_velocity * (p_hi - p_time);
+	SGFixedRect2Internal sweep_bounds = other.get_bounds();
+	SGFixedRect2Internal end_bounds = sweep_bounds;
+	end_bounds.position += concave_first ? -motion : motion;
+	sweep_bounds = sweep_bounds.merge(end_bounds);
+
+	SGConcavePartTimeOfImpactResultHandler result_handler(other, concave_first, p_linear_velocity, p_time, p_hi);
+	static_cast<const SGPolygon2DInternal &>(concave_first ? p_shape : p_other).find_parts(sweep_bounds, &result_handler);
+	return result_handler.get_estimate();
+}
+
+fixed SGWorld2DInternal::_estimate_time_of_impact(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi) const {
+	fixed estimate = p_hi;
+	for (const SGShape2DInternal *shape : p_body->get_shapes()) {
+		for (const SGShape2DInternal *other_shape : p_other->get_shapes()) {
+			estimate = MIN(estimate, sg_estimate_time_of_impact_with_parts(*shape, *other_shape, p_linear_velocity, p_time, p_hi));
+		}
+	}
+	return estimate;
+}
+
+fixed SGWorld2DInternal::_find_time_of_impact(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedTransform2DInternal &p_from, const SGFixedVector2Internal &p_linear_velocity, fixed p_hi) const {
+	// The body doesn't overlap anything at the start, and overlaps p_other at
+	// p_hi. Narrow that down to the first step of time where they overlap.
+	fixed low = fixed::ZERO;
+	fixed hi = p_hi;
+
+	// Advance using the estimated time of impact, checking it against the
+	// real overlap test each time. When it's right this only takes a couple
+	// of tests, and when it's not we still have a safe 'low' and an
+	// overlapping 'hi' to search between.
+	p_body->_set_transform_silently(p_from);
+	fixed estimate = _estimate_time_of_impact(p_body, p_other, p_linear_velocity, low, hi);
+	bool stalled = false;
+	for (int i = 0; i < 8; i++) {
+		fixed cur = fixed(estimate.value - 1);
+		if (cur <= low) {
+			stalled = true;
+			break;
+		}
+		if (cur >= hi) {
+			break;
+		}
+		if (_overlaps_at(p_body, p_other, p_from, p_linear_velocity, cur)) {
+			hi = cur;
+		}
+		else {
+			low = cur;
+		}
+		estimate = _estimate_time_of_impact(p_body, p_other, p_linear_velocity, cur, hi);
+	}
+
+	// If the estimate stopped just short of the impact (from rounding),
+	// step forward from there with growing steps.
+	if (stalled) {
+		fixed step = fixed(1);
+		while (low.value + step.value < hi.value) {
+			fixed cur = low + step;
+			if (_overlaps_at(p_body, p_other, p_from, p_linear_velocity, cur)) {
+				hi = cur;
+				break;
+			}
+			low = cur;
+			step.value <<= 1;
+		}
+	}
+
+	while (hi.value - low.value > 1) {
+		fixed cur = fixed((low.value + hi.value) >> 1);
+		if (_overlaps_at(p_body, p_other, p_from, p_linear_velocity, cur)) {
+			hi = cur;
+		}
+		else {
+			low = cur;
+		}
+	}
+	return hi;
+}
+
 bool SGWorld2DInternal::move_and_collide(SGBody2DInternal *p_body, const SGFixedVector2Internal &p_linear_velocity, SGWorld2DInternal::BodyCollisionInfo *p_collision) const {
 	BodyOverlapInfo overlap_info;
 
@@ -306,46 +1348,69 @@ bool SGWorld2DInternal::move_and_collide(SGBody2DInternal *p_body, const SGFixed
 		return true;
 	}
 
-	// Move the body the full amount.
+	// Find everything we could touch along the way with a single query.
 	SGFixedTransform2DInternal original_transform = p_body->get_transform();
 	SGFixedTransform2DInternal test_transform = original_transform;
-	SGFixedVector2Internal destination = original_transform.get_origin() + p_linear_velocity;
-	test_transform.set_origin(destination);
-	p_body->set_transform(test_transform);
-
-	// Check if we're colliding. If not, we're done here!
-	if (!get_best_overlapping_body(p_body, false, &overlap_info)) {
-		return false;
+	SGFixedRect2Internal sweep_bounds = p_body->get_bounds();
+	test_transform.set_origin(original_transform.get_origin() + p_linear_velocity);
+	p_body->_set_transform_silently(test_transform);
+	sweep_bounds = sweep_bounds.merge(p_body->get_bounds());
+
+	std::vector<SGCollisionObject2DInternal *> &candidates = move_candidates_scratch;
+	candidates.clear();
+	SGSweepCandidatesResultHandler candidates_handler(p_body, candidates);
+	_find_nearby(sweep_bounds, &candidates_handler, SGCollisionObject2DInternal::OBJECT_BODY, p_body->get_collision_layer(), p_body->get_collision_mask());
+
+	// The order from the broadphase depends on its history, so put them in a
+	// stable order, in case that would change the result.
+	if (compare_callback) {
+		std::sort(candidates.begin(), candidates.end(), SGCollisionObjectCompare{ compare_callback });
 	}
 
-	// Use binary search to find the point at which we collide, and the point just before that.
-	fixed low = fixed::ZERO;
+	// Find the earliest time that we hit something that we'd be overlapping
+	// at the destination (anything that we'd pass all the way through isn't
+	// considered).
 	fixed hi = fixed::ONE;
-	SGFixedVector2Internal last_safe_position = original_transform.get_origin();
-	for (int i = 0; i < 8; i++) {
-		fixed cur = (low + hi) * fixed::HALF;
-		SGFixedVector2Internal test_position = original_transform.get_origin() + (p_linear_velocity * cur);
-		test_transform.set_origin(test_position);
-		p_body->set_transform(test_transform);
-		if (get_best_overlapping_body(p_body, false, &overlap_info)) {
-			hi = cur;
-		}
-		else {
-			low = cur;
-			last_safe_position = test_transform.get_origin();
+	bool collided = false;
+	for (SGCollisionObject2DInternal *candidate : candidates) {
+		if (_overlaps_at(p_body, candidate, original_transform, p_linear_velocity, hi)) {
+			hi = _find_time_of_impact(p_body, candidate, original_transform, p_linear_velocity, hi);
+			collided = true;
 		}
 	}
 
-	// Whatever was last set to our fixed position will be a safe position, so
-	// let's make sure that's what ends up in the transform (in case the
-	// last test_transform was a 'hi' position).
-	if (test_transform.get_origin() != last_safe_position) {
-		test_transform.set_origin(last_safe_position);
+	if (!collided) {
+		test_transform.set_origin(original_transform.get_origin() + p_linear_velocity);
 		p_body->set_transform(test_transform);
+		return false;
+	}
+
+	// Make sure we aren't overlapping anything just before the impact, which
+	// can happen if we'd pass through the edge of something on the way.
+	fixed low = fixed(hi.value - 1);
+	bool safe = false;
+	while (!safe) {
+		safe = true;
+		for (SGCollisionObject2DInternal *candidate : candidates) {
+			if (low > fixed::ZERO && _overlaps_at(p_body, candidate, original_transform, p_linear_velocity, low)) {
+				hi = _find_time_of_impact(p_body, candidate, original_transform, p_linear_velocity, low);
+				low = fixed(hi.value - 1);
+				safe = false;
+			}
+		}
 	}
 
-	// At this point, the overlap_info will contain info about the collision at 'hi'
-	// which is what we want to store in p_collision.
+	// Get the info about the collision at the point of impact.
+	test_transform.set_origin(original_transform.get_origin() + (p_linear_velocity * hi));
+	p_body->_set_transform_silently(test_transform);
+	SGBestOverlappingResultHandler best_handler(this, p_body, fixed::ZERO, &overlap_info, compare_callback);
+	for (SGCollisionObject2DInternal *candidate : candidates) {
+		best_handler.handle_result(candidate, nullptr);
+	}
+
+	test_transform.set_origin(original_transform.get_origin() + (p_linear_velocity * low));
+	p_body->set_transform(test_transform);
+
 	if (p_collision) {
 		p_collision->collider = overlap_info.collider;
 		p_collision->normal = overlap_info.collision_normal;
@@ -355,6 +1420,66 @@ bool SGWorld2DInternal::move_and_collide(SGBody2DInternal *p_body, const SGFixed
 	return true;
 }
 
+bool SGWorld2DInternal::move_and_slide(SGBody2DInternal *p_body, const SGFixedVector2Internal &p_velocity, const SGFixedVector2Internal &p_up_direction, int p_max_slides, fixed p_floor_max_angle, SGWorld2DInternal::BodySlideInfo *p_info, std::vector<SGWorld2DInternal::BodyCollisionInfo> *p_collisions) const {
+	SGFixedVector2Internal motion = p_velocity;
+	SGFixedVector2Internal body_velocity = p_velocity;
+	BodySlideInfo info;
+
+	bool collided = false;
+	int remaining_slides = p_max_slides;
+	while (remaining_slides) {
+		BodyCollisionInfo collision;
+		if (!move_and_collide(p_body, motion, &collision)) {
+			// No collision, so we're good - bail!
+			break;
+		}
+		collided = true;
+
+		if (collision.normal == SGFixedVector2Internal::ZERO) {
+			// This means we couldn't unstuck the body. Clear out the motion
+			// vector and bail.
+			body_velocity = SGFixedVector2Internal::ZERO;
+			break;
+		}
+
+		if (p_collisions) {
+			p_collisions->push_back(collision);
+		}
+
+		if (p_up_direction == SGFixedVector2Internal::ZERO) {
+			// All is wall!
+			info.on_wall = true;
+		}
+		else {
+			if (collision.normal.dot(p_up_direction).acos() <= p_floor_max_angle) {
+				info.on_floor = true;
+				info.floor_normal = collision.normal;
+			} else if (collision.normal.dot(-p_up_direction).acos() <= p_floor_max_angle) {
+				info.on_ceiling = true;
+			} else {
+				info.on_wall = true;
+			}
+		}
+
+		motion = collision.remainder.slide(collision.normal);
+		body_velocity = body_velocity.slide(collision.normal);
+
+		if (motion == SGFixedVector2Internal::ZERO) {
+			// No remaining motion, so we're good - bail!
+			break;
+		}
+
+		remaining_slides--;
+	}
+
+	if (p_info) {
+		info.velocity = body_velocity;
+		*p_info = info;
+	}
+
+	return collided;
+}
+
 bool SGWorld2DInternal::segment_intersects_shape(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGShape2DInternal *p_shape, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal) const {
 	using ShapeType = SGShape2DInternal::ShapeType;
 
@@ -370,19 +1495,25 @@ bool SGWorld2DInternal::segment_intersects_shape(const SGFixedVector2Internal &p
 
 		case ShapeType::SHAPE_CAPSULE:
 			return SGCollisionDetector2DInternal::segment_intersects_Capsule(p_start, p_cast_to, *(SGCapsule2DInternal*)p_shape, p_intersection_point, p_collision_normal);
+
+		case ShapeType::SHAPE_GRID:
+			return SGCollisionDetector2DInternal::segment_intersects_Grid(p_start, p_cast_to, *(SGGrid2DInternal *)p_shape, p_intersection_point, p_collision_normal);
+
+		case ShapeType::SHAPE_MAX:
+			break;
 	}
 
 	return false;
 }
 
-class SGRayCastResultHandler : public SGResultHandlerInternal {
+class SGRayCastResultHandler : public SGRayResultHandlerInternal {
 private:
 
 	const SGWorld2DInternal *world;
 	const SGFixedVector2Internal &start;
 	const SGFixedVector2Internal &cast_to;
-	uint32_t collision_mask;
 	std::unordered_set<SGCollisionObject2DInternal *> *exceptions;
+	SGWorld2DInternal::CompareCallback compare;
 
 	bool intersects;
 	SGCollisionObject2DInternal *collider;
@@ -399,16 +1530,15 @@ public:
 			return;
 		}
 
-		if (!(p_object->get_collision_layer() & collision_mask)) {
-			return;
-		}
-
 		for (SGShape2DInternal *shape : p_object->get_shapes()) {
 			if (world->segment_intersects_shape(start, cast_to, shape, intersection_point, collision_normal)) {
 				intersects = true;
 
+				// The broadphase may find objects in any order, so use the
+				// compare callback to decide between equally close ones.
 				fixed distance = (intersection_point - start).length();
-				if (collider == nullptr || distance < shortest_distance) {
+				if (collider == nullptr || distance < shortest_distance ||
+						(distance == shortest_distance && compare != nullptr && p_object != collider && compare(p_object, collider))) {
 					shortest_distance = distance;
 					collider = p_object;
 					closest_intersection_point = intersection_point;
@@ -418,6 +1548,14 @@ public:
 		}
 	}
 
+	bool get_closest_hit(SGFixedVector2Internal &r_point) const {
+		if (collider) {
+			r_point = closest_intersection_point;
+			return true;
+		}
+		return false;
+	}
+
 	_FORCE_INLINE_ void populate_info(SGWorld2DInternal::RayCastInfo *p_info) {
 		if (collider) {
 			p_info->body = (SGBody2DInternal *)collider;
@@ -430,20 +1568,14 @@ public:
 		return intersects;
 	}
 
-	_FORCE_INLINE_ SGRayCastResultHandler(const SGWorld2DInternal *p_world, const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, uint32_t p_collision_mask, std::unordered_set<SGCollisionObject2DInternal *> *p_exceptions)
-		: world(p_world), start(p_start), cast_to(p_cast_to), collision_mask(p_collision_mask), exceptions(p_exceptions), intersects(false), collider(nullptr) {
-		SGFixedRect2Internal bounds(p_start, SGFixedVector2Internal());
-		bounds.expand_to(p_start + p_cast_to);
-	}
+	_FORCE_INLINE_ SGRayCastResultHandler(const SGWorld2DInternal *p_world, const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, std::unordered_set<SGCollisionObject2DInternal *> *p_exceptions, SGWorld2DInternal::CompareCallback p_compare)
+		: world(p_world), start(p_start), cast_to(p_cast_to), exceptions(p_exceptions), compare(p_compare), intersects(false), collider(nullptr) { }
 
 };
 
 bool SGWorld2DInternal::cast_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, uint32_t p_collision_mask, std::unordered_set<SGCollisionObject2DInternal *> *p_exceptions,
 		bool collide_with_areas, bool collide_with_bodies, SGWorld2DInternal::RayCastInfo *p_info) const {
-	SGRayCastResultHandler result_handler(this, p_start, p_cast_to, p_collision_mask, p_exceptions);
-
-	SGFixedRect2Internal bounds(p_start, SGFixedVector2Internal());
-	bounds.expand_to(p_start + p_cast_to);
+	SGRayCastResultHandler result_handler(this, p_start, p_cast_to, p_exceptions, compare_callback);
 
 	int collide_with = 0;
 	if (collide_with_areas) {
@@ -452,18 +1584,28 @@ bool SGWorld2DInternal::cast_ray(const SGFixedVector2Internal &p_start, const SG
 	if (collide_with_bodies) {
 		collide_with |= SGCollisionObject2DInternal::OBJECT_BODY;
 	}
-	broadphase->find_nearby(bounds, &result_handler, collide_with);
+	// Rays have no layer of their own, so only the mask matters.
+	if (collide_with & SGCollisionObject2DInternal::OBJECT_BODY) {
+		static_broadphase->find_along_ray(p_start, p_cast_to, &result_handler, collide_with, 0, p_collision_mask);
+	}
+	broadphase->find_along_ray(p_start, p_cast_to, &result_handler, collide_with, 0, p_collision_mask);
 	if (p_info) {
 		result_handler.populate_info(p_info);
 	}
 	return result_handler.is_intersecting();
 }
 
-SGWorld2DInternal::SGWorld2DInternal(unsigned int p_broadphase_cell_size, CompareCallback p_compare_callback) {
-	broadphase = new SGBroadphase2DInternal(p_broadphase_cell_size);
+SGWorld2DInternal::SGWorld2DInternal(unsigned int p_broadphase_cell_size, CompareCallback p_compare_callback, SGBroadphase2DInternal::BroadphaseType p_broadphase_type) {
+	broadphase = SGBroadphase2DInternal::create(p_broadphase_type, p_broadphase_cell_size);
+	static_broadphase = new SGStaticBroadphase2DInternal();
 	compare_callback = p_compare_callback;
+	narrowphase_type = NARROWPHASE_SAT;
+	overlap_events_enabled = false;
+	concurrent_queries_prepared = false;
+	state_hash = 0;
 }
 
 SGWorld2DInternal::~SGWorld2DInternal() {
 	delete broadphase;
+	delete static_broadphase;
 }
@@ -30,23 +30,91 @@
 #include "sg_fixed_vector2_internal.h"
 #include "sg_fixed_rect2_internal.h"
 #include "sg_result_handler_internal.h"
-
-class SGArea2DInternal;
-class SGBody2DInternal;
-class SGCollisionObject2DInternal;
-class SGShape2DInternal;
-class SGBroadphase2DInternal;
+#include "sg_broadphase_2d_internal.h"
+#include "sg_static_broadphase_2d_internal.h"
+#include "sg_bodies_2d_internal.h"
 
 class SGWorld2DInternal {
 public:
 	typedef bool (* CompareCallback)(const SGCollisionObject2DInternal*, const SGCollisionObject2DInternal*);
 
+	enum NarrowphaseType {
+		NARROWPHASE_SAT,
+		NARROWPHASE_GJK,
+	};
+
 protected:
 
 	std::vector<SGArea2DInternal *> areas;
 	std::vector<SGBody2DInternal *> bodies;
 	SGBroadphase2DInternal *broadphase;
+	// Static bodies are kept apart from everything else, in a partition
+	// that's cheap to query but expensive to change.
+	SGStaticBroadphase2DInternal *static_broadphase;
 	CompareCallback compare_callback;
+	NarrowphaseType narrowphase_type;
+
+public:
+	struct OverlapEvent {
+		SGArea2DInternal *area;
+		SGCollisionObject2DInternal *object;
+		bool begin;
+
+		_FORCE_INLINE_ OverlapEvent(SGArea2DInternal *p_area, SGCollisionObject2DInternal *p_object, bool p_begin)
+			: area(p_area), object(p_object), begin(p_begin) { }
+	};
+
+protected:
+	// Areas whose overlaps are cached, and objects that have changed since
+	// the cache was last updated (in the order they changed).
+	std::vector<SGArea2DInternal *> tracked_areas;
+	std::vector<SGCollisionObject2DInternal *> overlaps_dirty_objects;
+	std::vector<OverlapEvent> overlap_events;
+	bool overlap_events_enabled;
+	// Set by prepare_for_concurrent_queries(), and cleared by anything that
+	// changes the overlaps. While it's set, the cached queries don't start
+	// tracking new areas.
+	bool concurrent_queries_prepared;
+
+	std::vector<SGArea2DInternal *> unindexed_areas_scratch;
+	std::vector<SGArea2DInternal::CachedOverlap> overlaps_scratch;
+	std::vector<SGFixedTransform2DInternal> shape_transforms_scratch;
+	// Reused by move_and_collide(), which already can't run concurrently,
+	// since it moves the body.
+	mutable std::vector<SGCollisionObject2DInternal *> move_candidates_scratch;
+
+	// The sum of every object's hash, so that it doesn't depend on the order
+	// of the objects, and changing one only means swapping its hash out.
+	uint64_t state_hash;
+	std::vector<SGCollisionObject2DInternal *> state_hash_dirty_objects;
+
+	void _remove_from_state_hash(SGCollisionObject2DInternal *p_object);
+
+	_FORCE_INLINE_ SGBroadphase2DInternal *_get_broadphase_for(SGCollisionObject2DInternal *p_object) const {
+		if (p_object->get_object_type() == SGCollisionObject2DInternal::OBJECT_BODY && ((SGBody2DInternal *)p_object)->get_body_type() == SGBody2DInternal::BODY_STATIC) {
+			return static_broadphase;
+		}
+		return broadphase;
+	}
+
+	// Searches the static partition, and then the other one.
+	void _find_nearby(const SGFixedRect2Internal &p_bounds, SGResultHandlerInternal *p_result_handler, int p_type, uint32_t p_collision_layer, uint32_t p_collision_mask) const;
+
+	void _track_overlaps(SGArea2DInternal *p_area);
+	void _remove_from_overlaps(SGCollisionObject2DInternal *p_object);
+	void _update_object_overlaps(SGCollisionObject2DInternal *p_object);
+	void _update_area_overlaps(SGArea2DInternal *p_area);
+	bool _overlaps_at(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedTransform2DInternal &p_from, const SGFixedVector2Internal &p_linear_velocity, fixed p_time) const;
+	fixed _estimate_time_of_impact(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedVector2Internal &p_linear_velocity, fixed p_time, fixed p_hi) const;
+	fixed _find_time_of_impact(SGBody2DInternal *p_body, SGCollisionObject2DInternal *p_other, const SGFixedTransform2DInternal &p_from, const SGFixedVector2Internal &p_linear_velocity, fixed p_hi) const;
+
+	void _save_object_snapshot(std::vector<int64_t> &r_snapshot, const SGCollisionObject2DInternal *p_object) const;
+
+	_FORCE_INLINE_ void _push_overlap_event(SGArea2DInternal *p_area, SGCollisionObject2DInternal *p_object, bool p_begin) {
+		if (overlap_events_enabled) {
+			overlap_events.push_back(OverlapEvent(p_area, p_object, p_begin));
+		}
+	}
 
 public:
 	struct ShapeOverlapInfo {
@@ -84,6 +152,20 @@ public:
 		}
 	};
 
+	struct BodySlideInfo {
+		SGFixedVector2Internal velocity;
+		SGFixedVector2Internal floor_normal;
+		bool on_floor;
+		bool on_ceiling;
+		bool on_wall;
+
+		BodySlideInfo() {
+			on_floor = false;
+			on_ceiling = false;
+			on_wall = false;
+		}
+	};
+
 	struct RayCastInfo {
 		SGBody2DInternal *body;
 		SGFixedVector2Internal collision_point;
@@ -98,6 +180,33 @@ public:
 	_FORCE_INLINE_ const std::vector<SGArea2DInternal *> &get_areas() const { return areas; }
 	_FORCE_INLINE_ const SGBroadphase2DInternal *get_broadphase() const { return broadphase; }
 
+	_FORCE_INLINE_ const SGStaticBroadphase2DInternal *get_static_broadphase() const { return static_broadphase; }
+
+	_FORCE_INLINE_ void set_broadphase_margin(fixed p_margin) { broadphase->set_margin(p_margin); }
+	_FORCE_INLINE_ fixed get_broadphase_margin() const { return broadphase->get_margin(); }
+
+	// Only meaningful for the spatial hash broadphase, which gives 0 as its
+	// cell size otherwise. Changing it rebuilds the broadphase.
+	_FORCE_INLINE_ void set_broadphase_cell_size(int p_cell_size) { broadphase->set_cell_size(p_cell_size); }
+	_FORCE_INLINE_ int get_broadphase_cell_size() const { return broadphase->get_cell_size(); }
+
+	// Switches the spatial hash broadphase to the cell size that suits the
+	// objects in the world best, if it's clearly better than the current
+	// one, and returns the cell size used from now on. The choice only
+	// depends on the state of the world, but the order of query results
+	// depends on the cell size, so every peer needs to do this at the same
+	// point in the simulation. The cell size is part of the state hash and
+	// snapshots, so a peer that tunes at a different point shows up as a
+	// desync, and rolling back restores the cell size from before tuning.
+	int tune_broadphase_cell_size();
+	void reset_broadphase_statistics();
+
+	// SAT (the default) tests a fixed set of axes for each pair of shape
+	// types. GJK costs less for shapes with many vertices, but the results
+	// can differ slightly, so all peers need to use the same one.
+	void set_narrowphase_type(NarrowphaseType p_narrowphase_type);
+	_FORCE_INLINE_ NarrowphaseType get_narrowphase_type() const { return narrowphase_type; }
+
 	void add_area(SGArea2DInternal *p_area);
 	void remove_area(SGArea2DInternal *p_area);
 	void add_body(SGBody2DInternal *p_body);
@@ -109,15 +218,59 @@ public:
 	void get_overlapping_areas(SGCollisionObject2DInternal *p_object, SGResultHandlerInternal *p_result_handler) const;
 	void get_overlapping_bodies(SGCollisionObject2DInternal *p_object, SGResultHandlerInternal *p_result_handler) const;
 
+	// Queries (get_overlapping_areas(), get_overlapping_bodies(),
+	// get_best_overlapping_body() and cast_ray()) don't change the world,
+	// except for the global transforms, vertices and axes that shapes compute
+	// lazily, and the static partition of the broadphase, which is rebuilt
+	// lazily too. After calling this, any number of queries can run at the same
+	// time from different threads, until something in the world is changed.
+	// This includes get_cached_overlapping_areas() and
+	// get_cached_overlapping_bodies(), since the cache is brought up to date
+	// here, and areas that aren't tracked yet are queried without it.
+	void prepare_for_concurrent_queries();
+
+	// These give the same results as get_overlapping_areas() and
+	// get_overlapping_bodies(), but from a persistent cache which is only
+	// updated for objects that have changed since it was last used.
+	void get_cached_overlapping_areas(SGArea2DInternal *p_area, SGResultHandlerInternal *p_result_handler);
+	void get_cached_overlapping_bodies(SGArea2DInternal *p_area, SGResultHandlerInternal *p_result_handler);
+
+	void mark_overlaps_dirty(SGCollisionObject2DInternal *p_object);
+	void update_overlaps();
+
+	// Moves the begin and end overlap events for all cached areas since the
+	// last call into r_events. Events are only recorded once this has been
+	// called for the first time. Objects removed from the world are dropped
+	// from the cache (and any pending events) without an end event.
+	void take_overlap_events(std::vector<OverlapEvent> &r_events);
+
+	// A hash of the transforms, shapes and collision layers and masks of all
+	// the objects in the world, and the broadphase's cell size, for detecting
+	// desyncs between peers. Only the objects that have changed since the
+	// last call are re-hashed.
+	void mark_state_hash_dirty(SGCollisionObject2DInternal *p_object);
+	uint64_t get_state_hash();
+
+	// Saves the transforms of every object and its shapes, along with their
+	// collision layers and masks, and the broadphase's cell size, into a
+	// flat buffer. Loading it puts them all back and rebuilds the broadphase
+	// once, instead of updating it for each object. The world must contain the same objects (with the same
+	// number of shapes, added in the same order) as when it was saved.
+	void save_snapshot(std::vector<int64_t> &r_snapshot) const;
+	bool load_snapshot(const int64_t *p_snapshot, std::size_t p_size);
+
 	bool get_best_overlapping_body(SGBody2DInternal *p_body, bool p_use_safe_margin, BodyOverlapInfo *p_info) const;
 	bool unstuck_body(SGBody2DInternal *p_body, int p_max_attempts, BodyOverlapInfo *p_info = nullptr) const;
 	bool move_and_collide(SGBody2DInternal *p_body, const SGFixedVector2Internal &p_linear_velocity, BodyCollisionInfo *p_collision = nullptr) const;
+	// Used by SGCharacterBody2D::move_and_slide() and friends. If p_collisions
+	// is given, the collision from each slide is appended to it.
+	bool move_and_slide(SGBody2DInternal *p_body, const SGFixedVector2Internal &p_velocity, const SGFixedVector2Internal &p_up_direction, int p_max_slides, fixed p_floor_max_angle, BodySlideInfo *p_info = nullptr, std::vector<BodyCollisionInfo> *p_collisions = nullptr) const;
 
 	bool segment_intersects_shape(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, SGShape2DInternal *p_shape, SGFixedVector2Internal &p_intersection_point, SGFixedVector2Internal &p_collision_normal) const;
 	bool cast_ray(const SGFixedVector2Internal &p_start, const SGFixedVector2Internal &p_cast_to, uint32_t p_collision_mask, std::unordered_set<SGCollisionObject2DInternal *> *p_exceptions = nullptr,
 		bool collide_with_areas=false, bool collide_with_bodies=true, RayCastInfo *p_info = nullptr) const;
 
-	SGWorld2DInternal(unsigned int p_broadphase_cell_size, CompareCallback p_compare_callback = nullptr);
+	SGWorld2DInternal(unsigned int p_broadphase_cell_size, CompareCallback p_compare_callback = nullptr, SGBroadphase2DInternal::BroadphaseType p_broadphase_type = SGBroadphase2DInternal::BROADPHASE_SPATIAL_HASH);
 	~SGWorld2DInternal();
 };
 
@@ -43,6 +43,7 @@
 #include "./godot-3/scene/2d/sg_ray_cast_2d.h"
 #include "./godot-3/scene/2d/sg_collision_shape_2d.h"
 #include "./godot-3/scene/2d/sg_collision_polygon_2d.h"
+#include "./godot-3/scene/2d/sg_collision_grid_2d.h"
 #include "./godot-3/scene/2d/sg_ysort.h"
 #include "./godot-3/scene/resources/sg_shapes_2d.h"
 #include "./godot-3/scene/resources/sg_curve_2d.h"
@@ -73,6 +74,7 @@ void register_sg_physics_2d_types() {
 	ClassDB::register_virtual_class<SGCollisionObject2D>();
 	ClassDB::register_class<SGArea2D>();
 	ClassDB::register_class<SGAreaCollision2D>();
+	ClassDB::register_class<SGAreaOverlapEvent2D>();
 	ClassDB::register_class<SGStaticBody2D>();
 	ClassDB::register_class<SGKinematicBody2D>();
 	ClassDB::register_class<SGKinematicCollision2D>();
@@ -81,6 +83,7 @@ void register_sg_physics_2d_types() {
 
 	ClassDB::register_class<SGCollisionShape2D>();
 	ClassDB::register_class<SGCollisionPolygon2D>();
+	ClassDB::register_class<SGCollisionGrid2D>();
 
 	ClassDB::register_virtual_class<SGShape2D>();
 	ClassDB::register_class<SGRectangleShape2D>();